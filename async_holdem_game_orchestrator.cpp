@@ -0,0 +1,437 @@
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <iomanip>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "async_holdem_game_orchestrator.h"
+#include "event_tracing.h"
+
+namespace poker_lib {
+
+async_holdem_game_orchestrator::async_holdem_game_orchestrator(i_my_poker_lib& poker_lib,
+                                                               i_async_user_interaction &user_interaction,
+                                                               i_table_state_manager &table_state_manager,
+                                                               const size_t user_pos,
+                                                               i_analysis_executor *analysis_executor)
+:
+    _poker_lib(poker_lib),
+    _user_interaction(user_interaction),
+    _table_state_manager(table_state_manager),
+    _user_pos(user_pos),
+    _analysis_executor(analysis_executor)
+{
+}
+
+void async_holdem_game_orchestrator::start_game(std::function<void()> on_game_ended)
+{
+    if (_has_started)
+    {
+        throw std::logic_error("The game has already been started");
+    }
+
+    _has_started = true;
+    _on_game_ended = std::move(on_game_ended);
+    resume();
+}
+
+void async_holdem_game_orchestrator::resume()
+{
+    _is_runnable = true;
+    if (_is_running)
+    {
+        return;
+    }
+
+    _is_running = true;
+    try
+    {
+        while (_is_runnable && !_has_ended)
+        {
+            _is_runnable = false;
+            run_stage();
+        }
+    }
+    catch (...)
+    {
+        _is_running = false;
+        throw;
+    }
+    _is_running = false;
+
+    // Called last as the callback may destroy the orchestrator
+    if (_has_ended && _on_game_ended)
+    {
+        const auto on_game_ended = std::move(_on_game_ended);
+        _on_game_ended = nullptr;
+        on_game_ended();
+    }
+}
+
+void async_holdem_game_orchestrator::repeat_stage()
+{
+    resume();
+}
+
+void async_holdem_game_orchestrator::finish_stage()
+{
+    _has_read_dead_cards = false;
+    _user_interaction.notify_player("\n\n\n\n\n\n");
+    resume();
+}
+
+void async_holdem_game_orchestrator::read_valid_cards(const cards_request &request, const size_t expected_num_of_cards,
+                                                      std::function<void(const std::string&)> on_valid_cards)
+{
+    const async_trace_span io_span("io", "read_cards");
+    request([this, io_span, expected_num_of_cards, on_valid_cards = std::move(on_valid_cards)](const std::string &cards)
+    {
+        io_span.finish();
+
+        // The timer only covers parsing, not telling the player about invalid cards
+        const char *error = nullptr;
+        {
+            const scoped_latency_timer parsing_timer(&_poker_lib.get_performance_stats(), pipeline_stage::input_parsing);
+            const auto& table = _table_state_manager.get_table_state();
+            auto current_board = table.communal_cards + ' ' + table.dead_cards;
+            for (const auto &player : table.players)
+            {
+                if (player.pocket_cards)
+                {
+                    current_board += ' ' + *player.pocket_cards;
+                }
+            }
+            const auto board_cards_count = _poker_lib.get_num_of_parsed_cards(current_board);
+
+            // Every card has to be parsed
+            auto num_of_cards = expected_num_of_cards;
+            if (num_of_cards == any_num_of_cards)
+            {
+                std::istringstream iss(cards);
+                num_of_cards = static_cast<size_t>(std::distance(std::istream_iterator<std::string>(iss), std::istream_iterator<std::string>()));
+            }
+
+            if (_poker_lib.get_num_of_parsed_cards(cards) != num_of_cards)
+            {
+                error = "Cannot parse card(s), please try again";
+            }
+            else if (_poker_lib.get_num_of_parsed_cards(current_board + ' ' + cards) != (board_cards_count + num_of_cards))
+            {
+                error = "At least one of the cards is already on the board, dead or in known pocket cards";
+            }
+        }
+
+        if (!error)
+        {
+            on_valid_cards(cards);
+        }
+        else
+        {
+            _user_interaction.notify_player(error);
+            repeat_stage();
+        }
+    });
+}
+
+void async_holdem_game_orchestrator::run_stage()
+{
+    const auto stage = _table_state_manager.get_table_state().current_stage;
+    const scoped_trace_span stage_span("game", get_game_stage_name(stage));
+
+    const bool is_card_deal = stage == game_stages::deal_pocket_cards || stage == game_stages::deal_communal_cards ||
+                              stage == game_stages::deal_turn_card || stage == game_stages::deal_river_card;
+    if (is_card_deal && !_has_read_dead_cards)
+    {
+        read_dead_cards();
+        return;
+    }
+
+    switch (stage)
+    {
+    case game_stages::deal_pocket_cards:
+        read_valid_cards([this](i_async_user_interaction::cards_continuation on_cards){ _user_interaction.get_user_pocket_cards(std::move(on_cards)); }, 2,
+                         [this](const std::string &cards){ _table_state_manager.set_pocket_cards(_user_pos, cards); finish_stage(); });
+        break;
+
+    case game_stages::deal_communal_cards:
+        read_valid_cards([this](i_async_user_interaction::cards_continuation on_cards){ _user_interaction.get_flop(std::move(on_cards)); }, 3,
+                         [this](const std::string &cards){ _table_state_manager.set_flop(cards); finish_stage(); });
+        break;
+
+    case game_stages::deal_turn_card:
+        read_valid_cards([this](i_async_user_interaction::cards_continuation on_card){ _user_interaction.get_turn(std::move(on_card)); }, 1,
+                         [this](const std::string &card){ _table_state_manager.set_turn(card); finish_stage(); });
+        break;
+
+    case game_stages::deal_river_card:
+        read_valid_cards([this](i_async_user_interaction::cards_continuation on_card){ _user_interaction.get_river(std::move(on_card)); }, 1,
+                         [this](const std::string &card){ _table_state_manager.set_river(card); finish_stage(); });
+        break;
+
+    case game_stages::pre_flop_betting_round:
+    case game_stages::flop_betting_round:
+    case game_stages::turn_betting_round:
+    case game_stages::river_betting_round:
+        _user_interaction.notify_player(table_state_and_stage_to_user_message());
+        read_acting_player_action();
+        break;
+
+    case game_stages::showdown:
+        execute_showdown();
+        break;
+
+    case game_stages::end_of_round:
+        _poker_lib.record_finished_round(_table_state_manager.get_table_state());
+        if (_table_state_manager.start_new_round())
+        {
+            _user_interaction.notify_player("Round ended and now starting a new one.");
+            finish_stage();
+            break;
+        }
+        _user_interaction.notify_player("Game ended, bye!");
+        _has_ended = true;
+        break;
+    }
+}
+
+void async_holdem_game_orchestrator::read_dead_cards()
+{
+    read_valid_cards([this](i_async_user_interaction::cards_continuation on_cards){ _user_interaction.get_dead_cards(std::move(on_cards)); }, any_num_of_cards,
+                     [this](const std::string &cards)
+                     {
+                         _has_read_dead_cards = true;
+                         if (_poker_lib.get_num_of_parsed_cards(cards) > 0)
+                         {
+                             _table_state_manager.add_dead_cards(cards);
+                         }
+                         repeat_stage();
+                     });
+}
+
+void async_holdem_game_orchestrator::read_acting_player_action()
+{
+    const bool is_opponent = _table_state_manager.get_table_state().acting_player_pos != _user_pos;
+    if (!is_opponent)
+    {
+        read_user_action();
+        return;
+    }
+
+    const async_trace_span io_span("io", "read_opponent_action");
+    _user_interaction.get_opponent_action([this, io_span](const player_action_t &action)
+    {
+        io_span.finish();
+        apply_acting_player_action(action);
+    });
+}
+
+void async_holdem_game_orchestrator::read_user_action()
+{
+    struct analysis_request
+    {
+        table_state table;
+        player_analysis analysis;
+        std::exception_ptr exception;
+    };
+    // The game waits for the analysis so the table doesn't change, it's copied for the worker anyway
+    auto request = std::make_shared<analysis_request>();
+    request->table = _table_state_manager.get_table_state();
+
+    auto work = [this, request]()
+    {
+        try
+        {
+            request->analysis = _poker_lib.make_acting_player_analysis(request->table, 0.75, 1);
+        }
+        catch (...)
+        {
+            request->exception = std::current_exception();
+        }
+    };
+    auto on_finished = [this, request]()
+    {
+        if (request->exception)
+        {
+            std::rethrow_exception(request->exception);
+        }
+        notify_recommendation(request->table, request->analysis);
+
+        const async_trace_span io_span("io", "read_user_action");
+        _user_interaction.get_user_action([this, io_span](const player_action_t &action)
+        {
+            io_span.finish();
+            apply_acting_player_action(action);
+        });
+    };
+
+    if (_analysis_executor)
+    {
+        _analysis_executor->run(std::move(work), std::move(on_finished));
+        return;
+    }
+    work();
+    on_finished();
+}
+
+void async_holdem_game_orchestrator::notify_recommendation(const table_state &table, const player_analysis &analysis)
+{
+    std::ostringstream oss;
+    oss << "Your equity of winning is " << (100 * analysis.equity)
+        << "% and your pot equity is " << (100 * analysis.pot_equity) << "%. Your recommended action is ";
+    std::visit([&](const auto &obj){ oss << obj << std::endl; }, analysis.recommended_action);
+    oss << "You have " << analysis.hand.made_hand;
+    if (analysis.hand.has_flush_draw) { oss << ", a flush draw"; }
+    if (analysis.hand.has_open_ended_straight_draw) { oss << ", an open-ended straight draw"; }
+    if (analysis.hand.has_gutshot) { oss << ", a gutshot"; }
+    if (analysis.hand.num_of_outs) { oss << " and " << analysis.hand.num_of_outs << " outs"; }
+    oss << std::endl;
+    for (size_t pos = 0; pos < analysis.equities_vs_opponents.size(); ++pos)
+    {
+        if (pos != table.acting_player_pos && !table.has_folded(pos))
+        {
+            oss << "Your equity against " << table.players.at(pos).player_name << " alone is "
+                << (100 * analysis.equities_vs_opponents[pos]) << "%" << std::endl;
+        }
+    }
+    for (const auto &action_payout : analysis.action_payouts)
+    {
+        oss << "Expected tournament payout of ";
+        std::visit([&](const auto &obj){ oss << obj; }, action_payout.action);
+        oss << " is " << action_payout.expected_payout << std::endl;
+    }
+    {
+        const scoped_latency_timer output_timer(&_poker_lib.get_performance_stats(), pipeline_stage::output);
+        const scoped_trace_span io_span("io", "notify_recommendation");
+        _user_interaction.notify_player(oss.str());
+    }
+}
+
+void async_holdem_game_orchestrator::apply_acting_player_action(const player_action_t &action)
+{
+    // Actions the manager rejects aren't recorded
+    const auto table = _table_state_manager.get_table_state();
+    _table_state_manager.set_acting_player_action(action);
+    _poker_lib.record_action(table, action);
+    finish_stage();
+}
+
+std::string async_holdem_game_orchestrator::table_state_and_stage_to_user_message() const
+{
+    const auto& table = _table_state_manager.get_table_state();
+
+    std::ostringstream oss;
+    oss << std::left;
+    oss << table.current_stage << ": pot size: " << table.pot;
+    if (!table.communal_cards.empty())
+    {
+        oss << ", communal cards: " << table.communal_cards;
+    }
+    oss << ", big blind size: " << table.big_blind_size;
+
+    constexpr std::array<int, 4> text_width{10, 25, 20, 40};
+    oss << std::endl << std::setw(text_width.at(0)) << "name"
+                     << std::setw(text_width.at(1)) << "attributes"
+                     << std::setw(text_width.at(2)) << "stack size"
+                     << std::setw(text_width.at(3)) << "action";
+    for (size_t pos = 0; pos < table.get_num_of_players(); ++pos)
+    {
+        const auto& player = table.players.at(pos);
+        const auto stack = table.get_stack(pos);
+
+        std::string attributes;
+        if (table.acting_player_pos == pos) { attributes += "*** acting, "; }
+        if (table.dealer_pos == pos) { attributes += "dealer, "; }
+        if (_user_pos == pos) { attributes += "you, "; }
+
+        oss << std::endl
+            << std::setw(text_width.at(0)) << player.player_name
+            << std::setw(text_width.at(1)) << attributes
+            << std::setw(text_width.at(2));
+        if (stack == 0)
+        {
+            oss << "all in";
+        }
+        else
+        {
+            oss << stack;
+        }
+
+        oss << std::setw(text_width.at(3));
+        if (table.has_folded(pos))
+        {
+            oss << "folded";
+        }
+        else if (const auto amount_to_call = table.get_player_amount_to_call(pos); amount_to_call > 0)
+        {
+            oss << ("amount needed to call: " + std::to_string(amount_to_call));
+        }
+        else if (const auto& actions = player.get_actions(table.current_stage); !actions.empty())
+        {
+            // To get positioning and width correct
+            std::ostringstream oss2;
+            std::visit([&oss2](const auto& action){ oss2 << action; }, actions.back());
+            oss << oss2.str();
+        }
+    }
+
+    return oss.str();
+}
+
+void async_holdem_game_orchestrator::execute_showdown()
+{
+    auto &table = _table_state_manager.get_table_state();
+    const auto active_player_count = table.get_active_player_count();
+
+    if (active_player_count > 1)
+    {
+        // Read in the pocket cards one player at a time, the stage is repeated after each
+        for (size_t pos = 0; pos < table.get_num_of_players(); ++pos)
+        {
+            if (!table.has_folded(pos) && !table.players.at(pos).pocket_cards)
+            {
+                read_valid_cards([this, pos](i_async_user_interaction::cards_continuation on_cards){ _user_interaction.get_player_pocket_cards(pos, std::move(on_cards)); }, 2,
+                                 [this, pos](const std::string &cards){ _table_state_manager.set_pocket_cards(pos, cards); repeat_stage(); });
+                return;
+            }
+        }
+    }
+
+    const auto winners = _poker_lib.get_winner_positions(table);
+    const auto split_pots = _table_state_manager.execute_showdown(winners);
+
+    std::ostringstream oss;
+    if (active_player_count == 1)
+    {
+        if (split_pots.size() != 1 || split_pots.front().participant_positions.size() != 1)
+        {
+            throw std::logic_error("There's only one winner but there are " + std::to_string(split_pots.size()) + " split pots");
+        }
+
+        const auto pos = *split_pots.front().participant_positions.begin();
+        const auto& winner = table.players.at(pos);
+        oss << "Player " << winner.player_name << " at position " << (pos + 1) << " has won the pot sized " << split_pots.front().split_size;
+    }
+    else
+    {
+        oss << "There are multiple winners.\n";
+        for (const auto &split : split_pots)
+        {
+            const auto per_winner_split = split.split_size / split.participant_positions.size();
+
+            oss << "Split pot with pot size " << split.split_size << " is divided up between " << split.participant_positions.size() << " winners.";
+            for (const auto &pos : split.participant_positions)
+            {
+                oss << "Player " << table.players.at(pos).player_name << " at position " << (pos + 1) << " has won " << per_winner_split << " from the pot.";
+            }
+        }
+    }
+
+    _user_interaction.notify_player(oss.str());
+    finish_stage();
+}
+
+} // end of namespace poker_lib
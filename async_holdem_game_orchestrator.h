@@ -0,0 +1,76 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include "i_analysis_executor.h"
+#include "i_async_user_interaction.h"
+#include "i_my_poker_lib.h"
+#include "table/i_table_state_manager.h"
+
+namespace poker_lib {
+
+// Plays a game like holdem_game_orchestrator without blocking on input. Every stage asks for its input with a
+// continuation and returns, so a single thread can drive any number of games by answering their requests as the
+// input arrives. The orchestrator and its references must outlive the continuations it hands out.
+class async_holdem_game_orchestrator
+{
+public:
+    // The user's analyses run on analysis_executor if given, otherwise on the thread driving the game
+    async_holdem_game_orchestrator(i_my_poker_lib& poker_lib,
+                                   i_async_user_interaction &user_interaction,
+                                   i_table_state_manager &table_state_manager,
+                                   size_t user_pos,
+                                   i_analysis_executor *analysis_executor = nullptr);
+
+    async_holdem_game_orchestrator(const async_holdem_game_orchestrator&) = delete;
+    async_holdem_game_orchestrator& operator=(const async_holdem_game_orchestrator&) = delete;
+
+    // Runs stages until the first one waits for input. on_game_ended is called once the game ended.
+    // Throws if the game has already been started.
+    void start_game(std::function<void()> on_game_ended = {});
+
+    bool has_ended() const { return _has_ended; }
+
+private:
+    // Runs stages until one waits for input. Continuations called before their request returned only mark the game
+    // as runnable, so a game answered right away doesn't grow the stack with every stage.
+    void resume();
+    void run_stage();
+    // The stage has to be run again, e.g. after invalid cards or before reading the next player's pocket cards
+    void repeat_stage();
+    void finish_stage();
+
+    using cards_request = std::function<void(i_async_user_interaction::cards_continuation)>;
+    // As many cards as the input has
+    static constexpr size_t any_num_of_cards = static_cast<size_t>(-1);
+    void read_valid_cards(const cards_request &request, size_t expected_num_of_cards,
+                          std::function<void(const std::string&)> on_valid_cards);
+    // Asked once before the cards of every deal
+    void read_dead_cards();
+
+    void read_acting_player_action();
+    // Analyses the user's decision on the executor and asks for the action once the recommendation was shown
+    void read_user_action();
+    void notify_recommendation(const table_state &table, const player_analysis &analysis);
+    void apply_acting_player_action(const player_action_t &action);
+    std::string table_state_and_stage_to_user_message() const;
+
+    void execute_showdown();
+
+    i_my_poker_lib& _poker_lib;
+    i_async_user_interaction& _user_interaction;
+    i_table_state_manager& _table_state_manager;
+
+    const size_t _user_pos;
+    i_analysis_executor* const _analysis_executor;
+
+    std::function<void()> _on_game_ended;
+    bool _has_started = false;
+    bool _has_ended = false;
+    bool _is_running = false;
+    bool _is_runnable = false;
+    bool _has_read_dead_cards = false;
+};
+
+} // end of namespace poker_lib
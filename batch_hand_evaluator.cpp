@@ -0,0 +1,341 @@
+#include <bitset>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "batch_hand_evaluator.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define POKER_LIB_X86_64
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(POKER_LIB_X86_64) && defined(__GNUC__)
+#define POKER_LIB_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define POKER_LIB_TARGET_AVX2
+#endif
+
+namespace poker_lib {
+
+constexpr size_t num_of_ranks = 13;
+constexpr size_t num_of_rank_masks = size_t{1} << num_of_ranks;
+
+// Everything worked out of a 13-bit rank mask. Values are 32-bit so AVX2 can gather them.
+struct rank_mask_tables
+{
+    std::vector<int32_t> bit_count = std::vector<int32_t>(num_of_rank_masks);
+    // Masks of the highest 1, 2, 3 and 5 ranks
+    std::vector<int32_t> top_1 = std::vector<int32_t>(num_of_rank_masks);
+    std::vector<int32_t> top_2 = std::vector<int32_t>(num_of_rank_masks);
+    std::vector<int32_t> top_3 = std::vector<int32_t>(num_of_rank_masks);
+    std::vector<int32_t> top_5 = std::vector<int32_t>(num_of_rank_masks);
+    // Bit of the highest straight's top card, 0 if there's none. The wheel's top card is the five.
+    std::vector<int32_t> straight_top = std::vector<int32_t>(num_of_rank_masks);
+
+    rank_mask_tables()
+    {
+        for (uint32_t mask = 0; mask < num_of_rank_masks; ++mask)
+        {
+            bit_count[mask] = static_cast<int32_t>(std::bitset<num_of_ranks>(mask).count());
+
+            uint32_t kept = 0;
+            for (int rank = num_of_ranks - 1, num_of_kept = 0; rank >= 0; --rank)
+            {
+                if (mask & (1u << rank))
+                {
+                    kept |= 1u << rank;
+                    ++num_of_kept;
+                    if (num_of_kept == 1) { top_1[mask] = static_cast<int32_t>(kept); }
+                    if (num_of_kept == 2) { top_2[mask] = static_cast<int32_t>(kept); }
+                    if (num_of_kept == 3) { top_3[mask] = static_cast<int32_t>(kept); }
+                    if (num_of_kept == 5) { top_5[mask] = static_cast<int32_t>(kept); }
+                }
+            }
+            // Fewer ranks than asked for keep all of them
+            if (bit_count[mask] < 2) { top_2[mask] = static_cast<int32_t>(mask); }
+            if (bit_count[mask] < 3) { top_3[mask] = static_cast<int32_t>(mask); }
+            if (bit_count[mask] < 5) { top_5[mask] = static_cast<int32_t>(mask); }
+
+            // Ace is also below the deuce
+            const auto with_low_ace = (mask << 1) | (mask >> (num_of_ranks - 1));
+            const auto straights = with_low_ace & (with_low_ace >> 1) & (with_low_ace >> 2) & (with_low_ace >> 3) & (with_low_ace >> 4);
+            for (int shifted_rank = num_of_ranks; shifted_rank >= 0; --shifted_rank)
+            {
+                if (straights & (1u << shifted_rank))
+                {
+                    straight_top[mask] = static_cast<int32_t>(1u << (shifted_rank + 3));
+                    break;
+                }
+            }
+        }
+    }
+};
+
+namespace {
+
+enum hand_category : uint32_t
+{
+    high_card = 0,
+    pair,
+    two_pair,
+    three_of_a_kind,
+    straight,
+    flush,
+    full_house,
+    four_of_a_kind,
+    straight_flush,
+};
+
+std::shared_ptr<const rank_mask_tables> get_shared_tables()
+{
+    static const auto tables = std::make_shared<const rank_mask_tables>();
+    return tables;
+}
+
+uint32_t make_value(const uint32_t category, const uint32_t primary, const uint32_t kicker)
+{
+    return (category << hand_value_category_shift) | (primary << num_of_ranks) | kicker;
+}
+
+uint32_t evaluate_scalar(const rank_mask_tables &tables, const seven_cards &hand)
+{
+    std::array<uint32_t, 4> suits{};
+    for (const auto card : hand)
+    {
+        suits[card & 3] |= 1u << (card >> 2);
+    }
+
+    // Ranks held at least once, twice, three and four times
+    uint32_t one = 0, two = 0, three = 0, four = 0, flush_ranks = 0;
+    for (const auto suit : suits)
+    {
+        four |= three & suit;
+        three |= two & suit;
+        two |= one & suit;
+        one |= suit;
+        if (tables.bit_count[suit] >= 5) { flush_ranks = suit; }
+    }
+
+    // Same order of overrides as the AVX2 version, the strongest category that holds is applied last
+    auto value = make_value(high_card, static_cast<uint32_t>(tables.top_5[one]), 0);
+    if (two)
+    {
+        value = make_value(pair, two, static_cast<uint32_t>(tables.top_3[one & ~two]));
+    }
+    if (tables.bit_count[two] >= 2)
+    {
+        const auto pairs = static_cast<uint32_t>(tables.top_2[two]);
+        value = make_value(two_pair, pairs, static_cast<uint32_t>(tables.top_1[one & ~pairs]));
+    }
+    if (three)
+    {
+        value = make_value(three_of_a_kind, three, static_cast<uint32_t>(tables.top_2[one & ~three]));
+    }
+    if (tables.straight_top[one])
+    {
+        value = make_value(straight, static_cast<uint32_t>(tables.straight_top[one]), 0);
+    }
+    if (flush_ranks)
+    {
+        value = make_value(flush, static_cast<uint32_t>(tables.top_5[flush_ranks]), 0);
+    }
+    const auto top_three = static_cast<uint32_t>(tables.top_1[three]);
+    if (three && (two & ~top_three))
+    {
+        value = make_value(full_house, top_three, static_cast<uint32_t>(tables.top_1[two & ~top_three]));
+    }
+    if (four)
+    {
+        value = make_value(four_of_a_kind, four, static_cast<uint32_t>(tables.top_1[one & ~four]));
+    }
+    if (tables.straight_top[flush_ranks])
+    {
+        value = make_value(straight_flush, static_cast<uint32_t>(tables.straight_top[flush_ranks]), 0);
+    }
+    return value;
+}
+
+#ifdef POKER_LIB_X86_64
+
+bool is_avx2_supported()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) { return false; }
+    __cpuid(info, 1);
+    const bool has_os_ymm_support = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+    __cpuidex(info, 7, 0);
+    return has_os_ymm_support && (info[1] & (1 << 5));
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+POKER_LIB_TARGET_AVX2 __m256i gather(const std::vector<int32_t> &table, const __m256i indices)
+{
+    return _mm256_i32gather_epi32(table.data(), indices, 4);
+}
+
+POKER_LIB_TARGET_AVX2 __m256i make_value(const uint32_t category, const __m256i primary, const __m256i kicker)
+{
+    const auto shifted_primary = _mm256_slli_epi32(primary, num_of_ranks);
+    return _mm256_or_si256(_mm256_set1_epi32(static_cast<int32_t>(category << hand_value_category_shift)),
+                           _mm256_or_si256(shifted_primary, kicker));
+}
+
+POKER_LIB_TARGET_AVX2 __m256i is_non_zero(const __m256i value)
+{
+    return _mm256_xor_si256(_mm256_cmpeq_epi32(value, _mm256_setzero_si256()), _mm256_set1_epi32(-1));
+}
+
+// Eight hands at a time in 32-bit lanes
+POKER_LIB_TARGET_AVX2 void evaluate_avx2(const rank_mask_tables &tables, const seven_cards *hands, const size_t num_of_hands, uint32_t *values)
+{
+    const auto zero = _mm256_setzero_si256();
+    const auto one_bit = _mm256_set1_epi32(1);
+    const auto suit_bits = _mm256_set1_epi32(3);
+
+    size_t first = 0;
+    for (; first + 8 <= num_of_hands; first += 8)
+    {
+        const auto *batch = hands + first;
+
+        __m256i suits[4] = {zero, zero, zero, zero};
+        for (size_t card = 0; card < 7; ++card)
+        {
+            const auto cards = _mm256_setr_epi32(batch[0][card], batch[1][card], batch[2][card], batch[3][card],
+                                                 batch[4][card], batch[5][card], batch[6][card], batch[7][card]);
+            const auto rank_bit = _mm256_sllv_epi32(one_bit, _mm256_srli_epi32(cards, 2));
+            const auto suit = _mm256_and_si256(cards, suit_bits);
+            for (int suit_index = 0; suit_index < 4; ++suit_index)
+            {
+                const auto is_suit = _mm256_cmpeq_epi32(suit, _mm256_set1_epi32(suit_index));
+                suits[suit_index] = _mm256_or_si256(suits[suit_index], _mm256_and_si256(rank_bit, is_suit));
+            }
+        }
+
+        auto one = zero, two = zero, three = zero, four = zero, flush_ranks = zero;
+        for (const auto suit : suits)
+        {
+            four = _mm256_or_si256(four, _mm256_and_si256(three, suit));
+            three = _mm256_or_si256(three, _mm256_and_si256(two, suit));
+            two = _mm256_or_si256(two, _mm256_and_si256(one, suit));
+            one = _mm256_or_si256(one, suit);
+
+            const auto is_flush = _mm256_cmpgt_epi32(gather(tables.bit_count, suit), _mm256_set1_epi32(4));
+            flush_ranks = _mm256_blendv_epi8(flush_ranks, suit, is_flush);
+        }
+
+        auto value = make_value(high_card, gather(tables.top_5, one), zero);
+
+        value = _mm256_blendv_epi8(value,
+                                   make_value(pair, two, gather(tables.top_3, _mm256_andnot_si256(two, one))),
+                                   is_non_zero(two));
+
+        const auto pairs = gather(tables.top_2, two);
+        value = _mm256_blendv_epi8(value,
+                                   make_value(two_pair, pairs, gather(tables.top_1, _mm256_andnot_si256(pairs, one))),
+                                   _mm256_cmpgt_epi32(gather(tables.bit_count, two), one_bit));
+
+        const auto has_three = is_non_zero(three);
+        value = _mm256_blendv_epi8(value,
+                                   make_value(three_of_a_kind, three, gather(tables.top_2, _mm256_andnot_si256(three, one))),
+                                   has_three);
+
+        const auto straight_top = gather(tables.straight_top, one);
+        value = _mm256_blendv_epi8(value, make_value(straight, straight_top, zero), is_non_zero(straight_top));
+
+        value = _mm256_blendv_epi8(value, make_value(flush, gather(tables.top_5, flush_ranks), zero), is_non_zero(flush_ranks));
+
+        const auto top_three = gather(tables.top_1, three);
+        const auto other_pairs = _mm256_andnot_si256(top_three, two);
+        value = _mm256_blendv_epi8(value,
+                                   make_value(full_house, top_three, gather(tables.top_1, other_pairs)),
+                                   _mm256_and_si256(has_three, is_non_zero(other_pairs)));
+
+        value = _mm256_blendv_epi8(value,
+                                   make_value(four_of_a_kind, four, gather(tables.top_1, _mm256_andnot_si256(four, one))),
+                                   is_non_zero(four));
+
+        const auto straight_flush_top = gather(tables.straight_top, flush_ranks);
+        value = _mm256_blendv_epi8(value, make_value(straight_flush, straight_flush_top, zero), is_non_zero(straight_flush_top));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + first), value);
+    }
+
+    for (; first < num_of_hands; ++first)
+    {
+        values[first] = evaluate_scalar(tables, hands[first]);
+    }
+}
+
+#endif
+
+} // end of anonymous namespace
+
+batch_hand_evaluator::batch_hand_evaluator()
+:
+    _isa(get_best_isa()),
+    _tables(get_shared_tables())
+{
+}
+
+batch_hand_evaluator::batch_hand_evaluator(const hand_evaluator_isa isa, const hand_evaluator_tables tables)
+:
+    _isa(isa),
+    _tables(tables == hand_evaluator_tables::shared ? get_shared_tables() : std::make_shared<const rank_mask_tables>())
+{
+    if (!is_supported(isa))
+    {
+        throw std::invalid_argument("Instruction set is not supported by this CPU");
+    }
+}
+
+bool batch_hand_evaluator::is_supported(const hand_evaluator_isa isa)
+{
+    switch (isa)
+    {
+    case hand_evaluator_isa::scalar:
+        return true;
+    case hand_evaluator_isa::avx2:
+#ifdef POKER_LIB_X86_64
+        return is_avx2_supported();
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+hand_evaluator_isa batch_hand_evaluator::get_best_isa()
+{
+    return is_supported(hand_evaluator_isa::avx2) ? hand_evaluator_isa::avx2 : hand_evaluator_isa::scalar;
+}
+
+void batch_hand_evaluator::evaluate(const seven_cards *hands, const size_t num_of_hands, uint32_t *values) const
+{
+#ifdef POKER_LIB_X86_64
+    if (_isa == hand_evaluator_isa::avx2)
+    {
+        evaluate_avx2(*_tables, hands, num_of_hands, values);
+        return;
+    }
+#endif
+
+    for (size_t index = 0; index < num_of_hands; ++index)
+    {
+        values[index] = evaluate_scalar(*_tables, hands[index]);
+    }
+}
+
+uint32_t batch_hand_evaluator::evaluate(const seven_cards &hand) const
+{
+    return evaluate_scalar(*_tables, hand);
+}
+
+} // end of namespace poker_lib
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace poker_lib {
+
+// Cards are indexed like in OMPEval: 4 * rank + suit where ranks go from deuce to ace
+using seven_cards = std::array<uint8_t, 7>;
+
+// Hand values compare like hands, the better hand has the larger value. Categories go from 0 for high card
+// to 8 for straight flush and take the bits from this shift, lower bits hold the ranks deciding within a category.
+constexpr unsigned hand_value_category_shift = 26;
+inline unsigned get_hand_category(const uint32_t hand_value) { return hand_value >> hand_value_category_shift; }
+
+enum class hand_evaluator_isa
+{
+    scalar,
+    avx2,
+};
+
+enum class hand_evaluator_tables
+{
+    // One copy for every evaluator of the process
+    shared,
+    // The evaluator's own copy, built by the constructing thread. Memory is allocated on the NUMA node of the thread
+    // touching it first, so an evaluator constructed on a thread pinned to a node keeps its tables there.
+    local,
+};
+
+struct rank_mask_tables;
+
+// Evaluates many 7-card hands at once with bit masks of ranks per suit and small lookup tables, eight hands per
+// AVX2 instruction where the CPU supports it. All instruction sets give the same values.
+class batch_hand_evaluator
+{
+public:
+    // Picks the best instruction set the CPU supports
+    batch_hand_evaluator();
+    // Throws if the CPU doesn't support isa
+    explicit batch_hand_evaluator(hand_evaluator_isa isa, hand_evaluator_tables tables = hand_evaluator_tables::shared);
+
+    static bool is_supported(hand_evaluator_isa isa);
+    static hand_evaluator_isa get_best_isa();
+    hand_evaluator_isa get_isa() const { return _isa; }
+
+    void evaluate(const seven_cards *hands, size_t num_of_hands, uint32_t *values) const;
+    uint32_t evaluate(const seven_cards &hand) const;
+
+private:
+    hand_evaluator_isa _isa;
+    std::shared_ptr<const rank_mask_tables> _tables;
+};
+
+} // end of namespace poker_lib
@@ -0,0 +1,540 @@
+#include <omp/CardRange.h>
+#include <omp/Util.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <optional>
+#include <sstream>
+#include <thread>
+
+#include "equity_engine.h"
+#include "event_tracing.h"
+#include "thread_placement.h"
+
+namespace poker_lib {
+
+// splitmix64 finalizer
+static uint64_t mix(uint64_t value)
+{
+    value += 0x9e3779b97f4a7c15ull;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+}
+
+counter_rng::counter_rng(const uint64_t seed, const uint64_t stream)
+:
+    _key(mix(seed ^ mix(stream)))
+{
+}
+
+uint64_t counter_rng::operator()()
+{
+    return mix(_key + mix(_counter++));
+}
+
+namespace {
+
+// Cards known before sampling
+struct equity_spot
+{
+    std::vector<size_t> positions;
+    // Pocket cards per active player, empty if unknown
+    std::vector<std::vector<uint8_t>> pocket_cards;
+    std::vector<uint8_t> board;
+    uint64_t dealt_cards = 0;
+    // Cumulative weights of the combos per active player, empty unless the player's cards are dealt from a range
+    std::vector<std::vector<double>> range_cdfs;
+
+    bool has_ranges() const
+    {
+        return std::any_of(range_cdfs.begin(), range_cdfs.end(), [](const auto &cdf){ return !cdf.empty(); });
+    }
+};
+
+std::vector<uint8_t> get_cards(const uint64_t mask)
+{
+    std::vector<uint8_t> cards;
+    for (uint8_t card = 0; card < 52; ++card)
+    {
+        if (mask & (uint64_t{1} << card)) { cards.emplace_back(card); }
+    }
+    return cards;
+}
+
+[[noreturn]] void throw_invalid_table(const table_state &table)
+{
+    std::ostringstream oss;
+    oss << "Cannot evaluate table. Table: " << table;
+    throw std::invalid_argument(oss.str());
+}
+
+equity_spot make_equity_spot(const table_state &table,
+                             const table_card_masks &card_masks,
+                             const std::vector<const pocket_combo_weights*> &ranges)
+{
+    equity_spot spot;
+
+    const auto board_mask = card_masks.board;
+    const auto dead_mask = card_masks.dead;
+    spot.board = get_cards(board_mask);
+    if (spot.board.size() > 5 || (board_mask & dead_mask))
+    {
+        throw_invalid_table(table);
+    }
+    // Dead cards are simply never dealt, so they cost nothing per sample
+    spot.dealt_cards = board_mask | dead_mask;
+
+    for (size_t pos = 0; pos < table.get_num_of_players(); ++pos)
+    {
+        if (table.has_folded(pos))
+        {
+            continue;
+        }
+
+        spot.positions.emplace_back(pos);
+        spot.pocket_cards.emplace_back();
+        if (table.players.at(pos).pocket_cards)
+        {
+            const auto mask = card_masks.pockets.at(pos);
+            if (omp::bitCount(mask) != 2 || (mask & spot.dealt_cards))
+            {
+                throw_invalid_table(table);
+            }
+            spot.dealt_cards |= mask;
+            spot.pocket_cards.back() = get_cards(mask);
+        }
+    }
+
+    if (spot.positions.empty())
+    {
+        throw_invalid_table(table);
+    }
+
+    // Combos blocked by known cards are left out up front so sampling only rejects ones clashing with other ranges
+    spot.range_cdfs.resize(spot.positions.size());
+    for (size_t player = 0; player < spot.positions.size(); ++player)
+    {
+        const auto pos = spot.positions[player];
+        if (!spot.pocket_cards[player].empty() || pos >= ranges.size() || !ranges[pos])
+        {
+            continue;
+        }
+
+        auto &cdf = spot.range_cdfs[player];
+        double total_weight = 0;
+        for (size_t combo = 0; combo < num_of_pocket_combos; ++combo)
+        {
+            const auto cards = get_pocket_combo_cards(combo);
+            const auto mask = (uint64_t{1} << cards[0]) | (uint64_t{1} << cards[1]);
+            total_weight += (mask & spot.dealt_cards) ? 0 : std::max(0.0f, (*ranges[pos])[combo]);
+            cdf.emplace_back(total_weight);
+        }
+        // Nothing left in the range, the cards are dealt randomly
+        if (total_weight <= 0)
+        {
+            cdf.clear();
+        }
+    }
+    return spot;
+}
+
+// Cards dealt first in every sample: the next two board cards if that many are missing, otherwise the pocket cards
+// of the first player without known ones, otherwise the last board card. Those explain most of the variance of the
+// result while their combinations still fit in a stream. Strata are every combination, shuffled once per seed so
+// that consecutive strata don't share cards.
+struct equity_strata
+{
+    // Number of cards a stratum deals, 0 if nothing is dealt
+    size_t num_of_cards = 0;
+    bool on_board = false;
+    std::vector<std::array<uint8_t, 2>> strata;
+};
+
+equity_strata make_equity_strata(const equity_spot &spot, const uint64_t seed)
+{
+    equity_strata result;
+
+    if (spot.has_ranges())
+    {
+        return result;
+    }
+
+    const bool has_unknown_player = std::any_of(spot.pocket_cards.begin(), spot.pocket_cards.end(),
+                                                [](const auto &cards){ return cards.empty(); });
+    const auto num_of_missing_board_cards = 5 - spot.board.size();
+    result.on_board = num_of_missing_board_cards >= 2 || !has_unknown_player;
+    result.num_of_cards = result.on_board ? std::min<size_t>(2, num_of_missing_board_cards) : 2;
+
+    const auto undealt_cards = get_cards(~spot.dealt_cards & ((uint64_t{1} << 52) - 1));
+    for (size_t first = 0; first < undealt_cards.size() && result.num_of_cards > 0; ++first)
+    {
+        if (result.num_of_cards == 1)
+        {
+            result.strata.push_back({undealt_cards[first], undealt_cards[first]});
+            continue;
+        }
+        for (auto second = first + 1; second < undealt_cards.size(); ++second)
+        {
+            result.strata.push_back({undealt_cards[first], undealt_cards[second]});
+        }
+    }
+
+    counter_rng rng(seed, ~uint64_t{0});
+    for (auto index = result.strata.size(); index > 1; --index)
+    {
+        std::swap(result.strata[index - 1], result.strata[rng.next_below(static_cast<uint32_t>(index))]);
+    }
+    return result;
+}
+
+struct equity_stream_tally
+{
+    // Share of the pots won per player
+    std::vector<double> shares;
+    // Heads-up results of every pair of players, indexed by first * num_of_players + second
+    std::vector<uint64_t> pairwise_wins;
+    std::vector<uint64_t> pairwise_ties;
+};
+
+// Samples one stream. Hands of a stream are ranked in a single batch.
+class equity_stream_sampler
+{
+public:
+    equity_stream_sampler(const equity_spot &spot, const equity_strata &strata, const batch_hand_evaluator &evaluator)
+    :
+        _spot(spot),
+        _strata(strata),
+        _evaluator(evaluator),
+        _range_cards(spot.positions.size())
+    {
+    }
+
+    equity_stream_tally sample(const uint64_t seed, const uint64_t stream, const size_t num_of_samples)
+    {
+        const auto num_of_players = _spot.positions.size();
+        counter_rng rng(seed, stream);
+
+        // Systematic sampling: strata follow each other from a random offset so every sample is still uniform
+        const auto num_of_strata = _strata.strata.size();
+        const size_t first_stratum = num_of_strata ? rng.next_below(static_cast<uint32_t>(num_of_strata)) : 0;
+
+        _hands.resize(num_of_samples * num_of_players);
+        for (size_t sample = 0; sample < num_of_samples; ++sample)
+        {
+            auto dealt_cards = _spot.dealt_cards;
+            std::array<uint8_t, 2> stratum_cards{};
+            size_t num_of_stratum_cards_left = 0;
+            if (num_of_strata)
+            {
+                stratum_cards = _strata.strata[(first_stratum + sample) % num_of_strata];
+                num_of_stratum_cards_left = _strata.num_of_cards;
+                for (size_t card = 0; card < num_of_stratum_cards_left; ++card)
+                {
+                    dealt_cards |= uint64_t{1} << stratum_cards[card];
+                }
+            }
+
+            const auto deal_card = [&]()
+            {
+                if (num_of_stratum_cards_left > 0)
+                {
+                    return stratum_cards[_strata.num_of_cards - num_of_stratum_cards_left--];
+                }
+                while (true)
+                {
+                    const auto card = static_cast<uint8_t>(rng.next_below(52));
+                    if (!(dealt_cards & (uint64_t{1} << card)))
+                    {
+                        dealt_cards |= uint64_t{1} << card;
+                        return card;
+                    }
+                }
+            };
+
+            // Ranged players are dealt before any random card so only clashes between ranges are rejected
+            for (size_t player = 0; player < num_of_players; ++player)
+            {
+                const auto &cdf = _spot.range_cdfs[player];
+                _range_cards[player].reset();
+                for (size_t attempt = 0; attempt < max_range_deal_attempts && !cdf.empty(); ++attempt)
+                {
+                    const auto weight = static_cast<double>(rng() >> 11) * 0x1.0p-53 * cdf.back();
+                    const auto combo = static_cast<size_t>(std::distance(cdf.begin(), std::upper_bound(cdf.begin(), cdf.end(), weight)));
+                    const auto cards = get_pocket_combo_cards(std::min(combo, num_of_pocket_combos - 1));
+                    const auto mask = (uint64_t{1} << cards[0]) | (uint64_t{1} << cards[1]);
+                    if (!(mask & dealt_cards))
+                    {
+                        dealt_cards |= mask;
+                        _range_cards[player] = cards;
+                        break;
+                    }
+                }
+            }
+
+            seven_cards board{};
+            std::copy(_spot.board.begin(), _spot.board.end(), board.begin());
+            const auto deal_board = [&]()
+            {
+                for (auto card = _spot.board.size(); card < 5; ++card)
+                {
+                    board[card] = deal_card();
+                }
+            };
+
+            if (_strata.on_board) { deal_board(); }
+            for (size_t player = 0; player < num_of_players; ++player)
+            {
+                auto &hand = _hands[sample * num_of_players + player];
+                const auto &pocket_cards = _spot.pocket_cards[player];
+                if (const auto &range_cards = _range_cards[player])
+                {
+                    hand[5] = (*range_cards)[0];
+                    hand[6] = (*range_cards)[1];
+                    continue;
+                }
+                hand[5] = pocket_cards.empty() ? deal_card() : pocket_cards[0];
+                hand[6] = pocket_cards.empty() ? deal_card() : pocket_cards[1];
+            }
+            if (!_strata.on_board) { deal_board(); }
+            for (size_t player = 0; player < num_of_players; ++player)
+            {
+                std::copy_n(board.begin(), 5, _hands[sample * num_of_players + player].begin());
+            }
+        }
+
+        _values.resize(_hands.size());
+        _evaluator.evaluate(_hands.data(), _hands.size(), _values.data());
+
+        equity_stream_tally tally;
+        tally.shares.assign(num_of_players, 0);
+        tally.pairwise_wins.assign(num_of_players * num_of_players, 0);
+        tally.pairwise_ties.assign(num_of_players * num_of_players, 0);
+        for (size_t sample = 0; sample < num_of_samples; ++sample)
+        {
+            const auto first = std::next(_values.begin(), sample * num_of_players);
+            const auto best = *std::max_element(first, first + num_of_players);
+            const auto num_of_winners = std::count(first, first + num_of_players, best);
+            for (size_t player = 0; player < num_of_players; ++player)
+            {
+                if (first[player] == best)
+                {
+                    tally.shares[player] += 1.0 / static_cast<double>(num_of_winners);
+                }
+                for (size_t opponent = 0; opponent < num_of_players; ++opponent)
+                {
+                    tally.pairwise_wins[player * num_of_players + opponent] += first[player] > first[opponent];
+                    tally.pairwise_ties[player * num_of_players + opponent] += first[player] == first[opponent];
+                }
+            }
+        }
+        return tally;
+    }
+
+private:
+    const equity_spot &_spot;
+    const equity_strata &_strata;
+    const batch_hand_evaluator &_evaluator;
+    // Gives up on a range after this many clashes in a sample and deals random cards
+    static constexpr size_t max_range_deal_attempts = 1000;
+
+    // Reused between streams
+    std::vector<std::optional<std::array<uint8_t, 2>>> _range_cards;
+    std::vector<seven_cards> _hands;
+    std::vector<uint32_t> _values;
+};
+
+} // end of anonymous namespace
+
+table_card_masks get_table_card_masks(const table_state &table)
+{
+    table_card_masks card_masks;
+    card_masks.board = omp::CardRange::getCardMask(table.communal_cards);
+    card_masks.dead = omp::CardRange::getCardMask(table.dead_cards);
+    for (size_t pos = 0; pos < table.get_num_of_players(); ++pos)
+    {
+        if (const auto &pocket_cards = table.players.at(pos).pocket_cards)
+        {
+            card_masks.pockets.at(pos) = omp::CardRange::getCardMask(*pocket_cards);
+        }
+    }
+    return card_masks;
+}
+
+equity_engine_result calculate_seeded_equities(const table_state &table,
+                                               const equity_engine_config &config,
+                                               const batch_hand_evaluator &evaluator,
+                                               performance_stats *stats,
+                                               const std::vector<const pocket_combo_weights*> &ranges)
+{
+    return calculate_seeded_equities(table, get_table_card_masks(table), config, evaluator, stats, ranges);
+}
+
+equity_engine_result calculate_seeded_equities(const table_state &table,
+                                               const table_card_masks &card_masks,
+                                               const equity_engine_config &config,
+                                               const batch_hand_evaluator &evaluator,
+                                               performance_stats *stats,
+                                               const std::vector<const pocket_combo_weights*> &ranges)
+{
+    const scoped_trace_span span("equity", "calculate_seeded_equities");
+    std::optional<scoped_latency_timer> setup_timer;
+    setup_timer.emplace(stats, pipeline_stage::equity_setup);
+
+    if (config.samples_per_stream == 0)
+    {
+        throw std::invalid_argument("Equity engine needs at least one sample per stream");
+    }
+
+    const auto spot = make_equity_spot(table, card_masks, ranges);
+    const auto strata = config.sampling == equity_sampling::stratified ? make_equity_strata(spot, config.seed) : equity_strata{};
+    const auto num_of_players = spot.positions.size();
+    const auto max_num_of_streams = (config.num_of_samples + config.samples_per_stream - 1) / config.samples_per_stream;
+    const auto num_of_threads = std::max<size_t>(1, std::min(max_num_of_streams,
+        config.num_of_threads ? config.num_of_threads : std::max<size_t>(1, std::thread::hardware_concurrency())));
+
+    const auto get_num_of_stream_samples = [&config](const size_t stream)
+    {
+        return std::min(config.samples_per_stream, config.num_of_samples - stream * config.samples_per_stream);
+    };
+
+    std::vector<equity_stream_tally> stream_tallies(max_num_of_streams);
+    std::vector<double> shares(num_of_players, 0);
+    std::vector<uint64_t> pairwise_wins(num_of_players * num_of_players, 0);
+    std::vector<uint64_t> pairwise_ties(num_of_players * num_of_players, 0);
+    std::vector<double> standard_errors(num_of_players, 0);
+    size_t num_of_samples = 0;
+    size_t num_of_streams = 0;
+
+    setup_timer.reset();
+    {
+        const scoped_latency_timer wait_timer(stats, pipeline_stage::equity_wait);
+        const scoped_thread_utilization_timer utilization_timer(stats);
+        const scoped_thread_affinity affinity(config.scheduler ? std::vector<size_t>{} : config.worker_cpus);
+
+        // Without a target every stream is sampled at once. With one, rounds of a fixed number of streams are sampled
+        // until it's reached so where it stops doesn't depend on the number of threads either.
+        const auto streams_per_round = config.target_standard_error > 0 ? std::max<size_t>(2, config.streams_per_round) : max_num_of_streams;
+        while (num_of_streams < max_num_of_streams)
+        {
+            const auto round_end = std::min(max_num_of_streams, num_of_streams + streams_per_round);
+            std::atomic<size_t> next_stream{num_of_streams};
+            const auto sample_streams = [&]()
+            {
+                const scoped_trace_span worker_span("equity", "sample_streams");
+                equity_stream_sampler sampler(spot, strata, evaluator);
+                for (auto stream = next_stream++; stream < round_end; stream = next_stream++)
+                {
+                    stream_tallies[stream] = sampler.sample(config.seed, stream, get_num_of_stream_samples(stream));
+                }
+            };
+
+            if (config.scheduler)
+            {
+                // Every stream is a chunk so more urgent jobs get the workers between streams
+                const auto first_stream = num_of_streams;
+                config.scheduler->run(config.priority, round_end - first_stream, [&](const size_t chunk)
+                {
+                    const auto stream = first_stream + chunk;
+                    equity_stream_sampler sampler(spot, strata, evaluator);
+                    stream_tallies[stream] = sampler.sample(config.seed, stream, get_num_of_stream_samples(stream));
+                });
+            }
+            else
+            {
+                std::vector<std::thread> threads;
+                for (size_t thread = 1; thread < std::min(num_of_threads, round_end - num_of_streams); ++thread)
+                {
+                    threads.emplace_back([&config, &sample_streams, thread]()
+                    {
+                        if (!config.worker_cpus.empty())
+                        {
+                            set_current_thread_affinity({config.worker_cpus[thread % config.worker_cpus.size()]});
+                        }
+                        sample_streams();
+                    });
+                }
+                sample_streams();
+                for (auto &thread : threads) { thread.join(); }
+            }
+
+            // Added up in stream order, floating point addition isn't associative
+            for (; num_of_streams < round_end; ++num_of_streams)
+            {
+                const auto &tally = stream_tallies[num_of_streams];
+                num_of_samples += get_num_of_stream_samples(num_of_streams);
+                for (size_t player = 0; player < num_of_players; ++player)
+                {
+                    shares[player] += tally.shares[player];
+                }
+                for (size_t pair = 0; pair < pairwise_wins.size(); ++pair)
+                {
+                    pairwise_wins[pair] += tally.pairwise_wins[pair];
+                    pairwise_ties[pair] += tally.pairwise_ties[pair];
+                }
+            }
+
+            // Streams are independent replications of the estimate so their spread gives the standard error
+            if (num_of_streams > 1 && num_of_samples > 0)
+            {
+                for (size_t player = 0; player < num_of_players; ++player)
+                {
+                    const auto equity = shares[player] / static_cast<double>(num_of_samples);
+                    double variance = 0;
+                    for (size_t stream = 0; stream < num_of_streams; ++stream)
+                    {
+                        const auto stream_samples = static_cast<double>(get_num_of_stream_samples(stream));
+                        const auto deviation = stream_tallies[stream].shares[player] - equity * stream_samples;
+                        variance += deviation * deviation;
+                    }
+                    variance *= static_cast<double>(num_of_streams) / static_cast<double>(num_of_streams - 1);
+                    standard_errors[player] = std::sqrt(variance) / static_cast<double>(num_of_samples);
+                }
+            }
+
+            const auto max_standard_error = *std::max_element(standard_errors.begin(), standard_errors.end());
+            if (config.target_standard_error > 0 && num_of_streams > 1 && max_standard_error <= config.target_standard_error)
+            {
+                break;
+            }
+        }
+    }
+
+    equity_engine_result result;
+    result.num_of_samples = num_of_samples;
+    result.equities.assign(table.get_num_of_players(), 0);
+    result.standard_errors.assign(table.get_num_of_players(), 0);
+    result.pairwise_wins.assign(table.get_num_of_players(), std::vector<double>(table.get_num_of_players(), 0));
+    result.pairwise_ties = result.pairwise_wins;
+    const auto to_probability = [num_of_samples](const double count){ return num_of_samples ? count / static_cast<double>(num_of_samples) : 0; };
+    for (size_t player = 0; player < num_of_players; ++player)
+    {
+        const auto pos = spot.positions[player];
+        result.equities[pos] = to_probability(shares[player]);
+        result.standard_errors[pos] = standard_errors[player];
+        for (size_t opponent = 0; opponent < num_of_players; ++opponent)
+        {
+            if (opponent == player)
+            {
+                continue;
+            }
+            const auto pair = player * num_of_players + opponent;
+            result.pairwise_wins[pos][spot.positions[opponent]] = to_probability(static_cast<double>(pairwise_wins[pair]));
+            result.pairwise_ties[pos][spot.positions[opponent]] = to_probability(static_cast<double>(pairwise_ties[pair]));
+        }
+    }
+
+    if (stats)
+    {
+        stats->add_to_counter(performance_counter::equity_calculations, 1);
+        stats->add_to_counter(performance_counter::simulated_hands, num_of_samples);
+    }
+    return result;
+}
+
+double equity_engine_result::get_pairwise_equity(const size_t player_pos, const size_t opponent_pos) const
+{
+    return pairwise_wins.at(player_pos).at(opponent_pos) + pairwise_ties.at(player_pos).at(opponent_pos) / 2;
+}
+
+} // end of namespace poker_lib
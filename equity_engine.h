@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "batch_hand_evaluator.h"
+#include "equity_scheduler.h"
+#include "performance_stats.h"
+#include "range_narrowing.h"
+#include "table/table_state.h"
+
+namespace poker_lib {
+
+// Counter based generator: the n-th number of a stream only depends on the stream's key and n
+class counter_rng
+{
+public:
+    counter_rng(uint64_t seed, uint64_t stream);
+
+    uint64_t operator()();
+    // Uniform in [0, bound) by multiplying the upper 32 bits
+    uint32_t next_below(uint32_t bound) { return static_cast<uint32_t>(((*this)() >> 32) * bound >> 32); }
+
+private:
+    uint64_t _key;
+    uint64_t _counter = 0;
+};
+
+enum class equity_sampling
+{
+    // Every unknown card is dealt uniformly at random
+    plain,
+    // The two next board cards, or an unknown player's pocket cards on the turn, go through all their combinations
+    // systematically instead. It needs about a third of the samples for the same precision after the flop.
+    stratified,
+};
+
+struct equity_engine_config
+{
+    uint64_t seed = 1;
+    equity_sampling sampling = equity_sampling::stratified;
+    // At most this many samples are taken
+    size_t num_of_samples = 200000;
+    // Sampling stops early once the standard error of every player's equity is at most this, 0 disables it
+    double target_standard_error = 0;
+    // Streams sampled between checks of the target standard error
+    size_t streams_per_round = 8;
+    // Samples are split into streams of this size which threads take one at a time. Every stream has its own
+    // counter_rng and results are added up in stream order so they don't depend on the number of threads.
+    size_t samples_per_stream = 4096;
+    // 0 means one thread per core
+    size_t num_of_threads = 0;
+    // Workers are pinned to these CPUs one each, round robin, and the calling thread to all of them while it samples.
+    // Empty leaves placement to the OS.
+    std::vector<size_t> worker_cpus;
+    // Streams run as chunks of a job of this priority on the scheduler's workers instead of threads of their own.
+    // num_of_threads and worker_cpus are ignored then.
+    std::shared_ptr<equity_scheduler> scheduler;
+    equity_job_priority priority = equity_job_priority::live_decision;
+};
+
+struct equity_engine_result
+{
+    // Per table position, 0 for folded players
+    std::vector<double> equities;
+    // Estimated from the spread of the streams' equities, 0 with fewer than two streams
+    std::vector<double> standard_errors;
+    // Probabilities of the player at the first index having a better or an equally good hand than the one at the
+    // second, from the same runouts as the equities. Indexed by table position, 0 for folded players and the diagonal.
+    std::vector<std::vector<double>> pairwise_wins;
+    std::vector<std::vector<double>> pairwise_ties;
+    size_t num_of_samples = 0;
+
+    // Heads-up equity of one player against another, ignoring everybody else in the pot. Equities above are
+    // against the whole field.
+    double get_pairwise_equity(size_t player_pos, size_t opponent_pos) const;
+};
+
+// OMPEval card masks of a table, parsed once and shared by the calculations of an analysis
+struct table_card_masks
+{
+    uint64_t board = 0;
+    uint64_t dead = 0;
+    // Per table position, 0 if the pocket cards are unknown
+    std::array<uint64_t, max_num_of_players> pockets{};
+};
+table_card_masks get_table_card_masks(const table_state &table);
+
+// Monte Carlo equities of the players still in the pot. Unknown pocket cards and the rest of the board are dealt
+// randomly, never from the table's dead cards. Players with unknown pocket cards and a range, indexed by table
+// position, are dealt combos in proportion to its weights instead; stratification is turned off then. Results are
+// bit identical for the same table, ranges and config. Throws on invalid or duplicated cards.
+equity_engine_result calculate_seeded_equities(const table_state &table,
+                                               const equity_engine_config &config,
+                                               const batch_hand_evaluator &evaluator,
+                                               performance_stats *stats = nullptr,
+                                               const std::vector<const pocket_combo_weights*> &ranges = {});
+// Same with the table's cards parsed by the caller
+equity_engine_result calculate_seeded_equities(const table_state &table,
+                                               const table_card_masks &card_masks,
+                                               const equity_engine_config &config,
+                                               const batch_hand_evaluator &evaluator,
+                                               performance_stats *stats = nullptr,
+                                               const std::vector<const pocket_combo_weights*> &ranges = {});
+
+} // end of namespace poker_lib
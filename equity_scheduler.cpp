@@ -0,0 +1,135 @@
+#include <algorithm>
+
+#include "equity_scheduler.h"
+#include "event_tracing.h"
+#include "thread_placement.h"
+
+namespace poker_lib {
+
+equity_scheduler::equity_scheduler(const size_t num_of_threads, std::vector<size_t> worker_cpus)
+{
+    const auto num_of_workers = num_of_threads ? num_of_threads : std::max<size_t>(1, std::thread::hardware_concurrency());
+    for (size_t thread = 0; thread < num_of_workers; ++thread)
+    {
+        _threads.emplace_back([this, thread, worker_cpus]()
+        {
+            if (!worker_cpus.empty())
+            {
+                set_current_thread_affinity({worker_cpus[thread % worker_cpus.size()]});
+            }
+            run_worker();
+        });
+    }
+}
+
+equity_scheduler::~equity_scheduler()
+{
+    {
+        const std::lock_guard<std::mutex> lock(_mutex);
+        _is_stopping = true;
+    }
+    _has_chunks.notify_all();
+    for (auto &thread : _threads) { thread.join(); }
+}
+
+equity_scheduler::scheduled_job* equity_scheduler::take_next_job()
+{
+    for (auto &queue : _queues)
+    {
+        if (queue.empty())
+        {
+            continue;
+        }
+
+        // The job goes to the back of its queue so jobs of the same priority alternate
+        auto *job = queue.front();
+        queue.pop_front();
+        if (job->next_chunk + 1 < job->num_of_chunks)
+        {
+            queue.push_back(job);
+        }
+        return job;
+    }
+    return nullptr;
+}
+
+void equity_scheduler::execute_chunk(std::unique_lock<std::mutex> &lock, scheduled_job &job, const size_t chunk)
+{
+    lock.unlock();
+    std::exception_ptr exception;
+    try
+    {
+        (*job.run_chunk)(chunk);
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+    lock.lock();
+
+    if (exception && !job.exception)
+    {
+        job.exception = exception;
+    }
+    if (++job.num_of_finished_chunks == job.num_of_chunks)
+    {
+        _has_finished_chunks.notify_all();
+    }
+}
+
+void equity_scheduler::run_worker()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true)
+    {
+        auto *job = take_next_job();
+        if (!job)
+        {
+            if (_is_stopping)
+            {
+                return;
+            }
+            _has_chunks.wait(lock);
+            continue;
+        }
+
+        const scoped_trace_span span("equity", "scheduled_chunk");
+        execute_chunk(lock, *job, job->next_chunk++);
+    }
+}
+
+void equity_scheduler::run(const equity_job_priority priority, const size_t num_of_chunks, const std::function<void(size_t)> &run_chunk)
+{
+    if (num_of_chunks == 0)
+    {
+        return;
+    }
+
+    scheduled_job job;
+    job.run_chunk = &run_chunk;
+    job.num_of_chunks = num_of_chunks;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto &queue = _queues[static_cast<size_t>(priority)];
+    queue.push_back(&job);
+    _has_chunks.notify_all();
+
+    // The caller helps with its own job so it never waits for chunks nobody has started
+    while (job.next_chunk < job.num_of_chunks)
+    {
+        const auto chunk = job.next_chunk++;
+        if (job.next_chunk == job.num_of_chunks)
+        {
+            queue.erase(std::find(queue.begin(), queue.end(), &job));
+        }
+        execute_chunk(lock, job, chunk);
+    }
+    _has_finished_chunks.wait(lock, [&job](){ return job.num_of_finished_chunks == job.num_of_chunks; });
+
+    if (job.exception)
+    {
+        std::rethrow_exception(job.exception);
+    }
+}
+
+} // end of namespace poker_lib
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace poker_lib {
+
+enum class equity_job_priority
+{
+    // A player is waiting for the recommendation
+    live_decision,
+    // Precomputing spots that may come up
+    speculative,
+    // Analytics and database generation
+    offline_batch,
+};
+constexpr size_t num_of_equity_job_priorities = 3;
+
+// Worker threads shared by every table of a process. Jobs are split into chunks, e.g. sample streams, and workers
+// always take a chunk of the most urgent job. A live decision therefore waits for at most the chunks already
+// running instead of a whole background batch. Jobs of the same priority take turns chunk by chunk.
+class equity_scheduler
+{
+public:
+    // 0 threads means one per core. Workers are pinned to worker_cpus one each if it's not empty, e.g. the CPUs of
+    // one NUMA node for a socket local pool.
+    explicit equity_scheduler(size_t num_of_threads = 0, std::vector<size_t> worker_cpus = {});
+    ~equity_scheduler();
+
+    equity_scheduler(const equity_scheduler&) = delete;
+    equity_scheduler& operator=(const equity_scheduler&) = delete;
+
+    size_t get_num_of_threads() const { return _threads.size(); }
+
+    // Calls run_chunk with every index below num_of_chunks on the workers and on the calling thread, which only runs
+    // chunks of its own job. Returns when all of them finished and rethrows the first exception thrown by one.
+    void run(equity_job_priority priority, size_t num_of_chunks, const std::function<void(size_t)> &run_chunk);
+
+private:
+    struct scheduled_job
+    {
+        const std::function<void(size_t)> *run_chunk = nullptr;
+        size_t num_of_chunks = 0;
+        size_t next_chunk = 0;
+        size_t num_of_finished_chunks = 0;
+        std::exception_ptr exception;
+    };
+
+    // Must be called with the mutex locked. Null if no job has chunks left.
+    scheduled_job* take_next_job();
+    void execute_chunk(std::unique_lock<std::mutex> &lock, scheduled_job &job, size_t chunk);
+    void run_worker();
+
+    std::mutex _mutex;
+    std::condition_variable _has_chunks;
+    std::condition_variable _has_finished_chunks;
+    // Jobs with chunks left to start per priority
+    std::array<std::deque<scheduled_job*>, num_of_equity_job_priorities> _queues;
+    bool _is_stopping = false;
+    std::vector<std::thread> _threads;
+};
+
+} // end of namespace poker_lib
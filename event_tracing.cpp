@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <iomanip>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include "event_tracing.h"
+
+namespace poker_lib {
+
+namespace {
+
+// Only its owner thread pushes and clears it, readers only look at it after recording finished
+class trace_ring_buffer
+{
+public:
+    explicit trace_ring_buffer(const size_t thread_id)
+    :
+        _thread_id(thread_id),
+        _events(trace_ring_buffer_capacity)
+    {
+    }
+
+    // Events of an earlier tracing session are dropped first
+    void push(const trace_event &event, const uint64_t session_index)
+    {
+        if (_session_index.load(std::memory_order_relaxed) != session_index)
+        {
+            _num_of_pushed.store(0, std::memory_order_relaxed);
+            _session_index.store(session_index, std::memory_order_relaxed);
+        }
+        const auto num_of_pushed = _num_of_pushed.load(std::memory_order_relaxed);
+        _events[num_of_pushed % trace_ring_buffer_capacity] = event;
+        _num_of_pushed.store(num_of_pushed + 1, std::memory_order_release);
+    }
+
+    // Only visits events of the given tracing session
+    template <typename FuncT>
+    void for_each_event(const uint64_t session_index, FuncT func) const
+    {
+        const auto num_of_pushed = _num_of_pushed.load(std::memory_order_acquire);
+        if (_session_index.load(std::memory_order_relaxed) != session_index)
+        {
+            return;
+        }
+        const auto first = num_of_pushed > trace_ring_buffer_capacity ? num_of_pushed - trace_ring_buffer_capacity : 0;
+        for (auto index = first; index < num_of_pushed; ++index)
+        {
+            func(_events[index % trace_ring_buffer_capacity]);
+        }
+    }
+
+    size_t get_thread_id() const { return _thread_id; }
+
+    // Buffers of finished threads are handed over to new threads so their number is bounded by concurrent threads
+    std::atomic<bool> is_owned{true};
+
+private:
+    const size_t _thread_id;
+    std::vector<trace_event> _events;
+    std::atomic<uint64_t> _num_of_pushed{0};
+    std::atomic<uint64_t> _session_index{0};
+};
+
+struct trace_session
+{
+    std::atomic<bool> is_enabled{false};
+    std::atomic<std::chrono::steady_clock::rep> epoch{0};
+    // Incremented by start_tracing. Buffers are cleared by their owner threads when they see a new one, so threads
+    // still recording never race with clearing.
+    std::atomic<uint64_t> session_index{0};
+
+    std::mutex buffers_mutex;
+    std::vector<std::shared_ptr<trace_ring_buffer>> buffers;
+};
+
+trace_session& get_session()
+{
+    static trace_session session;
+    return session;
+}
+
+// Releases the thread's buffer when the thread exits
+class thread_buffer_owner
+{
+public:
+    ~thread_buffer_owner()
+    {
+        if (_buffer)
+        {
+            _buffer->is_owned.store(false, std::memory_order_release);
+        }
+    }
+
+    trace_ring_buffer& get_buffer()
+    {
+        if (!_buffer)
+        {
+            auto &session = get_session();
+            std::lock_guard<std::mutex> lock(session.buffers_mutex);
+
+            const auto free_buffer = std::find_if(session.buffers.begin(), session.buffers.end(), [](const auto &buffer)
+            {
+                bool expected = false;
+                return buffer->is_owned.compare_exchange_strong(expected, true, std::memory_order_acq_rel);
+            });
+            if (free_buffer != session.buffers.end())
+            {
+                _buffer = *free_buffer;
+            }
+            else
+            {
+                _buffer = std::make_shared<trace_ring_buffer>(session.buffers.size() + 1);
+                session.buffers.emplace_back(_buffer);
+            }
+        }
+        return *_buffer;
+    }
+
+private:
+    std::shared_ptr<trace_ring_buffer> _buffer;
+};
+
+void write_json_string(std::ostream &os, const char *text)
+{
+    os << '"';
+    for (; text && *text; ++text)
+    {
+        if (*text == '"' || *text == '\\') { os << '\\'; }
+        os << *text;
+    }
+    os << '"';
+}
+
+void push_trace_event(const char *category,
+                      const char *name,
+                      const std::chrono::steady_clock::time_point start,
+                      const std::chrono::steady_clock::time_point end,
+                      const bool is_async)
+{
+    const auto &session = get_session();
+    if (!session.is_enabled.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    thread_local thread_buffer_owner owner;
+
+    const std::chrono::steady_clock::time_point epoch{std::chrono::steady_clock::duration(session.epoch.load(std::memory_order_relaxed))};
+    owner.get_buffer().push({category, name, start - epoch, end - start, is_async}, session.session_index.load(std::memory_order_relaxed));
+}
+
+} // end of anonymous namespace
+
+void start_tracing()
+{
+    auto &session = get_session();
+    session.session_index.fetch_add(1, std::memory_order_relaxed);
+    session.epoch.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    session.is_enabled.store(true, std::memory_order_release);
+}
+
+void stop_tracing()
+{
+    get_session().is_enabled.store(false, std::memory_order_release);
+}
+
+bool is_tracing_enabled()
+{
+    return get_session().is_enabled.load(std::memory_order_relaxed);
+}
+
+void record_trace_event(const char *category,
+                        const char *name,
+                        const std::chrono::steady_clock::time_point start,
+                        const std::chrono::steady_clock::time_point end)
+{
+    push_trace_event(category, name, start, end, false);
+}
+
+void record_async_trace_event(const char *category,
+                              const char *name,
+                              const std::chrono::steady_clock::time_point start,
+                              const std::chrono::steady_clock::time_point end)
+{
+    push_trace_event(category, name, start, end, true);
+}
+
+void write_chrome_trace(std::ostream &os)
+{
+    auto &session = get_session();
+    std::lock_guard<std::mutex> lock(session.buffers_mutex);
+
+    // Formatted separately to not change the flags of os
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+    bool is_first = true;
+    size_t num_of_async_spans = 0;
+    const auto session_index = session.session_index.load(std::memory_order_relaxed);
+    for (const auto &buffer : session.buffers)
+    {
+        buffer->for_each_event(session_index, [&](const trace_event &event)
+        {
+            const auto write_name_and_category = [&]()
+            {
+                oss << (is_first ? "\n" : ",\n") << "{\"name\":";
+                write_json_string(oss, event.name);
+                oss << ",\"cat\":";
+                write_json_string(oss, event.category);
+                is_first = false;
+            };
+
+            // Timestamps are in microseconds
+            write_name_and_category();
+            if (!event.is_async)
+            {
+                oss << ",\"ph\":\"X\",\"ts\":" << static_cast<double>(event.start.count()) / 1000
+                    << ",\"dur\":" << static_cast<double>(event.duration.count()) / 1000
+                    << ",\"pid\":1,\"tid\":" << buffer->get_thread_id() << '}';
+                return;
+            }
+
+            // Every async span gets its own id so overlapping ones of the same name aren't paired up wrongly
+            ++num_of_async_spans;
+            oss << ",\"ph\":\"b\",\"ts\":" << static_cast<double>(event.start.count()) / 1000
+                << ",\"id\":" << num_of_async_spans << ",\"pid\":1,\"tid\":" << buffer->get_thread_id() << '}';
+            write_name_and_category();
+            oss << ",\"ph\":\"e\",\"ts\":" << static_cast<double>((event.start + event.duration).count()) / 1000
+                << ",\"id\":" << num_of_async_spans << ",\"pid\":1,\"tid\":" << buffer->get_thread_id() << '}';
+        });
+    }
+    oss << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    os << oss.str();
+}
+
+} // end of namespace poker_lib
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace poker_lib {
+
+// Opt-in tracing of timed spans into Chrome trace JSON, viewable in chrome://tracing or Perfetto.
+// Every thread records into its own lock-free ring buffer which keeps the latest events once it's full.
+constexpr size_t trace_ring_buffer_capacity = 16384;
+
+// Names and categories aren't copied so they must be string literals or otherwise outlive the trace
+struct trace_event
+{
+    const char *category = nullptr;
+    const char *name = nullptr;
+    // Since tracing started
+    std::chrono::nanoseconds start{0};
+    std::chrono::nanoseconds duration{0};
+    // Written as a begin and end pair of an async span instead of a complete event nested in its thread's spans
+    bool is_async = false;
+};
+
+// Clears events recorded so far and starts recording
+void start_tracing();
+void stop_tracing();
+bool is_tracing_enabled();
+
+// Only records if tracing is enabled
+void record_trace_event(const char *category,
+                        const char *name,
+                        std::chrono::steady_clock::time_point start,
+                        std::chrono::steady_clock::time_point end);
+
+// Same as record_trace_event but for spans which don't nest in the recording thread's spans, e.g. waits for input
+// while the thread serves other work
+void record_async_trace_event(const char *category,
+                              const char *name,
+                              std::chrono::steady_clock::time_point start,
+                              std::chrono::steady_clock::time_point end);
+
+// Writes events of all threads, should be called after tracing stopped and threads finished recording
+void write_chrome_trace(std::ostream &os);
+
+// Records a span from its construction to its destruction, does nothing unless tracing is enabled
+class scoped_trace_span
+{
+public:
+    scoped_trace_span(const char *category, const char *name)
+    :
+        _category(category),
+        _name(name),
+        _is_enabled(is_tracing_enabled()),
+        _start(_is_enabled ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{})
+    {
+    }
+    scoped_trace_span(const scoped_trace_span &) = delete;
+    scoped_trace_span &operator=(const scoped_trace_span &) = delete;
+
+    ~scoped_trace_span()
+    {
+        if (_is_enabled)
+        {
+            record_trace_event(_category, _name, _start, std::chrono::steady_clock::now());
+        }
+    }
+
+private:
+    const char *const _category;
+    const char *const _name;
+    const bool _is_enabled;
+    const std::chrono::steady_clock::time_point _start;
+};
+
+// Records an async span from its construction until finish is called, e.g. from the continuation of a request.
+// Copyable so it can be captured by the continuation.
+class async_trace_span
+{
+public:
+    async_trace_span(const char *category, const char *name)
+    :
+        _category(category),
+        _name(name),
+        _is_enabled(is_tracing_enabled()),
+        _start(_is_enabled ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{})
+    {
+    }
+
+    void finish() const
+    {
+        if (_is_enabled)
+        {
+            record_async_trace_event(_category, _name, _start, std::chrono::steady_clock::now());
+        }
+    }
+
+private:
+    const char *_category;
+    const char *_name;
+    bool _is_enabled;
+    std::chrono::steady_clock::time_point _start;
+};
+
+} // end of namespace poker_lib
@@ -0,0 +1,303 @@
+#include <omp/CardRange.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+#include "equity_engine.h"
+#include "flop_equity_database.h"
+#include "hand_indexer.h"
+
+namespace poker_lib {
+
+constexpr char rank_names[] = "23456789TJQKA";
+constexpr char suit_names[] = "shcd";
+
+static std::string get_card_name(const uint8_t card)
+{
+    return {rank_names[card / 4], suit_names[card % 4]};
+}
+
+static const hand_indexer& get_flop_indexer()
+{
+    static const hand_indexer indexer({2, 3});
+    return indexer;
+}
+
+uint32_t get_canonical_flop_key(const std::array<uint8_t, 2> &pocket_cards, const std::array<uint8_t, 3> &flop)
+{
+    return static_cast<uint32_t>(get_flop_indexer().get_index({pocket_cards[0], pocket_cards[1], flop[0], flop[1], flop[2]}));
+}
+
+std::vector<std::array<uint8_t, 2>> get_hand_class_combos(const std::string &hand_class)
+{
+    const auto first_rank = hand_class.empty() ? nullptr : std::strchr(rank_names, hand_class[0]);
+    const auto second_rank = hand_class.size() < 2 ? nullptr : std::strchr(rank_names, hand_class[1]);
+    const auto kind = hand_class.size() == 3 ? hand_class[2] : ' ';
+    if (!first_rank || !second_rank || !*first_rank || !*second_rank || hand_class.size() > 3 ||
+        (first_rank == second_rank && hand_class.size() == 3) || (kind != ' ' && kind != 's' && kind != 'o'))
+    {
+        throw std::invalid_argument("Invalid hand class " + hand_class);
+    }
+
+    const auto first = static_cast<uint8_t>(first_rank - rank_names);
+    const auto second = static_cast<uint8_t>(second_rank - rank_names);
+
+    std::vector<std::array<uint8_t, 2>> result;
+    for (uint8_t first_suit = 0; first_suit < 4; ++first_suit)
+    {
+        for (uint8_t second_suit = 0; second_suit < 4; ++second_suit)
+        {
+            const bool is_suited = first_suit == second_suit;
+            if ((first == second && first_suit >= second_suit) || (kind == 's' && !is_suited) || (kind == 'o' && is_suited))
+            {
+                continue;
+            }
+            result.push_back({static_cast<uint8_t>(first * 4 + first_suit), static_cast<uint8_t>(second * 4 + second_suit)});
+        }
+    }
+    return result;
+}
+
+static std::vector<std::string> get_all_hand_classes()
+{
+    std::vector<std::string> result;
+    for (size_t high = 0; high < 13; ++high)
+    {
+        for (size_t low = 0; low <= high; ++low)
+        {
+            const std::string ranks{rank_names[high], rank_names[low]};
+            if (high == low)
+            {
+                result.emplace_back(ranks);
+            }
+            else
+            {
+                result.emplace_back(ranks + "s");
+                result.emplace_back(ranks + "o");
+            }
+        }
+    }
+    return result;
+}
+
+//
+// Database file
+//
+
+struct flop_equity_database_header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t samples_per_entry;
+    uint64_t num_of_entries;
+};
+
+constexpr char database_file_magic[8] = {'F', 'L', 'O', 'P', 'E', 'Q', 'D', 'B'};
+// Version 2 keys are the flop indices of hand_indexer
+constexpr uint32_t database_file_version = 2;
+
+// Keys of every flop of the hand classes' combos, each suit isomorphic group only once
+static std::vector<uint32_t> get_canonical_keys(const std::vector<std::string> &hand_classes)
+{
+    const hand_indexer pocket_indexer({2});
+    std::vector<bool> is_pocket_class_used(pocket_indexer.size(), false);
+    for (const auto &hand_class : hand_classes)
+    {
+        for (const auto &pocket_cards : get_hand_class_combos(hand_class))
+        {
+            is_pocket_class_used[pocket_indexer.get_index({pocket_cards[0], pocket_cards[1]})] = true;
+        }
+    }
+
+    const auto &flop_indexer = get_flop_indexer();
+    std::vector<uint32_t> result;
+    for (uint32_t key = 0; key < flop_indexer.size(); ++key)
+    {
+        if (is_pocket_class_used[pocket_indexer.get_index(flop_indexer.get_cards(key))]) { result.emplace_back(key); }
+    }
+    return result;
+}
+
+static double calculate_entry_equity(const uint32_t key,
+                                     const flop_equity_database_config &config,
+                                     const batch_hand_evaluator &evaluator)
+{
+    const auto cards = get_flop_indexer().get_cards(key);
+
+    table_state table;
+    table.current_stage = game_stages::flop_betting_round;
+    table.add_player(1, "hero");
+    table.players.back().pocket_cards = get_card_name(cards[0]) + " " + get_card_name(cards[1]);
+    table.add_player(1, "villain");
+    table.communal_cards = get_card_name(cards[2]) + " " + get_card_name(cards[3]) + " " + get_card_name(cards[4]);
+
+    // Threads already work on different entries
+    equity_engine_config engine_config;
+    engine_config.seed = config.seed + key;
+    engine_config.num_of_samples = config.samples_per_entry;
+    engine_config.num_of_threads = 1;
+    return calculate_seeded_equities(table, engine_config, evaluator).equities[0];
+}
+
+flop_equity_database_stats generate_flop_equity_database(const flop_equity_database_config &config, const std::string &database_path)
+{
+    if (config.samples_per_entry == 0)
+    {
+        throw std::invalid_argument("Flop equity database needs at least one sample per entry");
+    }
+
+    const auto start_time = std::chrono::steady_clock::now();
+    const auto keys = get_canonical_keys(config.hand_classes.empty() ? get_all_hand_classes() : config.hand_classes);
+    std::vector<uint16_t> equities(keys.size());
+
+    // Entries are independent so threads just take the next one
+    const batch_hand_evaluator evaluator;
+    std::atomic<size_t> next_entry{0};
+    const auto work = [&]()
+    {
+        for (auto entry = next_entry++; entry < keys.size(); entry = next_entry++)
+        {
+            equities[entry] = static_cast<uint16_t>(calculate_entry_equity(keys[entry], config, evaluator) * 65535 + 0.5);
+        }
+    };
+
+    const size_t num_of_threads = config.num_of_threads ? config.num_of_threads : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> threads;
+    for (size_t thread_index = 0; thread_index < num_of_threads; ++thread_index)
+    {
+        threads.emplace_back(work);
+    }
+    for (auto &thread : threads) { thread.join(); }
+
+    flop_equity_database_header header{};
+    std::memcpy(header.magic, database_file_magic, sizeof(header.magic));
+    header.version = database_file_version;
+    header.samples_per_entry = static_cast<uint32_t>(config.samples_per_entry);
+    header.num_of_entries = keys.size();
+
+    std::ofstream file(database_path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(keys.data()), static_cast<std::streamsize>(keys.size() * sizeof(uint32_t)));
+    file.write(reinterpret_cast<const char*>(equities.data()), static_cast<std::streamsize>(equities.size() * sizeof(uint16_t)));
+    if (!file)
+    {
+        throw std::runtime_error("Cannot write flop equity database " + database_path);
+    }
+
+    flop_equity_database_stats stats;
+    stats.num_of_entries = keys.size();
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    return stats;
+}
+
+//
+// Database lookup
+//
+
+flop_equity_database::flop_equity_database(const std::string &database_path)
+:
+    _file(database_path)
+{
+    flop_equity_database_header header{};
+    if (_file.size() < sizeof(header))
+    {
+        throw std::invalid_argument("Flop equity database " + database_path + " is too small");
+    }
+    std::memcpy(&header, _file.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, database_file_magic, sizeof(header.magic)) != 0 ||
+        header.version != database_file_version ||
+        _file.size() != sizeof(header) + header.num_of_entries * (sizeof(uint32_t) + sizeof(uint16_t)))
+    {
+        throw std::invalid_argument("File " + database_path + " is not a compatible flop equity database");
+    }
+
+    _num_of_entries = static_cast<size_t>(header.num_of_entries);
+    _keys = reinterpret_cast<const uint32_t*>(static_cast<const char*>(_file.data()) + sizeof(header));
+    _equities = reinterpret_cast<const uint16_t*>(_keys + _num_of_entries);
+}
+
+std::optional<double> flop_equity_database::find_equity(const std::array<uint8_t, 2> &pocket_cards, const std::array<uint8_t, 3> &flop) const
+{
+    const auto key = get_canonical_flop_key(pocket_cards, flop);
+    const auto end = _keys + _num_of_entries;
+    const auto it = std::lower_bound(_keys, end, key);
+    if (it == end || *it != key)
+    {
+        return std::nullopt;
+    }
+    return _equities[it - _keys] / 65535.0;
+}
+
+// Cards of the mask in increasing order if it has exactly N of them
+template<size_t N>
+static std::optional<std::array<uint8_t, N>> get_cards(const uint64_t mask)
+{
+    std::array<uint8_t, N> result{};
+    size_t num_of_cards = 0;
+    for (uint8_t card = 0; card < 52; ++card)
+    {
+        if (!(mask & (uint64_t{1} << card)))
+        {
+            continue;
+        }
+        if (num_of_cards == N)
+        {
+            return std::nullopt;
+        }
+        result[num_of_cards++] = card;
+    }
+    return num_of_cards == N ? std::optional{result} : std::nullopt;
+}
+
+std::optional<std::vector<double>> flop_equity_database::find_equities(const table_state &table) const
+{
+    if (table.get_active_player_count() != 2 || !table.dead_cards.empty())
+    {
+        return std::nullopt;
+    }
+
+    const auto flop = get_cards<3>(omp::CardRange::getCardMask(table.communal_cards));
+    if (!flop)
+    {
+        return std::nullopt;
+    }
+
+    std::optional<size_t> hero_pos;
+    std::optional<size_t> villain_pos;
+    for (size_t pos = 0; pos < table.get_num_of_players(); ++pos)
+    {
+        if (!table.has_folded(pos))
+        {
+            (table.players.at(pos).pocket_cards ? hero_pos : villain_pos) = pos;
+        }
+    }
+    if (!hero_pos || !villain_pos)
+    {
+        return std::nullopt;
+    }
+
+    const auto pocket_mask = omp::CardRange::getCardMask(*table.players.at(*hero_pos).pocket_cards);
+    const auto pocket_cards = get_cards<2>(pocket_mask);
+    if (!pocket_cards || (pocket_mask & omp::CardRange::getCardMask(table.communal_cards)))
+    {
+        return std::nullopt;
+    }
+
+    const auto equity = find_equity(*pocket_cards, *flop);
+    if (!equity)
+    {
+        return std::nullopt;
+    }
+
+    std::vector<double> result(table.get_num_of_players(), 0);
+    result[*hero_pos] = *equity;
+    result[*villain_pos] = 1 - *equity;
+    return result;
+}
+
+} // end of namespace poker_lib
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "memory_mapped_file.h"
+#include "table/table_state.h"
+
+namespace poker_lib {
+
+// Same for every suit permutation of the pocket cards and the flop, since they all have the same equity. It's the
+// index of hand_indexer({2, 3}).
+uint32_t get_canonical_flop_key(const std::array<uint8_t, 2> &pocket_cards, const std::array<uint8_t, 3> &flop);
+
+// Combos of a hand class like "AA", "AKs", "AKo" or "AK" for both. Throws if hand_class isn't one.
+std::vector<std::array<uint8_t, 2>> get_hand_class_combos(const std::string &hand_class);
+
+struct flop_equity_database_config
+{
+    // Every flop of every combo of these is stored, all 169 classes if empty
+    std::vector<std::string> hand_classes;
+    // Equities against a random hand are estimated by the seeded equity engine
+    size_t samples_per_entry = 20000;
+    uint64_t seed = 1;
+    // 0 means one thread per core
+    size_t num_of_threads = 0;
+};
+
+struct flop_equity_database_stats
+{
+    size_t num_of_entries = 0;
+    double seconds = 0;
+};
+
+// Computes the entries in parallel and writes them to database_path
+flop_equity_database_stats generate_flop_equity_database(const flop_equity_database_config &config, const std::string &database_path);
+
+// Database written by generate_flop_equity_database. Sorted keys and the equities quantised to 16 bits are stored as
+// two arrays in the memory mapped file, 6 bytes per entry, and looked up with a binary search.
+class flop_equity_database
+{
+public:
+    // Throws if the file is not a valid database file
+    explicit flop_equity_database(const std::string &database_path);
+
+    size_t size() const { return _num_of_entries; }
+
+    // Equity of the pocket cards against a random hand on the flop, nullopt if the database doesn't have it
+    std::optional<double> find_equity(const std::array<uint8_t, 2> &pocket_cards, const std::array<uint8_t, 3> &flop) const;
+    // Equities per table position like calculate_equities. Returns nullopt unless two players are left on the flop,
+    // one of them with known pocket cards and the other one holding a random hand, there are no dead cards and the
+    // database has the spot.
+    std::optional<std::vector<double>> find_equities(const table_state &table) const;
+
+private:
+    memory_mapped_file _file;
+    const uint32_t* _keys = nullptr;
+    const uint16_t* _equities = nullptr;
+    size_t _num_of_entries = 0;
+};
+
+} // end of namespace poker_lib
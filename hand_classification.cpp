@@ -0,0 +1,200 @@
+#include <array>
+#include <bitset>
+
+#include "hand_classification.h"
+
+#define HANDLE_HAND_CLASS_NAME(name) case poker_lib::hand_class::name: return os << #name;
+
+namespace poker_lib {
+
+std::ostream& operator<<(std::ostream &os, const hand_class value)
+{
+    switch (value)
+    {
+    HANDLE_HAND_CLASS_NAME(high_card);
+    HANDLE_HAND_CLASS_NAME(pair);
+    HANDLE_HAND_CLASS_NAME(two_pair);
+    HANDLE_HAND_CLASS_NAME(three_of_a_kind);
+    HANDLE_HAND_CLASS_NAME(straight);
+    HANDLE_HAND_CLASS_NAME(flush);
+    HANDLE_HAND_CLASS_NAME(full_house);
+    HANDLE_HAND_CLASS_NAME(four_of_a_kind);
+    HANDLE_HAND_CLASS_NAME(straight_flush);
+    }
+
+    return os << "unknown";
+}
+
+constexpr size_t num_of_ranks = 13;
+constexpr size_t num_of_suits = 4;
+
+// Bit N of a suit's mask is set if the card of rank N is in the set
+using suit_rank_masks = std::array<uint16_t, num_of_suits>;
+
+static suit_rank_masks get_suit_rank_masks(const uint64_t card_mask)
+{
+    suit_rank_masks result{};
+    for (size_t rank = 0; rank < num_of_ranks; ++rank)
+    {
+        for (size_t suit = 0; suit < num_of_suits; ++suit)
+        {
+            result[suit] |= static_cast<uint16_t>(((card_mask >> (num_of_suits * rank + suit)) & 1) << rank);
+        }
+    }
+    return result;
+}
+
+static uint64_t get_rank_cards(const size_t rank)
+{
+    return uint64_t{0xf} << (num_of_suits * rank);
+}
+
+static uint64_t get_suit_cards(const size_t suit)
+{
+    // Every fourth card starting from the suit
+    return uint64_t{0x1111111111111} << suit;
+}
+
+static size_t count_bits(const uint64_t mask)
+{
+    return std::bitset<64>(mask).count();
+}
+
+// Ranks shifted up by one with the ace also below the deuce, as straights see them
+static uint32_t get_ace_low_ranks(const uint16_t ranks)
+{
+    return (static_cast<uint32_t>(ranks) << 1) | ((ranks >> (num_of_ranks - 1)) & 1);
+}
+
+static bool has_straight(const uint16_t ranks)
+{
+    const auto mask = get_ace_low_ranks(ranks);
+    return mask & (mask >> 1) & (mask >> 2) & (mask >> 3) & (mask >> 4);
+}
+
+static bool has_open_ended_straight_draw(const uint16_t hand_ranks, const uint16_t completing_ranks)
+{
+    const auto ranks = get_ace_low_ranks(hand_ranks);
+    const auto completing = get_ace_low_ranks(completing_ranks);
+    // Runs from 2345 to TJQK have a rank on both ends
+    for (size_t lowest = 1; lowest + 4 <= num_of_ranks; ++lowest)
+    {
+        const uint32_t run = uint32_t{0xf} << lowest;
+        const uint32_t ends = (uint32_t{1} << (lowest - 1)) | (uint32_t{1} << (lowest + 4));
+        if ((ranks & run) == run && (completing & ends) == ends)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static hand_class get_made_hand(const suit_rank_masks &suits)
+{
+    // Bit N of at_least[K] is set if there are more than K cards of rank N
+    std::array<uint16_t, num_of_suits> at_least{};
+    for (const auto ranks : suits)
+    {
+        for (auto count = num_of_suits - 1; count > 0; --count)
+        {
+            at_least[count] |= at_least[count - 1] & ranks;
+        }
+        at_least[0] |= ranks;
+    }
+
+    bool has_flush = false;
+    for (const auto ranks : suits)
+    {
+        if (count_bits(ranks) >= 5)
+        {
+            if (has_straight(ranks))
+            {
+                return hand_class::straight_flush;
+            }
+            has_flush = true;
+        }
+    }
+
+    if (at_least[3])
+    {
+        return hand_class::four_of_a_kind;
+    }
+    if (at_least[2] && count_bits(at_least[1]) >= 2)
+    {
+        return hand_class::full_house;
+    }
+    if (has_flush)
+    {
+        return hand_class::flush;
+    }
+    if (has_straight(at_least[0]))
+    {
+        return hand_class::straight;
+    }
+    if (at_least[2])
+    {
+        return hand_class::three_of_a_kind;
+    }
+    if (at_least[1])
+    {
+        return count_bits(at_least[1]) >= 2 ? hand_class::two_pair : hand_class::pair;
+    }
+    return hand_class::high_card;
+}
+
+hand_classification classify_hand(const uint64_t pocket_mask, const uint64_t board_mask, const uint64_t dead_mask)
+{
+    const auto hand_suits = get_suit_rank_masks(pocket_mask | board_mask);
+
+    hand_classification result;
+    result.made_hand = get_made_hand(hand_suits);
+
+    const auto num_of_board_cards = count_bits(board_mask);
+    if (num_of_board_cards < 3 || num_of_board_cards > 4)
+    {
+        return result;
+    }
+
+    const auto unseen_cards = ~(pocket_mask | board_mask | dead_mask) & ((uint64_t{1} << 52) - 1);
+    const auto pocket_suits = get_suit_rank_masks(pocket_mask);
+
+    uint64_t flush_outs = 0;
+    for (size_t suit = 0; suit < num_of_suits && result.made_hand < hand_class::flush; ++suit)
+    {
+        if (count_bits(hand_suits[suit]) == 4 && pocket_suits[suit])
+        {
+            result.has_flush_draw = true;
+            flush_outs |= get_suit_cards(suit) & unseen_cards;
+        }
+    }
+
+    uint64_t straight_outs = 0;
+    if (result.made_hand < hand_class::straight)
+    {
+        const auto hand_ranks = static_cast<uint16_t>(hand_suits[0] | hand_suits[1] | hand_suits[2] | hand_suits[3]);
+        const auto board_suits = get_suit_rank_masks(board_mask);
+        const auto board_ranks = static_cast<uint16_t>(board_suits[0] | board_suits[1] | board_suits[2] | board_suits[3]);
+
+        uint16_t completing_ranks = 0;
+        for (size_t rank = 0; rank < num_of_ranks; ++rank)
+        {
+            const auto rank_bit = static_cast<uint16_t>(1u << rank);
+            if (!(hand_ranks & rank_bit) &&
+                has_straight(hand_ranks | rank_bit) &&
+                !has_straight(board_ranks | rank_bit))
+            {
+                completing_ranks |= rank_bit;
+                straight_outs |= get_rank_cards(rank) & unseen_cards;
+            }
+        }
+        result.has_open_ended_straight_draw = has_open_ended_straight_draw(hand_ranks, completing_ranks);
+        result.has_gutshot = completing_ranks && !result.has_open_ended_straight_draw;
+    }
+
+    result.num_of_flush_outs = count_bits(flush_outs);
+    result.num_of_straight_outs = count_bits(straight_outs);
+    result.num_of_outs = count_bits(flush_outs | straight_outs);
+    return result;
+}
+
+} // end of namespace poker_lib
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace poker_lib {
+
+// Same order and values as the categories of batch_hand_evaluator's hand values
+enum class hand_class
+{
+    high_card,
+    pair,
+    two_pair,
+    three_of_a_kind,
+    straight,
+    flush,
+    full_house,
+    four_of_a_kind,
+    straight_flush,
+};
+std::ostream& operator<<(std::ostream &os, hand_class value);
+
+// Draws only count if they use at least one pocket card and only before the river
+struct hand_classification
+{
+    hand_class made_hand = hand_class::high_card;
+
+    bool has_flush_draw = false;
+    // Four consecutive ranks completed at either end make an open-ended straight draw. Any other straight draw is a
+    // gutshot, a double gutshot with two completing ranks as well.
+    bool has_open_ended_straight_draw = false;
+    bool has_gutshot = false;
+
+    size_t num_of_flush_outs = 0;
+    size_t num_of_straight_outs = 0;
+    // Unseen cards completing any of the draws, a card completing both is counted once
+    size_t num_of_outs = 0;
+};
+
+// Cards are OMPEval card masks like the ones given to the equity calculations. Dead cards aren't outs.
+hand_classification classify_hand(uint64_t pocket_mask, uint64_t board_mask, uint64_t dead_mask = 0);
+
+} // end of namespace poker_lib
@@ -0,0 +1,493 @@
+#include <omp/CardRange.h>
+#include <omp/Util.h>
+#include <algorithm>
+#include <stdexcept>
+
+#include "hand_indexer.h"
+
+namespace poker_lib {
+
+constexpr uint32_t num_of_ranks = 13;
+constexpr uint32_t num_of_suits = 4;
+
+// Binomial coefficients of up to 13 ranks
+static const auto rank_binomials = []()
+{
+    std::array<std::array<uint32_t, num_of_ranks + 1>, num_of_ranks + 1> result{};
+    for (uint32_t n = 0; n <= num_of_ranks; ++n)
+    {
+        result[n][0] = 1;
+        for (uint32_t k = 1; k <= n; ++k)
+        {
+            result[n][k] = result[n - 1][k - 1] + result[n - 1][k];
+        }
+    }
+    return result;
+}();
+
+// Tables of 13 bit rank sets so indexing a suit's ranks doesn't loop over its cards
+struct rank_set_lookup_tables
+{
+    std::array<uint8_t, 1u << num_of_ranks> sizes{};
+    // Sum of binomial(position, n) over the set's ranks, the n-th lowest one at position
+    std::array<uint16_t, 1u << num_of_ranks> colex_indices{};
+    // Ranks of a set moved down to their positions among the free ranks, the lower 7 and the upper 6 ranks separately
+    std::array<std::array<uint8_t, 128>, 128> low_compactions{};
+    std::array<std::array<uint8_t, 64>, 64> high_compactions{};
+
+    rank_set_lookup_tables()
+    {
+        for (uint32_t rank_set = 0; rank_set < sizes.size(); ++rank_set)
+        {
+            for (uint32_t rank = 0, size = 0; rank < num_of_ranks; ++rank)
+            {
+                if (rank_set & (1u << rank))
+                {
+                    colex_indices[rank_set] += static_cast<uint16_t>(rank_binomials[rank][++size]);
+                    sizes[rank_set] = static_cast<uint8_t>(size);
+                }
+            }
+        }
+
+        const auto compact = [](const uint32_t rank_set, const uint32_t free_ranks)
+        {
+            uint32_t result = 0;
+            for (uint32_t rank = 0, position = 0; rank < num_of_ranks; ++rank)
+            {
+                if (free_ranks & (1u << rank))
+                {
+                    result |= ((rank_set >> rank) & 1u) << position++;
+                }
+            }
+            return static_cast<uint8_t>(result);
+        };
+        for (uint32_t rank_set = 0; rank_set < 128; ++rank_set)
+        {
+            for (uint32_t free_ranks = 0; free_ranks < 128; ++free_ranks)
+            {
+                low_compactions[rank_set][free_ranks] = compact(rank_set, free_ranks);
+                if (rank_set < 64 && free_ranks < 64)
+                {
+                    high_compactions[rank_set][free_ranks] = compact(rank_set, free_ranks);
+                }
+            }
+        }
+    }
+
+    // Index of rank_set among the sets of its size chosen from free_ranks
+    uint32_t get_index(const uint32_t rank_set, const uint32_t free_ranks) const
+    {
+        const auto compacted = low_compactions[rank_set & 127][free_ranks & 127] |
+                               (high_compactions[rank_set >> 7][free_ranks >> 7] << sizes[free_ranks & 127]);
+        return colex_indices[compacted];
+    }
+};
+static const rank_set_lookup_tables rank_set_tables;
+
+// Constant divisors up to 4 elements so the hot path doesn't divide
+static uint64_t get_binomial(const uint64_t n, const uint64_t k)
+{
+    switch (k)
+    {
+    case 0: return 1;
+    case 1: return n;
+    // A factor is 0 if n < k
+    case 2: return n * (n - 1) / 2;
+    case 3: return n * (n - 1) * (n - 2) / 6;
+    case 4: return n * (n - 1) * (n - 2) * (n - 3) / 24;
+    }
+
+    if (n < k)
+    {
+        return 0;
+    }
+    uint64_t result = 1;
+    for (uint64_t index = 0; index < k; ++index)
+    {
+        result = result * (n - index) / (index + 1);
+    }
+    return result;
+}
+
+// Number of multisets of k elements out of n
+static uint64_t get_num_of_multisets(const uint64_t n, const uint64_t k)
+{
+    return get_binomial(n + k - 1, k);
+}
+
+// Largest y with get_binomial(y, k) <= rank
+static uint64_t find_binomial_root(const uint64_t rank, const uint64_t k, uint64_t low, uint64_t high)
+{
+    while (low < high)
+    {
+        const auto middle = low + (high - low + 1) / 2;
+        if (get_binomial(middle, k) <= rank) { low = middle; } else { high = middle - 1; }
+    }
+    return low;
+}
+
+// Rank of the first three count vectors, sorted in decreasing order, as a multiset. The last one is the rest of the
+// cards of every round, so it's left out to keep the table of positions small.
+static uint32_t get_configuration_key(const std::array<uint32_t, 4> &count_vectors)
+{
+    return static_cast<uint32_t>(get_binomial(count_vectors[0] + 2, 3) + get_binomial(count_vectors[1] + 1, 2) + count_vectors[2]);
+}
+
+namespace {
+
+// Cards per round as template constants, so the compiler unrolls the loops over the rounds and their cards
+template <uint8_t... CardsPerRound>
+struct fixed_round_layout
+{
+    fixed_round_layout(const std::vector<uint8_t>&, const std::array<uint32_t, max_num_of_indexed_rounds>&) {}
+
+    static constexpr size_t get_num_of_rounds() { return sizeof...(CardsPerRound); }
+    static constexpr uint32_t get_num_of_cards(const size_t round)
+    {
+        constexpr std::array<uint8_t, sizeof...(CardsPerRound)> cards_per_round{CardsPerRound...};
+        return cards_per_round[round];
+    }
+    static constexpr uint32_t get_count_vector_radix(const size_t round)
+    {
+        uint32_t radix = 1;
+        for (size_t earlier_round = 0; earlier_round < round; ++earlier_round)
+        {
+            radix *= get_num_of_cards(earlier_round) + 1;
+        }
+        return radix;
+    }
+};
+
+class any_round_layout
+{
+public:
+    any_round_layout(const std::vector<uint8_t> &cards_per_round, const std::array<uint32_t, max_num_of_indexed_rounds> &count_vector_radices)
+    :
+        _cards_per_round(cards_per_round),
+        _count_vector_radices(count_vector_radices)
+    {
+    }
+
+    size_t get_num_of_rounds() const { return _cards_per_round.size(); }
+    uint32_t get_num_of_cards(const size_t round) const { return _cards_per_round[round]; }
+    uint32_t get_count_vector_radix(const size_t round) const { return _count_vector_radices[round]; }
+
+private:
+    const std::vector<uint8_t> &_cards_per_round;
+    const std::array<uint32_t, max_num_of_indexed_rounds> &_count_vector_radices;
+};
+
+} // end of anonymous namespace
+
+hand_indexer::hand_indexer(std::vector<uint8_t> cards_per_round)
+:
+    _cards_per_round(std::move(cards_per_round))
+{
+    if (_cards_per_round.empty() || _cards_per_round.size() > max_num_of_indexed_rounds ||
+        std::find(_cards_per_round.begin(), _cards_per_round.end(), 0) != _cards_per_round.end())
+    {
+        throw std::invalid_argument("Hand indexer needs 1 to 4 rounds with at least one card each");
+    }
+    for (const auto num_of_cards : _cards_per_round)
+    {
+        _num_of_cards += num_of_cards;
+    }
+    if (_num_of_cards > max_num_of_indexed_cards)
+    {
+        throw std::invalid_argument("Hand indexer supports at most 7 cards");
+    }
+
+    _num_of_count_vectors = 1;
+    for (size_t round = 0; round < _cards_per_round.size(); ++round)
+    {
+        _count_vector_radices[round] = _num_of_count_vectors;
+        _num_of_count_vectors *= _cards_per_round[round] + 1u;
+    }
+
+    _suit_sizes.assign(_num_of_count_vectors, 0);
+    for (uint32_t count_vector = 0; count_vector < _num_of_count_vectors; ++count_vector)
+    {
+        uint64_t suit_size = 1;
+        uint32_t num_of_used_ranks = 0;
+        for (size_t round = 0; round < _cards_per_round.size(); ++round)
+        {
+            const auto count = count_vector / _count_vector_radices[round] % (_cards_per_round[round] + 1u);
+            suit_size *= rank_binomials[num_of_ranks - num_of_used_ranks][count];
+            num_of_used_ranks += count;
+        }
+        _suit_sizes[count_vector] = suit_size;
+    }
+
+    if (_cards_per_round == std::vector<uint8_t>{2}) { _get_index = &hand_indexer::get_layout_index<fixed_round_layout<2>>; }
+    else if (_cards_per_round == std::vector<uint8_t>{2, 3}) { _get_index = &hand_indexer::get_layout_index<fixed_round_layout<2, 3>>; }
+    else if (_cards_per_round == std::vector<uint8_t>{2, 3, 1}) { _get_index = &hand_indexer::get_layout_index<fixed_round_layout<2, 3, 1>>; }
+    else if (_cards_per_round == std::vector<uint8_t>{2, 3, 1, 1}) { _get_index = &hand_indexer::get_layout_index<fixed_round_layout<2, 3, 1, 1>>; }
+    else { _get_index = &hand_indexer::get_layout_index<any_round_layout>; }
+
+    // Every sorted combination of the suits' count vectors dealing the right number of cards per round
+    _configuration_positions.assign(get_num_of_multisets(_num_of_count_vectors, num_of_suits - 1), 0);
+    std::array<uint32_t, 4> count_vectors{};
+    for (count_vectors[0] = 0; count_vectors[0] < _num_of_count_vectors; ++count_vectors[0])
+    for (count_vectors[1] = 0; count_vectors[1] <= count_vectors[0]; ++count_vectors[1])
+    for (count_vectors[2] = 0; count_vectors[2] <= count_vectors[1]; ++count_vectors[2])
+    for (count_vectors[3] = 0; count_vectors[3] <= count_vectors[2]; ++count_vectors[3])
+    {
+        bool is_valid = true;
+        for (size_t round = 0; round < _cards_per_round.size(); ++round)
+        {
+            uint32_t num_of_cards = 0;
+            for (const auto count_vector : count_vectors)
+            {
+                num_of_cards += count_vector / _count_vector_radices[round] % (_cards_per_round[round] + 1u);
+            }
+            is_valid = is_valid && num_of_cards == _cards_per_round[round];
+        }
+        if (!is_valid)
+        {
+            continue;
+        }
+
+        // Groups of suits with the same count vector are digits of a mixed radix, the first one the most significant
+        configuration config{_size, count_vectors, {}, {}};
+        uint64_t config_size = 1;
+        for (size_t last = num_of_suits; last > 0;)
+        {
+            auto first = last - 1;
+            while (first > 0 && count_vectors[first - 1] == count_vectors[last - 1]) { --first; }
+            for (auto suit = first; suit < last; ++suit)
+            {
+                config.num_of_remaining_suits[suit] = static_cast<uint8_t>(last - suit);
+                config.multipliers[suit] = config_size;
+            }
+            config_size *= get_num_of_multisets(_suit_sizes[count_vectors[first]], last - first);
+            last = first;
+        }
+
+        _configuration_positions[get_configuration_key(count_vectors)] = static_cast<uint16_t>(_configurations.size());
+        _configurations.emplace_back(config);
+        _size += config_size;
+    }
+}
+
+template <typename LayoutT>
+uint64_t hand_indexer::get_layout_index(const indexed_cards &cards) const
+{
+    const LayoutT layout(_cards_per_round, _count_vector_radices);
+
+    // Bit N is set if the card of rank N and the suit was dealt in the round
+    std::array<std::array<uint32_t, num_of_suits>, max_num_of_indexed_rounds> rank_sets{};
+    for (size_t round = 0, card = 0; round < layout.get_num_of_rounds(); ++round)
+    {
+        for (const auto end = card + layout.get_num_of_cards(round); card < end; ++card)
+        {
+            rank_sets[round][cards[card] % num_of_suits] |= 1u << (cards[card] / num_of_suits);
+        }
+    }
+
+    // A suit's ranks of a round are ranked among the ranks its earlier rounds left, round indices in a mixed radix.
+    // Suits are independent so the inner loop goes over them.
+    // The first round has every rank free so its ranks don't need to be compacted.
+    std::array<uint32_t, num_of_suits> free_ranks{};
+    std::array<uint32_t, num_of_suits> num_of_free_ranks{};
+    std::array<uint32_t, num_of_suits> count_vectors{};
+    // A suit's index is below binomial(13, 7) * 6! so it fits
+    std::array<uint32_t, num_of_suits> suit_indices{};
+    std::array<uint32_t, num_of_suits> multipliers{};
+    for (uint32_t suit = 0; suit < num_of_suits; ++suit)
+    {
+        const auto rank_set = rank_sets[0][suit];
+        const auto count = rank_set_tables.sizes[rank_set];
+        suit_indices[suit] = rank_set_tables.colex_indices[rank_set];
+        multipliers[suit] = rank_binomials[num_of_ranks][count];
+        count_vectors[suit] = count;
+        free_ranks[suit] = ((1u << num_of_ranks) - 1) & ~rank_set;
+        num_of_free_ranks[suit] = num_of_ranks - count;
+    }
+    for (size_t round = 1, card = layout.get_num_of_cards(0); round < layout.get_num_of_rounds(); card += layout.get_num_of_cards(round++))
+    {
+        // Like the turn and the river. The other suits' indices stay the same and the card's index among the free ranks
+        // is the number of free ranks below it.
+        if (layout.get_num_of_cards(round) == 1)
+        {
+            const auto suit = cards[card] % num_of_suits;
+            const auto rank_set = 1u << (cards[card] / num_of_suits);
+            suit_indices[suit] += rank_set_tables.sizes[free_ranks[suit] & (rank_set - 1)] * multipliers[suit];
+            multipliers[suit] *= num_of_free_ranks[suit];
+            count_vectors[suit] += layout.get_count_vector_radix(round);
+            free_ranks[suit] &= ~rank_set;
+            --num_of_free_ranks[suit];
+            continue;
+        }
+
+        for (uint32_t suit = 0; suit < num_of_suits; ++suit)
+        {
+            const auto rank_set = rank_sets[round][suit];
+            const auto count = rank_set_tables.sizes[rank_set];
+            suit_indices[suit] += rank_set_tables.get_index(rank_set, free_ranks[suit]) * multipliers[suit];
+            multipliers[suit] *= rank_binomials[num_of_free_ranks[suit]][count];
+            count_vectors[suit] += count * layout.get_count_vector_radix(round);
+            free_ranks[suit] &= ~rank_set;
+            num_of_free_ranks[suit] -= count;
+        }
+    }
+
+    std::array<uint64_t, num_of_suits> suit_keys{};
+    for (uint32_t suit = 0; suit < num_of_suits; ++suit)
+    {
+        suit_keys[suit] = (uint64_t{count_vectors[suit]} << 40) | suit_indices[suit];
+    }
+
+    // Sorting network putting the keys in decreasing order
+    const auto sort_pair = [&suit_keys](const size_t first, const size_t second)
+    {
+        const auto high = std::max(suit_keys[first], suit_keys[second]);
+        suit_keys[second] = std::min(suit_keys[first], suit_keys[second]);
+        suit_keys[first] = high;
+    };
+    sort_pair(0, 1);
+    sort_pair(2, 3);
+    sort_pair(0, 2);
+    sort_pair(1, 3);
+    sort_pair(1, 2);
+
+    for (uint32_t suit = 0; suit < num_of_suits; ++suit)
+    {
+        count_vectors[suit] = static_cast<uint32_t>(suit_keys[suit] >> 40);
+    }
+
+    // Suits with the same count vector are interchangeable so their indices are ranked as a multiset
+    const auto &config = _configurations[_configuration_positions[get_configuration_key(count_vectors)]];
+    auto index = config.offset;
+    for (uint32_t suit = 0; suit < num_of_suits; ++suit)
+    {
+        const uint64_t num_of_remaining_suits = config.num_of_remaining_suits[suit];
+        const auto suit_index = suit_keys[suit] & ((uint64_t{1} << 40) - 1);
+        index += get_binomial(suit_index + num_of_remaining_suits - 1, num_of_remaining_suits) * config.multipliers[suit];
+    }
+    return index;
+}
+
+indexed_cards hand_indexer::get_cards(uint64_t index) const
+{
+    if (index >= _size)
+    {
+        throw std::invalid_argument("Hand index " + std::to_string(index) + " is out of range");
+    }
+
+    const auto config = std::prev(std::upper_bound(_configurations.begin(), _configurations.end(), index,
+                                                   [](const uint64_t index, const configuration &config){ return index < config.offset; }));
+    index -= config->offset;
+    const auto &count_vectors = config->count_vectors;
+
+    // Groups were combined with the first one as the most significant digit
+    std::array<uint64_t, num_of_suits> suit_indices{};
+    for (uint32_t last = num_of_suits; last > 0;)
+    {
+        auto first = last - 1;
+        while (first > 0 && count_vectors[first - 1] == count_vectors[last - 1]) { --first; }
+
+        const auto suit_size = _suit_sizes[count_vectors[first]];
+        const auto num_of_multisets = get_num_of_multisets(suit_size, last - first);
+        auto group_index = index % num_of_multisets;
+        index /= num_of_multisets;
+
+        for (auto suit = first; suit < last; ++suit)
+        {
+            const uint64_t remaining = last - suit;
+            const auto root = find_binomial_root(group_index, remaining, remaining - 1, suit_size + remaining - 2);
+            group_index -= get_binomial(root, remaining);
+            suit_indices[suit] = root - (remaining - 1);
+        }
+        last = first;
+    }
+
+    // Sorted suits are dealt as suits 0 to 3
+    std::array<std::array<uint32_t, num_of_suits>, max_num_of_indexed_rounds> rank_sets{};
+    for (uint32_t suit = 0; suit < num_of_suits; ++suit)
+    {
+        uint32_t used_ranks = 0;
+        auto suit_index = suit_indices[suit];
+        for (size_t round = 0; round < _cards_per_round.size(); ++round)
+        {
+            const auto count = count_vectors[suit] / _count_vector_radices[round] % (_cards_per_round[round] + 1u);
+            const auto num_of_free_ranks = num_of_ranks - omp::bitCount(used_ranks);
+            const auto size = rank_binomials[num_of_free_ranks][count];
+            auto round_index = static_cast<uint32_t>(suit_index % size);
+            suit_index /= size;
+
+            // Positions among the free ranks from the highest one down
+            uint32_t rank_set = 0;
+            auto position = num_of_free_ranks;
+            for (auto num_of_lower_cards = count; num_of_lower_cards > 0; --num_of_lower_cards)
+            {
+                do { --position; } while (rank_binomials[position][num_of_lower_cards] > round_index);
+                round_index -= rank_binomials[position][num_of_lower_cards];
+
+                uint32_t rank = 0;
+                for (uint32_t free_ranks = 0; free_ranks <= position; ++rank)
+                {
+                    free_ranks += !(used_ranks & (1u << rank));
+                }
+                rank_set |= 1u << (rank - 1);
+            }
+            rank_sets[round][suit] = rank_set;
+            used_ranks |= rank_set;
+        }
+    }
+
+    indexed_cards result{};
+    for (size_t round = 0, card = 0; round < _cards_per_round.size(); ++round)
+    {
+        const auto first_card = card;
+        for (uint32_t suit = 0; suit < num_of_suits; ++suit)
+        {
+            for (uint32_t rank = 0; rank < num_of_ranks; ++rank)
+            {
+                if (rank_sets[round][suit] & (1u << rank))
+                {
+                    result[card++] = static_cast<uint8_t>(rank * num_of_suits + suit);
+                }
+            }
+        }
+        std::sort(result.begin() + first_card, result.begin() + card);
+    }
+    return result;
+}
+
+uint64_t get_isomorphism_class(const std::string &pocket_cards, const std::string &communal_cards)
+{
+    static const std::array<hand_indexer, 4> indexers{hand_indexer({2}), hand_indexer({2, 3}), hand_indexer({2, 3, 1}), hand_indexer({2, 3, 1, 1})};
+
+    const auto pocket_mask = omp::CardRange::getCardMask(pocket_cards);
+    const auto communal_mask = omp::CardRange::getCardMask(communal_cards);
+    const auto num_of_communal_cards = omp::bitCount(communal_mask);
+    if (omp::bitCount(pocket_mask) != 2 || (pocket_mask & communal_mask) || num_of_communal_cards == 1 ||
+        num_of_communal_cards == 2 || num_of_communal_cards > 5)
+    {
+        throw std::invalid_argument("Cannot index pocket cards " + pocket_cards + " with communal cards " + communal_cards);
+    }
+
+    // The turn and the river are separate rounds so communal cards are taken in the order of the string
+    indexed_cards cards{};
+    size_t num_of_cards = 0;
+    for (uint8_t card = 0; card < 52; ++card)
+    {
+        if (pocket_mask & (uint64_t{1} << card)) { cards[num_of_cards++] = card; }
+    }
+    for (size_t offset = 0; offset < communal_cards.size(); ++offset)
+    {
+        if (communal_cards[offset] == ' ')
+        {
+            continue;
+        }
+        const auto card_mask = omp::CardRange::getCardMask(communal_cards.substr(offset++, 2));
+        for (uint8_t card = 0; card < 52; ++card)
+        {
+            if (card_mask & (uint64_t{1} << card)) { cards[num_of_cards++] = card; }
+        }
+    }
+
+    return indexers[num_of_communal_cards == 0 ? 0 : num_of_communal_cards - 2].get_index(cards);
+}
+
+} // end of namespace poker_lib
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace poker_lib {
+
+constexpr size_t max_num_of_indexed_cards = 7;
+constexpr size_t max_num_of_indexed_rounds = 4;
+
+// Cards are indexed like in OMPEval, ordered by round. Entries after the indexer's number of cards are ignored.
+using indexed_cards = std::array<uint8_t, max_num_of_indexed_cards>;
+
+// Bijective index of the cards dealt in rounds, e.g. the pocket cards then the flop, up to suit isomorphism: hands
+// that only differ by a permutation of the suits get the same index and indices go from 0 to size() - 1 without gaps.
+// Follows Kevin Waugh's hand isomorphism indexer. Every suit's ranks per round are ranked in the combinatorial number
+// system, suits are sorted by their counts and ranks, then the suits with equal counts are ranked as a multiset.
+// Indexing a hand takes a few table lookups per card, suit and round without allocations. The layouts of
+// get_isomorphism_class are compiled for their cards per round, so the loops over the rounds and cards unroll.
+class hand_indexer
+{
+public:
+    // E.g. {2} pre-flop, {2, 3} on the flop, {2, 3, 1} on the turn and {2, 3, 1, 1} on the river. Throws if there are
+    // more rounds or cards than max_num_of_indexed_rounds and max_num_of_indexed_cards or a round without a card.
+    explicit hand_indexer(std::vector<uint8_t> cards_per_round);
+
+    size_t get_num_of_cards() const { return _num_of_cards; }
+    // Number of isomorphism classes, e.g. 169 pre-flop and 1286792 on the flop
+    uint64_t size() const { return _size; }
+
+    // Cards must differ and the order within a round doesn't matter
+    uint64_t get_index(const indexed_cards &cards) const { return (this->*_get_index)(cards); }
+    // Canonical representative of the index's class with the cards of every round in increasing order. Throws if
+    // the index is out of range.
+    indexed_cards get_cards(uint64_t index) const;
+
+private:
+    // Suits sorted by count vector then ranks have the same number of cards per round
+    struct configuration
+    {
+        uint64_t offset = 0;
+        std::array<uint32_t, 4> count_vectors{};
+        // Suits in the group of the sorted suit from it on and the group's weight in the index
+        std::array<uint8_t, 4> num_of_remaining_suits{};
+        std::array<uint64_t, 4> multipliers{};
+    };
+
+    // Rounds and their cards are template constants for the known layouts and read from the indexer for the others
+    template <typename LayoutT>
+    uint64_t get_layout_index(const indexed_cards &cards) const;
+    using index_function = uint64_t (hand_indexer::*)(const indexed_cards&) const;
+
+    std::vector<uint8_t> _cards_per_round;
+    index_function _get_index = nullptr;
+    size_t _num_of_cards = 0;
+    // A suit's count vector is its number of cards per round in a mixed radix
+    std::array<uint32_t, max_num_of_indexed_rounds> _count_vector_radices{};
+    uint32_t _num_of_count_vectors = 0;
+    // Ways to choose a suit's ranks of each round for each count vector
+    std::vector<uint64_t> _suit_sizes;
+    std::vector<configuration> _configurations;
+    // Position in _configurations by configuration key, small enough to stay in the cache. There are a few hundred
+    // configurations at most.
+    std::vector<uint16_t> _configuration_positions;
+    uint64_t _size = 0;
+};
+
+// Index of the pocket cards and the communal cards with the indexer of as many rounds as the board has. Both are in
+// OMPEval's format, e.g. "As Kd" and "Qh Jh Th". Throws unless there are 2 pocket cards and 0, 3, 4 or 5 different
+// communal cards.
+uint64_t get_isomorphism_class(const std::string &pocket_cards, const std::string &communal_cards);
+
+} // end of namespace poker_lib
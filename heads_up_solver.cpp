@@ -0,0 +1,675 @@
+#include <omp/CardRange.h>
+#include <omp/HandEvaluator.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "heads_up_solver.h"
+
+namespace poker_lib {
+
+//
+// Information sets
+//
+
+// Betting history is a sequence of 2-bit codes after a leading 1 bit. Streets are separated by a dedicated code.
+constexpr uint64_t empty_history = 1;
+constexpr uint64_t street_separator_code = 3;
+constexpr size_t history_shift = 10;
+
+static uint64_t append_to_history(const uint64_t history, const uint64_t code)
+{
+    return (history << 2) | code;
+}
+
+static uint64_t make_information_set_key(const size_t street, const size_t bucket, const uint64_t history)
+{
+    return (history << history_shift) | (static_cast<uint64_t>(bucket) << 2) | street;
+}
+
+//
+// Card abstraction
+//
+
+// Chen formula scaled into 8 buckets
+static size_t get_pre_flop_bucket(const unsigned card_1, const unsigned card_2)
+{
+    const auto high_rank = std::max(card_1 / 4, card_2 / 4);
+    const auto low_rank = std::min(card_1 / 4, card_2 / 4);
+
+    // Ranks are 0 based from deuce, points are doubled to stay in integers
+    auto get_points = [](const unsigned rank){ return rank == 12 ? 20u : rank == 11 ? 16u : rank == 10 ? 14u : rank == 9 ? 12u : rank + 2; };
+
+    int score = static_cast<int>(get_points(high_rank));
+    if (high_rank == low_rank)
+    {
+        score = std::max(10, 2 * score);
+    }
+    else
+    {
+        const auto gap = high_rank - low_rank - 1;
+        score -= gap == 0 ? 0 : gap == 1 ? 2 : gap == 2 ? 4 : gap == 3 ? 8 : 10;
+        if (gap <= 1 && high_rank < 10)
+        {
+            score += 2;
+        }
+    }
+    if (card_1 % 4 == card_2 % 4)
+    {
+        score += 4;
+    }
+
+    // Doubled Chen scores are between -2 and 40
+    return static_cast<size_t>(std::clamp(score + 2, 0, 41) * 8 / 42);
+}
+
+static size_t get_card_bucket(const omp::HandEvaluator &evaluator, const uint64_t pocket_mask, const uint64_t board_mask)
+{
+    std::array<unsigned, 2> pocket{};
+    omp::Hand board = omp::Hand::empty();
+    size_t pocket_count = 0;
+    for (unsigned card = 0; card < 52; ++card)
+    {
+        if ((pocket_mask >> card) & 1)
+        {
+            pocket.at(pocket_count++) = card;
+        }
+        if ((board_mask >> card) & 1)
+        {
+            board += omp::Hand(card);
+        }
+    }
+
+    if (board_mask == 0)
+    {
+        return get_pre_flop_bucket(pocket[0], pocket[1]);
+    }
+
+    // Hand category and whether pocket cards improve on what the board makes on its own
+    const auto hand = board + omp::Hand(pocket[0]) + omp::Hand(pocket[1]);
+    const auto hand_category = evaluator.evaluate(hand) >> omp::HAND_CATEGORY_SHIFT;
+    const auto board_category = evaluator.evaluate(board) >> omp::HAND_CATEGORY_SHIFT;
+    return 8 + 2 * hand_category + (hand_category > board_category ? 1 : 0);
+}
+
+//
+// Betting abstraction
+//
+
+struct abstract_betting_state
+{
+    size_t street = 0;
+    // Player 0 is the dealer who posts the small blind
+    size_t acting_player = 0;
+    std::array<uint64_t, 2> contributions{};
+    uint64_t raises = 0;
+    uint64_t actions = 0;
+    uint64_t history = empty_history;
+    int folded_player = -1;
+    bool is_showdown = false;
+
+    bool is_terminal() const { return folded_player >= 0 || is_showdown; }
+};
+
+class abstract_game
+{
+public:
+    explicit abstract_game(const heads_up_abstraction &abstraction) : _abstraction(abstraction) {}
+
+    abstract_betting_state get_initial_state() const
+    {
+        abstract_betting_state state;
+        state.contributions = {_abstraction.small_blind_size, _abstraction.big_blind_size};
+        return state;
+    }
+
+    std::array<bool, num_of_abstract_actions> get_legal_actions(const abstract_betting_state &state) const
+    {
+        const auto acting = state.acting_player;
+        const auto to_call = get_amount_to_call(state);
+        const bool may_raise = state.raises < _abstraction.max_raises_per_street &&
+                               get_stack_left(state, acting) > to_call &&
+                               get_stack_left(state, 1 - acting) > 0;
+        return {to_call > 0, true, may_raise};
+    }
+
+    abstract_betting_state apply(abstract_betting_state state, const abstract_action action) const
+    {
+        const auto acting = state.acting_player;
+        const auto to_call = get_amount_to_call(state);
+
+        state.history = append_to_history(state.history, static_cast<uint64_t>(action));
+        ++state.actions;
+
+        if (action == abstract_action::fold)
+        {
+            state.folded_player = static_cast<int>(acting);
+            return state;
+        }
+
+        if (action == abstract_action::raise)
+        {
+            const auto pot = state.contributions[0] + state.contributions[1];
+            auto raise = std::max(static_cast<uint64_t>((pot + to_call) * _abstraction.raise_pot_ratio), _abstraction.big_blind_size);
+            raise = std::min({raise, get_stack_left(state, acting) - to_call, get_stack_left(state, 1 - acting)});
+
+            state.contributions[acting] += to_call + raise;
+            ++state.raises;
+            state.acting_player = 1 - acting;
+            return state;
+        }
+
+        state.contributions[acting] += std::min(to_call, get_stack_left(state, acting));
+
+        const bool is_all_in = get_stack_left(state, 0) == 0 || get_stack_left(state, 1) == 0;
+        const bool is_betting_closed = state.actions >= 2 && state.contributions[0] == state.contributions[1];
+        if (!is_all_in && !is_betting_closed)
+        {
+            state.acting_player = 1 - acting;
+        }
+        else if (is_all_in || state.street == num_of_betting_rounds - 1)
+        {
+            state.is_showdown = true;
+        }
+        else
+        {
+            // After the flop the big blind acts first
+            ++state.street;
+            state.acting_player = 1;
+            state.raises = 0;
+            state.actions = 0;
+            state.history = append_to_history(state.history, street_separator_code);
+        }
+        return state;
+    }
+
+    // showdown_winner is 0 or 1, or -1 for a tie
+    double get_utility_of_player_0(const abstract_betting_state &state, const int showdown_winner) const
+    {
+        const auto winner = state.folded_player >= 0 ? 1 - state.folded_player : showdown_winner;
+        if (winner < 0)
+        {
+            return 0;
+        }
+        return winner == 0 ? static_cast<double>(state.contributions[1]) : -static_cast<double>(state.contributions[0]);
+    }
+
+private:
+    uint64_t get_amount_to_call(const abstract_betting_state &state) const
+    {
+        const auto acting = state.acting_player;
+        return state.contributions[1 - acting] - std::min(state.contributions[acting], state.contributions[1 - acting]);
+    }
+
+    uint64_t get_stack_left(const abstract_betting_state &state, const size_t player) const
+    {
+        return _abstraction.stack - state.contributions[player];
+    }
+
+    const heads_up_abstraction &_abstraction;
+};
+
+//
+// Training
+//
+
+struct information_set
+{
+    std::array<double, num_of_abstract_actions> regrets{};
+    std::array<double, num_of_abstract_actions> strategy_sums{};
+};
+using information_set_table = std::unordered_map<uint64_t, information_set>;
+
+// Runs iterations on a single thread. Reads the regrets merged so far and collects its updates separately.
+class cfr_trainer
+{
+public:
+    cfr_trainer(const heads_up_abstraction &abstraction, const information_set_table &shared, const uint64_t seed)
+    :
+        _game(abstraction),
+        _shared(shared),
+        _rng(seed)
+    {
+    }
+
+    void run_iterations(const size_t iterations)
+    {
+        for (size_t iteration = 0; iteration < iterations; ++iteration)
+        {
+            deal_cards();
+            for (size_t traverser = 0; traverser < 2; ++traverser)
+            {
+                traverse(_game.get_initial_state(), traverser);
+            }
+        }
+    }
+
+    information_set_table& get_updates() { return _updates; }
+
+private:
+    void deal_cards()
+    {
+        std::array<unsigned, 52> deck{};
+        for (unsigned card = 0; card < deck.size(); ++card) { deck[card] = card; }
+        for (size_t pos = 0; pos < 9; ++pos)
+        {
+            std::uniform_int_distribution<size_t> dist(pos, deck.size() - 1);
+            std::swap(deck[pos], deck[dist(_rng)]);
+        }
+
+        const std::array<uint64_t, 2> pockets{(1ull << deck[0]) | (1ull << deck[1]), (1ull << deck[2]) | (1ull << deck[3])};
+        const std::array<uint64_t, num_of_betting_rounds> boards{
+            0,
+            (1ull << deck[4]) | (1ull << deck[5]) | (1ull << deck[6]),
+            (1ull << deck[4]) | (1ull << deck[5]) | (1ull << deck[6]) | (1ull << deck[7]),
+            (1ull << deck[4]) | (1ull << deck[5]) | (1ull << deck[6]) | (1ull << deck[7]) | (1ull << deck[8])};
+
+        for (size_t player = 0; player < 2; ++player)
+        {
+            for (size_t street = 0; street < num_of_betting_rounds; ++street)
+            {
+                _buckets[player][street] = get_card_bucket(_evaluator, pockets[player], boards[street]);
+            }
+        }
+
+        omp::Hand board = omp::Hand::empty();
+        for (size_t pos = 4; pos < 9; ++pos) { board += omp::Hand(deck[pos]); }
+        const auto rank_0 = _evaluator.evaluate(board + omp::Hand(deck[0]) + omp::Hand(deck[1]));
+        const auto rank_1 = _evaluator.evaluate(board + omp::Hand(deck[2]) + omp::Hand(deck[3]));
+        _showdown_winner = rank_0 == rank_1 ? -1 : rank_0 > rank_1 ? 0 : 1;
+    }
+
+    abstract_action_probabilities get_strategy(const uint64_t key, const std::array<bool, num_of_abstract_actions> &legal)
+    {
+        abstract_action_probabilities regrets{};
+        if (const auto it = _shared.find(key); it != _shared.end()) { regrets = it->second.regrets; }
+        if (const auto it = _updates.find(key); it != _updates.end())
+        {
+            for (size_t action = 0; action < num_of_abstract_actions; ++action) { regrets[action] += it->second.regrets[action]; }
+        }
+
+        // Regret matching
+        abstract_action_probabilities strategy{};
+        double positive_sum = 0;
+        for (size_t action = 0; action < num_of_abstract_actions; ++action)
+        {
+            strategy[action] = legal[action] ? std::max(regrets[action], 0.0) : 0;
+            positive_sum += strategy[action];
+        }
+        const auto legal_count = static_cast<double>(std::count(legal.begin(), legal.end(), true));
+        for (size_t action = 0; action < num_of_abstract_actions; ++action)
+        {
+            strategy[action] = positive_sum > 0 ? strategy[action] / positive_sum : (legal[action] ? 1 / legal_count : 0);
+        }
+        return strategy;
+    }
+
+    double traverse(const abstract_betting_state &state, const size_t traverser)
+    {
+        if (state.is_terminal())
+        {
+            const auto utility = _game.get_utility_of_player_0(state, _showdown_winner);
+            return traverser == 0 ? utility : -utility;
+        }
+
+        const auto acting = state.acting_player;
+        const auto key = make_information_set_key(state.street, _buckets[acting][state.street], state.history);
+        const auto legal = _game.get_legal_actions(state);
+        const auto strategy = get_strategy(key, legal);
+
+        if (acting == traverser)
+        {
+            abstract_action_probabilities values{};
+            double node_value = 0;
+            for (size_t action = 0; action < num_of_abstract_actions; ++action)
+            {
+                if (legal[action])
+                {
+                    values[action] = traverse(_game.apply(state, static_cast<abstract_action>(action)), traverser);
+                    node_value += strategy[action] * values[action];
+                }
+            }
+
+            auto &regrets = _updates[key].regrets;
+            for (size_t action = 0; action < num_of_abstract_actions; ++action)
+            {
+                if (legal[action]) { regrets[action] += values[action] - node_value; }
+            }
+            return node_value;
+        }
+
+        auto &strategy_sums = _updates[key].strategy_sums;
+        for (size_t action = 0; action < num_of_abstract_actions; ++action) { strategy_sums[action] += strategy[action]; }
+
+        // Sample the opponent's action from its current strategy. Rounding leftovers fall back to a legal action.
+        auto threshold = std::uniform_real_distribution<double>(0, 1)(_rng);
+        size_t sampled_action = num_of_abstract_actions - 1;
+        for (size_t action = 0; action < num_of_abstract_actions; ++action)
+        {
+            if (threshold < strategy[action])
+            {
+                sampled_action = action;
+                break;
+            }
+            threshold -= strategy[action];
+        }
+        while (!legal[sampled_action]) { --sampled_action; }
+        return traverse(_game.apply(state, static_cast<abstract_action>(sampled_action)), traverser);
+    }
+
+    const abstract_game _game;
+    const information_set_table &_shared;
+    information_set_table _updates;
+
+    std::mt19937_64 _rng;
+    omp::HandEvaluator _evaluator;
+
+    std::array<std::array<size_t, num_of_betting_rounds>, 2> _buckets{};
+    int _showdown_winner = -1;
+};
+
+//
+// Policy file
+//
+
+struct heads_up_policy_header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t entry_size;
+    uint64_t small_blind_size;
+    uint64_t big_blind_size;
+    uint64_t stack;
+    double raise_pot_ratio;
+    uint64_t max_raises_per_street;
+    uint64_t num_of_entries;
+};
+
+// Probabilities are quantised to 8 bits
+struct heads_up_policy_entry
+{
+    uint64_t key;
+    std::array<uint8_t, num_of_abstract_actions> probabilities;
+};
+
+constexpr char policy_file_magic[8] = {'H', 'U', 'P', 'O', 'L', 'I', 'C', 'Y'};
+constexpr uint32_t policy_file_version = 1;
+
+static void write_policy(const heads_up_abstraction &abstraction, const information_set_table &table, const std::string &policy_path)
+{
+    std::vector<heads_up_policy_entry> entries;
+    entries.reserve(table.size());
+    for (const auto &[key, info] : table)
+    {
+        const auto &sums = info.strategy_sums;
+        const auto total = sums[0] + sums[1] + sums[2];
+        if (total <= 0)
+        {
+            continue;
+        }
+
+        heads_up_policy_entry entry{key, {}};
+        for (size_t action = 0; action < num_of_abstract_actions; ++action)
+        {
+            entry.probabilities[action] = static_cast<uint8_t>(sums[action] / total * 255 + 0.5);
+        }
+        entries.emplace_back(entry);
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto &lhs, const auto &rhs){ return lhs.key < rhs.key; });
+
+    heads_up_policy_header header{};
+    std::memcpy(header.magic, policy_file_magic, sizeof(header.magic));
+    header.version = policy_file_version;
+    header.entry_size = sizeof(heads_up_policy_entry);
+    header.small_blind_size = abstraction.small_blind_size;
+    header.big_blind_size = abstraction.big_blind_size;
+    header.stack = abstraction.stack;
+    header.raise_pot_ratio = abstraction.raise_pot_ratio;
+    header.max_raises_per_street = abstraction.max_raises_per_street;
+    header.num_of_entries = entries.size();
+
+    std::ofstream file(policy_path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(heads_up_policy_entry)));
+    if (!file)
+    {
+        throw std::runtime_error("Cannot write policy file " + policy_path);
+    }
+}
+
+heads_up_training_stats train_heads_up_policy(const heads_up_training_config &config, const std::string &policy_path)
+{
+    if (config.abstraction.max_raises_per_street > 3)
+    {
+        throw std::invalid_argument("At most 3 raises per street fit into information set keys");
+    }
+    if (config.abstraction.small_blind_size >= config.abstraction.big_blind_size ||
+        config.abstraction.stack <= config.abstraction.big_blind_size)
+    {
+        throw std::invalid_argument("Invalid blind and stack sizes in abstraction");
+    }
+
+    const auto start_time = std::chrono::steady_clock::now();
+    const size_t num_of_threads = config.num_of_threads ? config.num_of_threads : std::max(1u, std::thread::hardware_concurrency());
+    const size_t iterations_per_epoch = std::max(config.iterations_per_epoch, num_of_threads);
+
+    information_set_table shared;
+    size_t iterations_done = 0;
+    for (size_t epoch = 0; iterations_done < config.iterations; ++epoch)
+    {
+        const auto epoch_iterations = std::min(iterations_per_epoch, config.iterations - iterations_done);
+
+        std::vector<cfr_trainer> trainers;
+        trainers.reserve(num_of_threads);
+        for (size_t thread_index = 0; thread_index < num_of_threads; ++thread_index)
+        {
+            trainers.emplace_back(config.abstraction, shared, config.seed + epoch * num_of_threads + thread_index);
+        }
+
+        std::vector<std::thread> threads;
+        for (size_t thread_index = 0; thread_index < num_of_threads; ++thread_index)
+        {
+            const auto thread_iterations = epoch_iterations / num_of_threads + (thread_index < epoch_iterations % num_of_threads ? 1 : 0);
+            threads.emplace_back([&trainer = trainers[thread_index], thread_iterations](){ trainer.run_iterations(thread_iterations); });
+        }
+        for (auto &thread : threads) { thread.join(); }
+
+        for (auto &trainer : trainers)
+        {
+            for (const auto &[key, update] : trainer.get_updates())
+            {
+                auto &info = shared[key];
+                for (size_t action = 0; action < num_of_abstract_actions; ++action)
+                {
+                    info.regrets[action] += update.regrets[action];
+                    info.strategy_sums[action] += update.strategy_sums[action];
+                }
+            }
+        }
+
+        iterations_done += epoch_iterations;
+    }
+
+    write_policy(config.abstraction, shared, policy_path);
+
+    heads_up_training_stats stats;
+    stats.iterations = iterations_done;
+    stats.num_of_information_sets = shared.size();
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    return stats;
+}
+
+//
+// Policy lookup
+//
+
+heads_up_policy::heads_up_policy(const std::string &policy_path)
+:
+    _file(policy_path)
+{
+    heads_up_policy_header header{};
+    if (_file.size() < sizeof(header))
+    {
+        throw std::invalid_argument("Policy file " + policy_path + " is too small");
+    }
+    std::memcpy(&header, _file.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, policy_file_magic, sizeof(header.magic)) != 0 ||
+        header.version != policy_file_version ||
+        header.entry_size != sizeof(heads_up_policy_entry) ||
+        _file.size() != sizeof(header) + header.num_of_entries * sizeof(heads_up_policy_entry))
+    {
+        throw std::invalid_argument("File " + policy_path + " is not a compatible policy file");
+    }
+
+    _abstraction.small_blind_size = header.small_blind_size;
+    _abstraction.big_blind_size = header.big_blind_size;
+    _abstraction.stack = header.stack;
+    _abstraction.raise_pot_ratio = header.raise_pot_ratio;
+    _abstraction.max_raises_per_street = header.max_raises_per_street;
+
+    _entries = reinterpret_cast<const heads_up_policy_entry*>(static_cast<const char*>(_file.data()) + sizeof(header));
+    _num_of_entries = static_cast<size_t>(header.num_of_entries);
+}
+
+// Whether table plays the trained game once chips are converted to big blinds
+static bool fits_abstraction(const table_state &table, const heads_up_abstraction &abstraction)
+{
+    if (table.ante_size != 0 || table.big_blind_size == 0 ||
+        table.small_blind_size * abstraction.big_blind_size != abstraction.small_blind_size * table.big_blind_size)
+    {
+        return false;
+    }
+
+    // Effective stack at the start of the round
+    const auto effective_stack = std::min(table.get_stack(0) + table.get_contribution(0), table.get_stack(1) + table.get_contribution(1));
+    const auto stack_depth = static_cast<double>(effective_stack) / static_cast<double>(table.big_blind_size);
+    const auto trained_stack_depth = static_cast<double>(abstraction.stack) / static_cast<double>(abstraction.big_blind_size);
+    return stack_depth * max_stack_depth_ratio >= trained_stack_depth && stack_depth <= trained_stack_depth * max_stack_depth_ratio;
+}
+
+// Rebuilds the abstract betting history of a live heads-up table. Returns nullopt if it doesn't fit the abstraction.
+static std::optional<uint64_t> get_abstract_history(const table_state &table, const uint64_t max_raises_per_street)
+{
+    const auto current_street = get_betting_round_index(table.current_stage);
+    const auto dealer = table.dealer_pos;
+    const auto big_blind = get_next_pos(dealer, 2);
+
+    constexpr std::array<game_stages, num_of_betting_rounds> betting_rounds{game_stages::pre_flop_betting_round,
+                                                                            game_stages::flop_betting_round,
+                                                                            game_stages::turn_betting_round,
+                                                                            game_stages::river_betting_round};
+
+    uint64_t history = empty_history;
+    for (size_t street = 0; street <= current_street; ++street)
+    {
+        // Pre-flop the dealer acts first, after that the big blind does
+        const auto first = street == 0 ? dealer : big_blind;
+        const auto stage = betting_rounds[street];
+        const auto &first_actions = table.players.at(first).get_actions(stage);
+        const auto &second_actions = table.players.at(1 - first).get_actions(stage);
+        if (first_actions.size() != second_actions.size() && first_actions.size() != second_actions.size() + 1)
+        {
+            return std::nullopt;
+        }
+
+        uint64_t raises = 0;
+        for (size_t index = 0; index < first_actions.size() + second_actions.size(); ++index)
+        {
+            const auto &action = index % 2 == 0 ? first_actions[index / 2] : second_actions[index / 2];
+            if (std::holds_alternative<player_action_fold>(action))
+            {
+                return std::nullopt;
+            }
+            const bool is_raise = std::holds_alternative<player_action_raise>(action);
+            if (is_raise && ++raises > max_raises_per_street)
+            {
+                return std::nullopt;
+            }
+            history = append_to_history(history, static_cast<uint64_t>(is_raise ? abstract_action::raise : abstract_action::check_or_call));
+        }
+
+        if (street < current_street)
+        {
+            history = append_to_history(history, street_separator_code);
+        }
+    }
+    return history;
+}
+
+std::optional<abstract_action_probabilities> heads_up_policy::get_action_probabilities(const table_state &table) const
+{
+    if (table.get_num_of_players() != 2 || !is_betting_round(table.current_stage) || !fits_abstraction(table, _abstraction))
+    {
+        return std::nullopt;
+    }
+
+    const auto &pocket_cards = table.get_acting_player().pocket_cards;
+    if (!pocket_cards)
+    {
+        return std::nullopt;
+    }
+    const auto pocket_mask = omp::CardRange::getCardMask(*pocket_cards);
+    const auto board_mask = omp::CardRange::getCardMask(table.communal_cards);
+    if (omp::bitCount(pocket_mask) != 2)
+    {
+        return std::nullopt;
+    }
+
+    const auto history = get_abstract_history(table, _abstraction.max_raises_per_street);
+    if (!history)
+    {
+        return std::nullopt;
+    }
+
+    static const omp::HandEvaluator evaluator;
+    const auto street = get_betting_round_index(table.current_stage);
+    const auto key = make_information_set_key(street, get_card_bucket(evaluator, pocket_mask, board_mask), *history);
+
+    const auto end = _entries + _num_of_entries;
+    const auto it = std::lower_bound(_entries, end, key, [](const heads_up_policy_entry &entry, const uint64_t key){ return entry.key < key; });
+    if (it == end || it->key != key)
+    {
+        return std::nullopt;
+    }
+
+    abstract_action_probabilities result{};
+    const double total = it->probabilities[0] + it->probabilities[1] + it->probabilities[2];
+    for (size_t action = 0; action < num_of_abstract_actions; ++action)
+    {
+        result[action] = it->probabilities[action] / total;
+    }
+    return result;
+}
+
+std::optional<player_action_t> heads_up_policy::get_recommended_action(const table_state &table) const
+{
+    const auto probabilities = get_action_probabilities(table);
+    if (!probabilities)
+    {
+        return std::nullopt;
+    }
+
+    const auto best = static_cast<abstract_action>(std::distance(probabilities->begin(), std::max_element(probabilities->begin(), probabilities->end())));
+    switch (best)
+    {
+    case abstract_action::fold:
+        return player_action_fold{};
+    case abstract_action::check_or_call:
+        return player_action_check_or_call{};
+    case abstract_action::raise:
+        break;
+    }
+
+    const auto amount_to_call = table.get_acting_player_amount_to_call();
+    const auto raise = static_cast<uint64_t>((table.pot + amount_to_call) * _abstraction.raise_pot_ratio);
+    return player_action_raise{std::max(raise, table.big_blind_size)};
+}
+
+} // end of namespace poker_lib
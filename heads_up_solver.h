@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "memory_mapped_file.h"
+#include "table/player_actions.h"
+#include "table/table_state.h"
+
+namespace poker_lib {
+
+// Heads-up game the solver is trained on. Cards are bucketed and the only bet size is a fixed ratio of the pot.
+struct heads_up_abstraction
+{
+    uint64_t small_blind_size = 1;
+    uint64_t big_blind_size = 2;
+    uint64_t stack = 200;
+    // Raise above call as ratio of the pot after calling
+    double raise_pot_ratio = 1;
+    // At most 3 so that a whole betting history fits into a 64-bit information set key
+    uint64_t max_raises_per_street = 3;
+};
+
+struct heads_up_training_config
+{
+    heads_up_abstraction abstraction;
+    size_t iterations = 1000000;
+    // 0 means one thread per core
+    size_t num_of_threads = 0;
+    // Threads train on their own regret deltas which are merged after every epoch
+    size_t iterations_per_epoch = 10000;
+    uint64_t seed = 1;
+};
+
+struct heads_up_training_stats
+{
+    size_t iterations = 0;
+    size_t num_of_information_sets = 0;
+    double seconds = 0;
+};
+
+// Trains a policy with external sampling Monte Carlo CFR and writes its average strategy to policy_path
+heads_up_training_stats train_heads_up_policy(const heads_up_training_config &config, const std::string &policy_path);
+
+// Abstract actions in the order the policy stores their probabilities
+enum class abstract_action : uint8_t
+{
+    fold = 0,
+    check_or_call,
+    raise,
+};
+constexpr size_t num_of_abstract_actions = 3;
+using abstract_action_probabilities = std::array<double, num_of_abstract_actions>;
+
+struct heads_up_policy_entry;
+
+// How much deeper or shallower than the trained stack a table's effective stack may be for the policy to apply
+constexpr double max_stack_depth_ratio = 1.5;
+
+// Policy file written by train_heads_up_policy. The file is memory mapped and looked up with a binary search.
+class heads_up_policy
+{
+public:
+    // Throws if the file is not a valid policy file
+    explicit heads_up_policy(const std::string &policy_path);
+
+    const heads_up_abstraction& get_abstraction() const { return _abstraction; }
+    size_t get_num_of_information_sets() const { return _num_of_entries; }
+
+    // Returns nullopt unless table is heads-up, the acting player's pocket cards are known and the betting so far
+    // fits into the abstraction. Chips are measured in big blinds, so tables of any blind level map onto the trained
+    // game as long as they have no ante, the same small to big blind ratio and an effective stack within
+    // max_stack_depth_ratio of the trained one. The policy isn't used for other tables.
+    std::optional<abstract_action_probabilities> get_action_probabilities(const table_state &table) const;
+    // Most likely action of the policy. Raises are sized by the abstraction's pot ratio.
+    std::optional<player_action_t> get_recommended_action(const table_state &table) const;
+
+private:
+    memory_mapped_file _file;
+    heads_up_abstraction _abstraction;
+    const heads_up_policy_entry* _entries = nullptr;
+    size_t _num_of_entries = 0;
+};
+
+} // end of namespace poker_lib
@@ -9,6 +9,7 @@
 
 namespace poker_lib {
 
+// Plays a game on the calling thread, blocking on every input. Runs the stages of async_holdem_game_orchestrator.
 class holdem_game_orchestrator
 {
 public:
@@ -20,14 +21,6 @@ public:
     void run_game();
 
 private:
-    player_action_t get_acting_player_action();
-    std::string table_state_and_stage_to_user_message() const;
-
-    template <typename FuncT>
-    std::string read_valid_cards(FuncT get_cards, size_t expected_num_of_cards);
-
-    void execute_showdown();
-
     i_my_poker_lib& _poker_lib;
     i_user_interaction& _user_interaction;
     i_table_state_manager& _table_state_manager;
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <functional>
+
+namespace poker_lib {
+
+// Runs the analyses of async_holdem_game_orchestrator off the thread driving the game, e.g. on a worker pool, so an
+// event loop keeps serving other tables meanwhile. on_finished has to be called on the thread driving the game like
+// the continuations of i_async_user_interaction. The library analysing the table is used from the worker, so games
+// sharing a library must not analyse at the same time unless the library is thread safe. A failed analysis is
+// rethrown by on_finished, so it reaches the thread driving the game like exceptions thrown from the continuations.
+class i_analysis_executor
+{
+public:
+    virtual ~i_analysis_executor() = default;
+
+    virtual void run(std::function<void()> work, std::function<void()> on_finished) = 0;
+};
+
+} // end of namespace poker_lib
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include "table/player_actions.h"
+
+namespace poker_lib {
+
+// Same interaction points as i_user_interaction but the answers are passed to continuations instead of being
+// returned. Implementations return right away and call the continuation once the input arrives, on whatever thread
+// drives the game, e.g. an event loop serving many tables. Calling it before returning is fine as well.
+class i_async_user_interaction
+{
+public:
+    using cards_continuation = std::function<void(const std::string&)>;
+    using action_continuation = std::function<void(const player_action_t&)>;
+
+    virtual ~i_async_user_interaction() = default;
+
+    virtual void get_user_pocket_cards(cards_continuation on_cards) = 0;
+    virtual void get_player_pocket_cards(size_t user_pos, cards_continuation on_cards) = 0;
+    virtual void get_flop(cards_continuation on_cards) = 0;
+    virtual void get_turn(cards_continuation on_card) = 0;
+    virtual void get_river(cards_continuation on_card) = 0;
+    virtual void get_dead_cards(cards_continuation on_cards) = 0;
+
+    virtual void get_user_action(action_continuation on_action) = 0;
+    virtual void get_opponent_action(action_continuation on_action) = 0;
+
+    virtual void notify_player(const std::string& message) = 0;
+};
+
+} // end of namespace poker_lib
@@ -4,15 +4,33 @@
 #include <unordered_set>
 #include <vector>
 
+#include "hand_classification.h"
+#include "performance_stats.h"
 #include "table/player_actions.h"
 #include "table/table_state.h"
 
 namespace poker_lib {
 
+struct action_payout
+{
+    player_action_t action;
+    // Expected tournament payout after taking the action
+    double expected_payout = 0;
+};
+
 struct player_analysis
 {
     double equity = 0;
     double pot_equity = 0;
+    // Heads-up equity against every table position from the same simulation, 0 for folded players. Only set by the
+    // seeded equity engine.
+    std::vector<double> equities_vs_opponents;
+    // Made hand, draws and outs of the acting player, default if the player's pocket cards are unknown
+    hand_classification hand;
+    // Expected change of stack size by following the recommendation. Only set by look-ahead searches.
+    double expected_value = 0;
+    // Only set when tournament payouts are known. The recommendation is the action with the highest payout.
+    std::vector<action_payout> action_payouts;
 
     player_action_t recommended_action;
 };
@@ -28,6 +46,13 @@ public:
                                                             double raise_pot_ratio_begin,
                                                             double raise_pot_ratio_end) = 0;
     virtual std::unordered_set<size_t> get_winner_positions(const table_state &table) = 0;
+    // Lets the library learn from the acting player's action once the table state manager accepted it. table is the
+    // state right before the action.
+    virtual void record_action(const table_state &table, const player_action_t &action) = 0;
+    // Lets the library learn from a round that has ended but hasn't been cleared by start_new_round yet
+    virtual void record_finished_round(const table_state &table) = 0;
+
+    virtual performance_stats& get_performance_stats() = 0;
 };
 
 } // end of namespace poker_lib
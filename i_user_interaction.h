@@ -15,6 +15,8 @@ public:
     virtual std::string get_flop() = 0;
     virtual std::string get_turn() = 0;
     virtual std::string get_river() = 0;
+    // Cards known to be out of play, e.g. burned or exposed ones. Empty if there are none.
+    virtual std::string get_dead_cards() = 0;
 
     virtual player_action_t get_user_action() = 0;
     virtual player_action_t get_opponent_action() = 0;
@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#include "icm.h"
+
+namespace poker_lib {
+
+// Players with empty stacks share the places after everyone else
+static void add_busted_players_payouts(const std::vector<uint64_t> &stacks,
+                                       const std::vector<double> &payouts,
+                                       std::vector<double> &result)
+{
+    const auto num_of_busted = static_cast<size_t>(std::count(stacks.begin(), stacks.end(), 0));
+    if (num_of_busted == 0)
+    {
+        return;
+    }
+
+    double busted_payout_sum = 0;
+    for (size_t place = stacks.size() - num_of_busted; place < std::min(stacks.size(), payouts.size()); ++place)
+    {
+        busted_payout_sum += payouts[place];
+    }
+    for (size_t pos = 0; pos < stacks.size(); ++pos)
+    {
+        if (stacks[pos] == 0)
+        {
+            result[pos] = busted_payout_sum / static_cast<double>(num_of_busted);
+        }
+    }
+}
+
+std::vector<double> calculate_icm_exact(const std::vector<uint64_t> &stacks, const std::vector<double> &payouts)
+{
+    if (stacks.size() > max_exact_icm_players)
+    {
+        throw std::invalid_argument("Exact ICM supports at most " + std::to_string(max_exact_icm_players) + " players");
+    }
+
+    std::vector<size_t> positions;
+    for (size_t pos = 0; pos < stacks.size(); ++pos)
+    {
+        if (stacks[pos] > 0) { positions.emplace_back(pos); }
+    }
+
+    const auto num_of_players = positions.size();
+    const auto num_of_paid_places = std::min(num_of_players, payouts.size());
+    const auto total_chips = static_cast<double>(std::accumulate(stacks.begin(), stacks.end(), uint64_t{0}));
+
+    std::vector<double> result(stacks.size(), 0);
+
+    // Probability of each subset of players taking the first places in some order and their chips in total.
+    // Subsets are visited in increasing order so every subset is complete before it's extended.
+    const size_t num_of_subsets = size_t{1} << num_of_players;
+    std::vector<double> subset_probabilities(num_of_subsets, 0);
+    std::vector<double> subset_chips(num_of_subsets, 0);
+    subset_probabilities[0] = 1;
+
+    for (size_t subset = 0; subset < num_of_subsets; ++subset)
+    {
+        if (subset > 0)
+        {
+            const auto lowest_bit = subset & (~subset + 1);
+            const auto lowest_index = static_cast<size_t>(std::bitset<max_exact_icm_players>(lowest_bit - 1).count());
+            subset_chips[subset] = subset_chips[subset ^ lowest_bit] + static_cast<double>(stacks[positions[lowest_index]]);
+        }
+
+        const auto probability = subset_probabilities[subset];
+        const auto place = std::bitset<max_exact_icm_players>(subset).count();
+        if (probability == 0 || place >= num_of_paid_places)
+        {
+            continue;
+        }
+
+        const auto chips_left = total_chips - subset_chips[subset];
+        for (size_t index = 0; index < num_of_players; ++index)
+        {
+            if (subset & (size_t{1} << index))
+            {
+                continue;
+            }
+            const auto pos = positions[index];
+            const auto finishes_next = probability * static_cast<double>(stacks[pos]) / chips_left;
+            result[pos] += finishes_next * payouts[place];
+            subset_probabilities[subset | (size_t{1} << index)] += finishes_next;
+        }
+    }
+
+    add_busted_players_payouts(stacks, payouts, result);
+    return result;
+}
+
+std::vector<double> calculate_icm_monte_carlo(const std::vector<uint64_t> &stacks,
+                                              const std::vector<double> &payouts,
+                                              const size_t trials,
+                                              const uint64_t seed)
+{
+    std::vector<size_t> positions;
+    for (size_t pos = 0; pos < stacks.size(); ++pos)
+    {
+        if (stacks[pos] > 0) { positions.emplace_back(pos); }
+    }
+    const auto num_of_paid_places = std::min(positions.size(), payouts.size());
+
+    std::vector<double> payout_sums(stacks.size(), 0);
+    std::vector<std::pair<double, size_t>> finish_keys(positions.size());
+    std::mt19937_64 rng(seed);
+    std::exponential_distribution<double> exponential;
+
+    for (size_t trial = 0; trial < trials; ++trial)
+    {
+        // Exponential race: sorting by Exp(1) / stack gives the first place proportionally to stacks, then the
+        // second one proportionally among the rest and so on, which is exactly Malmuth-Harville
+        for (size_t index = 0; index < positions.size(); ++index)
+        {
+            finish_keys[index] = {exponential(rng) / static_cast<double>(stacks[positions[index]]), positions[index]};
+        }
+        std::partial_sort(finish_keys.begin(), std::next(finish_keys.begin(), num_of_paid_places), finish_keys.end());
+
+        for (size_t place = 0; place < num_of_paid_places; ++place)
+        {
+            payout_sums[finish_keys[place].second] += payouts[place];
+        }
+    }
+
+    std::vector<double> result(stacks.size(), 0);
+    for (size_t pos = 0; pos < stacks.size(); ++pos)
+    {
+        result[pos] = trials > 0 ? payout_sums[pos] / static_cast<double>(trials) : 0;
+    }
+
+    add_busted_players_payouts(stacks, payouts, result);
+    return result;
+}
+
+icm_calculator::icm_calculator(std::vector<double> payouts, const size_t monte_carlo_trials, const uint64_t seed)
+:
+    _payouts(std::move(payouts)),
+    _monte_carlo_trials(monte_carlo_trials),
+    _seed(seed)
+{
+    if (_payouts.empty())
+    {
+        throw std::invalid_argument("ICM needs at least one paid place");
+    }
+}
+
+std::vector<double> icm_calculator::get_expected_payouts(const std::vector<uint64_t> &stacks)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (const auto it = _cache.find(stacks); it != _cache.end())
+        {
+            ++_num_of_cache_hits;
+            return it->second;
+        }
+    }
+
+    auto result = stacks.size() <= max_exact_icm_players ? calculate_icm_exact(stacks, _payouts)
+                                                          : calculate_icm_monte_carlo(stacks, _payouts, _monte_carlo_trials, _seed);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    // Stacks change every hand so old results are rarely hit again
+    if (_cache.size() >= max_icm_cache_size)
+    {
+        _cache.clear();
+    }
+    _cache.emplace(stacks, result);
+    return result;
+}
+
+size_t icm_calculator::get_num_of_cache_hits() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _num_of_cache_hits;
+}
+
+} // end of namespace poker_lib
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace poker_lib {
+
+// Fields up to this size are calculated exactly, larger ones with Monte Carlo
+constexpr size_t max_exact_icm_players = 10;
+// icm_calculator starts over once it has cached this many results
+constexpr size_t max_icm_cache_size = 1 << 16;
+
+// Malmuth-Harville ICM over the subsets of players who have already finished in the paid places.
+// payouts[n] is the prize for finishing at place n + 1. Returns the expected payout of each player.
+std::vector<double> calculate_icm_exact(const std::vector<uint64_t> &stacks, const std::vector<double> &payouts);
+// Samples finishing orders with the same distribution as Malmuth-Harville
+std::vector<double> calculate_icm_monte_carlo(const std::vector<uint64_t> &stacks,
+                                              const std::vector<double> &payouts,
+                                              size_t trials,
+                                              uint64_t seed);
+
+class icm_calculator
+{
+public:
+    explicit icm_calculator(std::vector<double> payouts, size_t monte_carlo_trials = 100000, uint64_t seed = 1);
+
+    const std::vector<double>& get_payouts() const { return _payouts; }
+
+    // Expected payouts of players with the given stacks. Results are cached per stack vector, the cache is cleared when
+    // it's full. Thread safe.
+    std::vector<double> get_expected_payouts(const std::vector<uint64_t> &stacks);
+
+    size_t get_num_of_cache_hits() const;
+
+private:
+    const std::vector<double> _payouts;
+    const size_t _monte_carlo_trials;
+    const uint64_t _seed;
+
+    mutable std::mutex _mutex;
+    std::map<std::vector<uint64_t>, std::vector<double>> _cache;
+    size_t _num_of_cache_hits = 0;
+};
+
+} // end of namespace poker_lib
@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <deque>
+#include <future>
+
+#include "event_tracing.h"
+#include "look_ahead_search.h"
+#include "table/holdem_table_state_manager.h"
+
+namespace poker_lib {
+
+using search_clock = std::chrono::steady_clock;
+
+static uint64_t get_raise_amount(const table_state &table, const double pot_ratio)
+{
+    const auto amount_to_call = table.get_acting_player_amount_to_call();
+    const auto raise_amount = static_cast<uint64_t>((table.pot + amount_to_call) * pot_ratio);
+    return std::max(raise_amount, table.big_blind_size);
+}
+
+pot_odds_opponent_model::pot_odds_opponent_model(const double bet_frequency,
+                                                 const double raise_frequency,
+                                                 const double raise_pot_ratio)
+:
+    _bet_frequency(bet_frequency),
+    _raise_frequency(raise_frequency),
+    _raise_pot_ratio(raise_pot_ratio)
+{
+}
+
+opponent_response pot_odds_opponent_model::get_response(const table_state &table) const
+{
+    opponent_response response;
+    response.raise_amount = get_raise_amount(table, _raise_pot_ratio);
+
+    const auto amount_to_call = table.get_acting_player_amount_to_call();
+    if (amount_to_call == 0)
+    {
+        response.raise = _bet_frequency;
+        response.check_or_call = 1 - _bet_frequency;
+        return response;
+    }
+
+    const auto pot_odds = static_cast<double>(amount_to_call) / static_cast<double>(table.pot + amount_to_call);
+    response.fold = std::min(1.0, 1.5 * pot_odds);
+    response.raise = _raise_frequency * (1 - response.fold);
+    response.check_or_call = 1 - response.fold - response.raise;
+    return response;
+}
+
+// Searches one root action. Every thread has its own instance working on its own copy of the table.
+class look_ahead_search
+{
+public:
+    look_ahead_search(const table_state &table,
+                      const std::vector<double> &equities,
+                      const look_ahead_config &config,
+                      size_t max_nodes,
+                      search_clock::time_point deadline);
+
+    double evaluate_action(const player_action_t &action);
+
+    size_t get_visited_nodes() const { return _visited_nodes; }
+    bool is_budget_exhausted() const { return _is_budget_exhausted; }
+
+private:
+    double evaluate_node(size_t depth);
+    double evaluate_next_street(size_t depth);
+    double evaluate_leaf() const;
+    double evaluate_pushed_action(const player_action_t &action, size_t depth);
+
+    bool has_budget();
+
+    holdem_table_state_manager& get_manager() { return _managers.back(); }
+    const table_state& get_table() const { return _managers.back().get_table_state(); }
+
+    const std::vector<double> &_equities;
+    const look_ahead_config &_config;
+    const size_t _max_nodes;
+    const search_clock::time_point _deadline;
+
+    const size_t _hero_pos;
+    const uint64_t _hero_root_contribution;
+
+    // One manager per searched betting round as card deals can't be undone
+    std::deque<holdem_table_state_manager> _managers;
+
+    size_t _visited_nodes = 0;
+    bool _is_budget_exhausted = false;
+};
+
+look_ahead_search::look_ahead_search(const table_state &table,
+                                     const std::vector<double> &equities,
+                                     const look_ahead_config &config,
+                                     const size_t max_nodes,
+                                     const search_clock::time_point deadline)
+:
+    _equities(equities),
+    _config(config),
+    _max_nodes(max_nodes),
+    _deadline(deadline),
+    _hero_pos(table.acting_player_pos),
+    _hero_root_contribution(table.get_contribution(table.acting_player_pos))
+{
+    _managers.emplace_back(table);
+}
+
+double look_ahead_search::evaluate_action(const player_action_t &action)
+{
+    ++_visited_nodes;
+    return evaluate_pushed_action(action, _config.max_depth);
+}
+
+double look_ahead_search::evaluate_pushed_action(const player_action_t &action, const size_t depth)
+{
+    auto &manager = get_manager();
+    manager.push_action(action);
+    const auto value = evaluate_node(depth > 0 ? depth - 1 : 0);
+    manager.pop_action();
+    return value;
+}
+
+bool look_ahead_search::has_budget()
+{
+    if (!_is_budget_exhausted)
+    {
+        _is_budget_exhausted = _visited_nodes >= _max_nodes || search_clock::now() >= _deadline;
+    }
+    return !_is_budget_exhausted;
+}
+
+double look_ahead_search::evaluate_node(const size_t depth)
+{
+    const auto &table = get_table();
+
+    if (depth == 0 || table.has_folded(_hero_pos) || !has_budget())
+    {
+        return evaluate_leaf();
+    }
+    if (!is_betting_round(table.current_stage))
+    {
+        const bool is_card_deal = table.current_stage != game_stages::showdown;
+        const bool may_bet_later = table.get_active_and_not_all_in_player_count() > 1;
+        return (_config.search_future_streets && is_card_deal && may_bet_later) ? evaluate_next_street(depth) : evaluate_leaf();
+    }
+
+    ++_visited_nodes;
+
+    if (table.acting_player_pos == _hero_pos)
+    {
+        double best_value = evaluate_pushed_action(player_action_check_or_call{}, depth);
+        if (table.get_acting_player_amount_to_call() > 0)
+        {
+            best_value = std::max(best_value, evaluate_pushed_action(player_action_fold{}, depth));
+        }
+        if (table.get_stack(_hero_pos) > table.get_acting_player_amount_to_call())
+        {
+            for (const auto ratio : _config.raise_pot_ratios)
+            {
+                best_value = std::max(best_value, evaluate_pushed_action(player_action_raise{get_raise_amount(table, ratio)}, depth));
+            }
+        }
+        return best_value;
+    }
+
+    const auto response = _config.opponent_model->get_response(table);
+
+    double expected_value = 0;
+    if (response.fold > 0)
+    {
+        expected_value += response.fold * evaluate_pushed_action(player_action_fold{}, depth);
+    }
+    if (response.check_or_call > 0)
+    {
+        expected_value += response.check_or_call * evaluate_pushed_action(player_action_check_or_call{}, depth);
+    }
+    if (response.raise > 0)
+    {
+        expected_value += response.raise * evaluate_pushed_action(player_action_raise{response.raise_amount}, depth);
+    }
+    return expected_value;
+}
+
+double look_ahead_search::evaluate_next_street(const size_t depth)
+{
+    // Cards are a chance node with unchanged expected equities so the next betting round starts straight away
+    auto next_street = get_table();
+    next_street.current_stage = get_next_game_stage(next_street.current_stage);
+
+    _managers.emplace_back(std::move(next_street));
+    const auto value = evaluate_node(depth);
+    _managers.pop_back();
+
+    return value;
+}
+
+double look_ahead_search::evaluate_leaf() const
+{
+    const auto &table = get_table();
+    const auto invested = static_cast<double>(table.get_contribution(_hero_pos) - _hero_root_contribution);
+
+    if (table.has_folded(_hero_pos))
+    {
+        return -invested;
+    }
+
+    double active_equity_sum = 0;
+    for (size_t pos = 0; pos < table.get_num_of_players(); ++pos)
+    {
+        if (!table.has_folded(pos))
+        {
+            active_equity_sum += _equities.at(pos);
+        }
+    }
+
+    const auto share = active_equity_sum > 0 ? _equities.at(_hero_pos) / active_equity_sum : 0;
+    return share * static_cast<double>(table.pot) - invested;
+}
+
+look_ahead_result search_best_action(const table_state &table,
+                                     const std::vector<double> &equities,
+                                     const look_ahead_config &config)
+{
+    const scoped_trace_span span("look_ahead", "search_best_action");
+    if (!is_betting_round(table.current_stage))
+    {
+        throw std::invalid_argument("Look-ahead search requires a betting round");
+    }
+    if (equities.size() != table.get_num_of_players())
+    {
+        throw std::invalid_argument("Look-ahead search requires one equity per player");
+    }
+
+    look_ahead_result result;
+
+    result.root_actions.emplace_back(action_expected_value{player_action_check_or_call{}});
+    if (table.get_acting_player_amount_to_call() > 0)
+    {
+        result.root_actions.emplace_back(action_expected_value{player_action_fold{}});
+    }
+    if (table.get_stack(table.acting_player_pos) > table.get_acting_player_amount_to_call())
+    {
+        for (const auto ratio : config.raise_pot_ratios)
+        {
+            result.root_actions.emplace_back(action_expected_value{player_action_raise{get_raise_amount(table, ratio)}});
+        }
+    }
+
+    const auto deadline = search_clock::now() + config.time_budget;
+    const auto max_nodes_per_action = std::max<size_t>(1, config.max_nodes / result.root_actions.size());
+
+    struct root_action_result
+    {
+        double expected_value;
+        size_t visited_nodes;
+        bool is_budget_exhausted;
+    };
+
+    std::vector<std::future<root_action_result>> futures;
+    for (const auto &root_action : result.root_actions)
+    {
+        futures.emplace_back(std::async(std::launch::async, [&, action = root_action.action](){
+            const scoped_trace_span span("look_ahead", "search_root_action");
+            look_ahead_search search(table, equities, config, max_nodes_per_action, deadline);
+            const auto value = search.evaluate_action(action);
+            return root_action_result{value, search.get_visited_nodes(), search.is_budget_exhausted()};
+        }));
+    }
+
+    for (size_t pos = 0; pos < futures.size(); ++pos)
+    {
+        const auto action_result = futures[pos].get();
+        result.root_actions[pos].expected_value = action_result.expected_value;
+        result.visited_nodes += action_result.visited_nodes;
+        result.is_budget_exhausted = result.is_budget_exhausted || action_result.is_budget_exhausted;
+    }
+
+    const auto best = std::max_element(result.root_actions.begin(), result.root_actions.end(),
+                                       [](const auto &lhs, const auto &rhs){ return lhs.expected_value < rhs.expected_value; });
+    result.best_action = best->action;
+
+    return result;
+}
+
+} // end of namespace poker_lib
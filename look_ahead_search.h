@@ -0,0 +1,85 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "table/player_actions.h"
+#include "table/table_state.h"
+
+namespace poker_lib {
+
+// Probabilities of the acting opponent's responses, they are expected to add up to 1
+struct opponent_response
+{
+    double fold = 0;
+    double check_or_call = 0;
+    double raise = 0;
+    // Amount raised above call in case of a raise
+    uint64_t raise_amount = 0;
+};
+
+class i_opponent_model
+{
+public:
+    virtual ~i_opponent_model() = default;
+
+    // Called concurrently from multiple threads
+    virtual opponent_response get_response(const table_state &table) const = 0;
+};
+
+// Bets with a fixed frequency when checked to, otherwise folds more often the worse pot odds it's given
+class pot_odds_opponent_model : public i_opponent_model
+{
+public:
+    explicit pot_odds_opponent_model(double bet_frequency = 0.25,
+                                     double raise_frequency = 0.1,
+                                     double raise_pot_ratio = 1);
+    ~pot_odds_opponent_model() override = default;
+
+    opponent_response get_response(const table_state &table) const override;
+
+private:
+    const double _bet_frequency;
+    const double _raise_frequency;
+    const double _raise_pot_ratio;
+};
+
+struct look_ahead_config
+{
+    // Number of betting actions looked ahead including the acting player's next action
+    size_t max_depth = 6;
+    // Bounds of the whole search. Nodes left when either runs out are evaluated as leaves.
+    size_t max_nodes = 200000;
+    std::chrono::microseconds time_budget = std::chrono::milliseconds(50);
+    // Raise sizes the acting player considers as ratios of the pot after calling
+    std::vector<double> raise_pot_ratios{0.5, 1};
+    // Betting rounds after the current one are searched too, assuming equities don't change until showdown
+    bool search_future_streets = true;
+    std::shared_ptr<const i_opponent_model> opponent_model = std::make_shared<pot_odds_opponent_model>();
+};
+
+struct action_expected_value
+{
+    player_action_t action;
+    // Expected change of the acting player's stack in chips
+    double expected_value = 0;
+};
+
+struct look_ahead_result
+{
+    std::vector<action_expected_value> root_actions;
+    player_action_t best_action;
+    size_t visited_nodes = 0;
+    bool is_budget_exhausted = false;
+};
+
+// Depth limited expectimax search over the remaining betting actions of table following holdem_table_state_manager's
+// rules. The acting player maximises while opponents respond according to the config's opponent model. Leaves are
+// valued by the acting player's share of equities among the players still in the pot, side pots are ignored.
+// equities are per position as returned by calculate_equities. Root actions are searched in parallel.
+look_ahead_result search_best_action(const table_state &table,
+                                     const std::vector<double> &equities,
+                                     const look_ahead_config &config);
+
+} // end of namespace poker_lib
@@ -0,0 +1,83 @@
+#include <omp/HandEvaluator.h>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "batch_hand_evaluator.h"
+#include "hand_indexer.h"
+
+template <typename FuncT>
+static void run_benchmark(const std::string &name, const size_t num_of_hands, FuncT evaluate)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const auto checksum = evaluate();
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << name << ": " << (static_cast<double>(num_of_hands) / seconds / 1e6) << " million hands/s (checksum " << checksum << ")\n";
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t num_of_hands = argc > 1 ? std::stoull(argv[1]) : 10000000;
+
+    std::mt19937_64 rng(1);
+    std::vector<poker_lib::seven_cards> hands(num_of_hands);
+    for (auto &hand : hands)
+    {
+        uint64_t dealt = 0;
+        for (auto &card : hand)
+        {
+            do { card = static_cast<uint8_t>(rng() % 52); } while (dealt & (uint64_t{1} << card));
+            dealt |= uint64_t{1} << card;
+        }
+    }
+
+    const omp::HandEvaluator omp_evaluator;
+    run_benchmark("OMPEval one hand at a time", num_of_hands, [&]()
+    {
+        uint64_t checksum = 0;
+        for (const auto &hand : hands)
+        {
+            auto omp_hand = omp::Hand::empty();
+            for (const auto card : hand) { omp_hand += omp::Hand(card); }
+            checksum += omp_evaluator.evaluate(omp_hand) >> omp::HAND_CATEGORY_SHIFT;
+        }
+        return checksum;
+    });
+
+    std::vector<uint32_t> values(num_of_hands);
+    for (const auto isa : {poker_lib::hand_evaluator_isa::scalar, poker_lib::hand_evaluator_isa::avx2})
+    {
+        if (!poker_lib::batch_hand_evaluator::is_supported(isa))
+        {
+            std::cout << "AVX2 is not supported by this CPU\n";
+            continue;
+        }
+
+        const poker_lib::batch_hand_evaluator evaluator(isa);
+        run_benchmark(isa == poker_lib::hand_evaluator_isa::avx2 ? "Batch AVX2" : "Batch scalar", num_of_hands, [&]()
+        {
+            evaluator.evaluate(hands.data(), hands.size(), values.data());
+            uint64_t checksum = 0;
+            // Categories are numbered from 1 in OMPEval
+            for (const auto value : values) { checksum += poker_lib::get_hand_category(value) + 1; }
+            return checksum;
+        });
+    }
+
+    // River hands are the pocket cards, the flop, the turn and the river
+    const poker_lib::hand_indexer river_indexer({2, 3, 1, 1});
+    run_benchmark("River hand indexer", num_of_hands, [&]()
+    {
+        uint64_t checksum = 0;
+        for (const auto &hand : hands)
+        {
+            checksum += river_indexer.get_index(hand);
+        }
+        return checksum;
+    });
+
+    return 0;
+}
@@ -0,0 +1,27 @@
+#include <iostream>
+#include <string>
+
+#include "flop_equity_database.h"
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <database_path> [samples_per_entry] [num_of_threads] [hand classes, e.g. AA AKs AKo]\n";
+        return 1;
+    }
+
+    poker_lib::flop_equity_database_config config;
+    if (argc > 2) { config.samples_per_entry = std::stoull(argv[2]); }
+    if (argc > 3) { config.num_of_threads = std::stoull(argv[3]); }
+    for (int arg = 4; arg < argc; ++arg)
+    {
+        config.hand_classes.emplace_back(argv[arg]);
+    }
+
+    const auto stats = poker_lib::generate_flop_equity_database(config, argv[1]);
+
+    std::cout << "Computed " << stats.num_of_entries << " entries in " << stats.seconds << " seconds\n";
+
+    return 0;
+}
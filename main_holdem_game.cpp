@@ -1,11 +1,20 @@
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <sstream>
+#include <string>
 
+#include "event_tracing.h"
 #include "my_poker_lib.h"
 #include "holdem_game_orchestrator.h"
 #include "streamed_user_interaction.h"
+#include "thread_placement.h"
 #include "table/initial_player_state.h"
 #include "table/holdem_table_state_manager.h"
+#include "table/table_checkpoint.h"
+
+constexpr uint64_t small_blind_size = 10;
+constexpr uint64_t big_blind_size = 20;
 
 static std::vector<poker_lib::initial_player_state> get_num_of_players_and_stacks()
 {
@@ -40,15 +49,121 @@ static size_t get_user_position()
     throw std::runtime_error("Cannot read user position");
 }
 
-int main()
+// Comma separated prizes starting with the first place, e.g. 50,30,20
+static std::vector<double> parse_payouts(const std::string &payouts)
 {
-    poker_lib::my_poker_lib poker_lib;
-    poker_lib::streamed_user_interaction user_interaction(std::cout, std::cin);
-    poker_lib::holdem_table_state_manager state_manager(get_num_of_players_and_stacks(), 0, 10, 20);
+    std::vector<double> result;
 
-    poker_lib::holdem_game_orchestrator game(poker_lib, user_interaction, state_manager, get_user_position());
+    std::istringstream iss(payouts);
+    std::string payout;
+    while (std::getline(iss, payout, ','))
+    {
+        result.emplace_back(std::stod(payout));
+    }
+
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    poker_lib::my_poker_lib poker_lib{poker_lib::look_ahead_config{}};
+    std::string trace_path;
+    std::string checkpoint_path;
+    bool is_resuming = false;
+    bool asks_for_dead_cards = false;
+    for (int arg = 1; arg + 1 < argc; arg += 2)
+    {
+        const std::string option = argv[arg];
+        if (option == "--heads-up-policy")
+        {
+            poker_lib.set_heads_up_policy(std::make_shared<poker_lib::heads_up_policy>(argv[arg + 1]));
+        }
+        else if (option == "--flop-equity-database")
+        {
+            poker_lib.set_flop_equity_database(std::make_shared<poker_lib::flop_equity_database>(argv[arg + 1]));
+        }
+        else if (option == "--cpus")
+        {
+            poker_lib.set_worker_cpus(poker_lib::parse_cpu_list(argv[arg + 1]));
+        }
+        else if (option == "--checkpoint")
+        {
+            checkpoint_path = argv[arg + 1];
+        }
+        else if (option == "--resume")
+        {
+            checkpoint_path = argv[arg + 1];
+            is_resuming = true;
+        }
+        else if (option == "--ask-for-dead-cards")
+        {
+            asks_for_dead_cards = std::stoi(argv[arg + 1]) != 0;
+        }
+        else if (option == "--trace")
+        {
+            trace_path = argv[arg + 1];
+            poker_lib::start_tracing();
+        }
+        else if (option == "--seed")
+        {
+            poker_lib::equity_engine_config config;
+            config.seed = std::stoull(argv[arg + 1]);
+            poker_lib.set_equity_engine(config);
+        }
+        else if (option == "--payouts")
+        {
+            poker_lib.set_tournament_payouts(parse_payouts(argv[arg + 1]));
+        }
+        else if (option == "--opponent-stats")
+        {
+            const std::string path = argv[arg + 1];
+            poker_lib.set_opponent_stats(std::make_shared<poker_lib::opponent_stats_store>(poker_lib::opponent_stats_store::load(path)), path);
+        }
+        else
+        {
+            throw std::invalid_argument("Unknown option " + option);
+        }
+    }
+    poker_lib::streamed_user_interaction user_interaction(std::cout, std::cin, asks_for_dead_cards);
+
+    std::shared_ptr<poker_lib::table_event_journal> journal;
+    std::unique_ptr<poker_lib::holdem_table_state_manager> state_manager;
+    if (is_resuming)
+    {
+        journal = poker_lib::load_table_checkpoint(checkpoint_path);
+        state_manager = std::make_unique<poker_lib::holdem_table_state_manager>(*journal, journal->size(), poker_lib::blind_schedule{{{small_blind_size, big_blind_size, 0}}});
+    }
+    else
+    {
+        state_manager = std::make_unique<poker_lib::holdem_table_state_manager>(get_num_of_players_and_stacks(), 0, small_blind_size, big_blind_size);
+    }
+
+    std::unique_ptr<poker_lib::checkpointed_table_state_manager> checkpointed_state_manager;
+    if (!checkpoint_path.empty())
+    {
+        checkpointed_state_manager = std::make_unique<poker_lib::checkpointed_table_state_manager>(*state_manager, checkpoint_path, journal);
+    }
+    poker_lib::i_table_state_manager &table_state_manager = checkpointed_state_manager
+        ? static_cast<poker_lib::i_table_state_manager&>(*checkpointed_state_manager)
+        : *state_manager;
+
+    poker_lib::holdem_game_orchestrator game(poker_lib, user_interaction, table_state_manager, get_user_position());
 
     game.run_game();
+    if (checkpointed_state_manager)
+    {
+        // Saving the last checkpoint can still fail after the game
+        checkpointed_state_manager->get_writer().flush();
+    }
+
+    poker_lib.get_performance_stats().dump(std::cerr);
+
+    if (!trace_path.empty())
+    {
+        poker_lib::stop_tracing();
+        std::ofstream trace_file(trace_path);
+        poker_lib::write_chrome_trace(trace_file);
+    }
 
     return 0;
 }
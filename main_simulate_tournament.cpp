@@ -0,0 +1,46 @@
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "tournament_simulator.h"
+
+int main(int argc, char* argv[])
+{
+    if (argc < 7)
+    {
+        std::cerr << "Usage: " << argv[0] << " <num_of_tournaments> <small_blind> <big_blind> <rounds_per_level> <stack> <stack> [stack...]\n"
+                     "Blinds double at every level, 0 rounds per level keeps them fixed\n";
+        return 1;
+    }
+
+    poker_lib::tournament_simulation_config config;
+    config.num_of_tournaments = std::stoull(argv[1]);
+    config.blinds.levels.clear();
+    for (uint64_t level = 0, small_blind = std::stoull(argv[2]), big_blind = std::stoull(argv[3]); level < 20; ++level)
+    {
+        config.blinds.levels.push_back({small_blind << level, big_blind << level, 0});
+    }
+    config.blinds.rounds_per_level = std::stoull(argv[4]);
+    for (int arg = 5; arg < argc; ++arg)
+    {
+        config.stacks.emplace_back(std::stoull(argv[arg]));
+    }
+
+    const auto result = poker_lib::simulate_tournaments(config);
+
+    std::cout << "Simulated " << result.num_of_tournaments << " tournaments with " << result.num_of_rounds << " rounds in "
+              << result.seconds << " seconds (" << result.tournaments_per_second << " tournaments/s, "
+              << result.rounds_per_second << " rounds/s)\n";
+    std::cout << "Placement probabilities (%) of each player, first place first:\n" << std::fixed << std::setprecision(1);
+    for (size_t player = 0; player < config.stacks.size(); ++player)
+    {
+        std::cout << std::setw(10) << config.stacks[player] << ':';
+        for (const auto probability : result.placement_probabilities[player])
+        {
+            std::cout << ' ' << std::setw(5) << 100 * probability;
+        }
+        std::cout << '\n';
+    }
+
+    return 0;
+}
@@ -0,0 +1,24 @@
+#include <iostream>
+#include <string>
+
+#include "heads_up_solver.h"
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 4)
+    {
+        std::cerr << "Usage: " << argv[0] << " <policy_path> [iterations] [num_of_threads]\n";
+        return 1;
+    }
+
+    poker_lib::heads_up_training_config config;
+    if (argc > 2) { config.iterations = std::stoull(argv[2]); }
+    if (argc > 3) { config.num_of_threads = std::stoull(argv[3]); }
+
+    const auto stats = poker_lib::train_heads_up_policy(config, argv[1]);
+
+    std::cout << "Trained " << stats.iterations << " iterations in " << stats.seconds << " seconds, policy has "
+              << stats.num_of_information_sets << " information sets\n";
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "memory_mapped_file.h"
+
+namespace poker_lib {
+
+#ifdef _WIN32
+
+memory_mapped_file::memory_mapped_file(const std::string &path)
+{
+    _file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (_file_handle == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("Cannot open file " + path);
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(_file_handle, &file_size) || file_size.QuadPart == 0)
+    {
+        CloseHandle(_file_handle);
+        throw std::runtime_error("Cannot map empty file " + path);
+    }
+    _size = static_cast<size_t>(file_size.QuadPart);
+
+    _mapping_handle = CreateFileMappingA(_file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    _data = _mapping_handle ? MapViewOfFile(_mapping_handle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!_data)
+    {
+        if (_mapping_handle) { CloseHandle(_mapping_handle); }
+        CloseHandle(_file_handle);
+        throw std::runtime_error("Cannot map file " + path);
+    }
+}
+
+memory_mapped_file::~memory_mapped_file()
+{
+    UnmapViewOfFile(_data);
+    CloseHandle(_mapping_handle);
+    CloseHandle(_file_handle);
+}
+
+#else
+
+memory_mapped_file::memory_mapped_file(const std::string &path)
+{
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Cannot open file " + path);
+    }
+
+    struct stat file_stat{};
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0)
+    {
+        close(fd);
+        throw std::runtime_error("Cannot map empty file " + path);
+    }
+    _size = static_cast<size_t>(file_stat.st_size);
+
+    void* const data = mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping stays valid after closing the descriptor
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        throw std::runtime_error("Cannot map file " + path);
+    }
+    _data = data;
+}
+
+memory_mapped_file::~memory_mapped_file()
+{
+    munmap(const_cast<void*>(_data), _size);
+}
+
+#endif
+
+} // end of namespace poker_lib
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace poker_lib {
+
+// Read-only view of a whole file mapped into memory
+class memory_mapped_file
+{
+public:
+    // Throws if the file cannot be opened or mapped
+    explicit memory_mapped_file(const std::string &path);
+    ~memory_mapped_file();
+
+    memory_mapped_file(const memory_mapped_file&) = delete;
+    memory_mapped_file& operator=(const memory_mapped_file&) = delete;
+
+    const void* data() const { return _data; }
+    size_t size() const { return _size; }
+
+private:
+    const void* _data = nullptr;
+    size_t _size = 0;
+#ifdef _WIN32
+    void* _file_handle = nullptr;
+    void* _mapping_handle = nullptr;
+#endif
+};
+
+} // end of namespace poker_lib
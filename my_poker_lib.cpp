@@ -1,46 +1,73 @@
 #include <omp/CardRange.h>
 #include <omp/EquityCalculator.h>
+#include <algorithm>
 #include <sstream>
 #include <iostream>
 #include <map>
+#include <numeric>
 #include <set>
+#include <thread>
+#include "event_tracing.h"
 #include "my_poker_lib.h"
+#include "thread_placement.h"
 
 namespace poker_lib {
 
-omp::EquityCalculator::Results calculate_equity_results(const table_state &table, const bool is_showdown)
+omp::EquityCalculator::Results calculate_equity_results(const table_state &table,
+                                                        const table_card_masks &card_masks,
+                                                        performance_stats *stats,
+                                                        const std::vector<std::string> &ranges)
 {
-    if (table.players.size() > omp::MAX_PLAYERS)
+    const scoped_trace_span span("equity", "calculate_equity_results");
+    std::optional<scoped_latency_timer> setup_timer;
+    setup_timer.emplace(stats, pipeline_stage::equity_setup);
+
+    const auto num_of_players = table.get_num_of_players();
+    if (num_of_players > omp::MAX_PLAYERS)
     {
         std::ostringstream oss;
-        oss << __func__ << ": requested calculation with " << table.players.size()
+        oss << __func__ << ": requested calculation with " << num_of_players
             << " but at most " << omp::MAX_PLAYERS << " are supported";
 
         throw std::invalid_argument(oss.str());
     }
 
+    auto known_cards = card_masks.board | card_masks.dead;
+    for (const auto pocket_mask : card_masks.pockets)
+    {
+        known_cards |= pocket_mask;
+    }
+
     std::vector<omp::CardRange> hands;
-    for (const auto &player : table.players)
+    for (size_t pos = 0; pos < num_of_players; ++pos)
     {
-        if (player.has_folded())
+        if (table.has_folded(pos))
         {
             continue;
         }
-        if (is_showdown && !player.per_game_state.pocket_cards)
+        const auto &player = table.players.at(pos);
+        if (player.pocket_cards)
         {
-            std::ostringstream oss;
-            oss << "During showdown active player " << player.player_name << " has no pocket cards set";
-            throw std::runtime_error(oss.str());
+            hands.emplace_back(*player.pocket_cards);
+            continue;
         }
-        hands.emplace_back(player.per_game_state.pocket_cards.value_or("random"));
+
+        // A tight range can be blocked completely by the known cards, OMPEval couldn't deal it so random is used instead
+        omp::CardRange range(pos < ranges.size() && !ranges[pos].empty() ? ranges[pos] : "random");
+        const auto &combos = range.combinations();
+        const bool is_dealable = std::any_of(combos.begin(), combos.end(), [known_cards](const auto &combo)
+        {
+            return !(known_cards & ((1ull << combo[0]) | (1ull << combo[1])));
+        });
+        hands.emplace_back(is_dealable ? std::move(range) : omp::CardRange("random"));
     }
 
     omp::EquityCalculator eq;
 
     const auto valid_cards = eq.start(std::vector<omp::CardRange>{hands.begin(), hands.end()},
-                                      omp::CardRange::getCardMask(table.communal_cards),
-                                      omp::CardRange::getCardMask(""),
-                                      is_showdown);
+                                      card_masks.board,
+                                      card_masks.dead,
+                                      false);
 
     if (!valid_cards)
     {
@@ -49,21 +76,44 @@ omp::EquityCalculator::Results calculate_equity_results(const table_state &table
         throw std::invalid_argument(oss.str());
     }
 
-    eq.wait();
+    setup_timer.reset();
+
+    {
+        const scoped_latency_timer wait_timer(stats, pipeline_stage::equity_wait);
+        const scoped_thread_utilization_timer utilization_timer(stats);
+        const scoped_trace_span wait_span("equity", "wait");
+        eq.wait();
+    }
 
-    return eq.getResults();
+    auto results = eq.getResults();
+    if (stats)
+    {
+        stats->add_to_counter(performance_counter::equity_calculations, 1);
+        stats->add_to_counter(performance_counter::simulated_hands, results.hands);
+    }
+    return results;
+}
+
+std::vector<double> calculate_equities(const table_state &table,
+                                       performance_stats *stats,
+                                       const std::vector<std::string> &ranges)
+{
+    return calculate_equities(table, get_table_card_masks(table), stats, ranges);
 }
 
-std::vector<double> calculate_equities(const table_state &table)
+std::vector<double> calculate_equities(const table_state &table,
+                                       const table_card_masks &card_masks,
+                                       performance_stats *stats,
+                                       const std::vector<std::string> &ranges)
 {
-    const auto &equity_result = calculate_equity_results(table, false);
+    const auto &equity_result = calculate_equity_results(table, card_masks, stats, ranges);
 
     std::vector<double> result;
 
     size_t equity_pos = 0;
-    for (const auto &player : table.players)
+    for (size_t pos = 0; pos < table.get_num_of_players(); ++pos)
     {
-        const auto equity = player.has_folded() ? 0 : equity_result.equity[equity_pos++];
+        const auto equity = table.has_folded(pos) ? 0 : equity_result.equity[equity_pos++];
         result.emplace_back(equity);
     }
 
@@ -80,6 +130,209 @@ uint64_t calculate_increment_to_get_pot_eq(const uint64_t pot, const double equi
     return static_cast<uint64_t>(equity * pot / (1 - equity));
 }
 
+// Side pots of a hand where the players contributed the given chips. Layer n is won by the best hand among the
+// contesting players who put in at least levels[n]. Chips folded players put in above every level go to the last layer.
+struct side_pot_layers
+{
+    std::vector<uint64_t> levels;
+    std::vector<uint64_t> amounts;
+};
+
+static side_pot_layers make_side_pot_layers(const std::vector<uint64_t> &contributions, const std::vector<bool> &is_contesting)
+{
+    side_pot_layers layers;
+    for (size_t pos = 0; pos < contributions.size(); ++pos)
+    {
+        if (is_contesting[pos])
+        {
+            layers.levels.emplace_back(contributions[pos]);
+        }
+    }
+    std::sort(layers.levels.begin(), layers.levels.end());
+    layers.levels.erase(std::unique(layers.levels.begin(), layers.levels.end()), layers.levels.end());
+
+    uint64_t previous_level = 0;
+    for (size_t index = 0; index < layers.levels.size(); ++index)
+    {
+        const bool is_last = index + 1 == layers.levels.size();
+        uint64_t amount = 0;
+        for (const auto contribution : contributions)
+        {
+            const auto top = is_last ? contribution : std::min(contribution, layers.levels[index]);
+            amount += top > previous_level ? top - previous_level : 0;
+        }
+        layers.amounts.emplace_back(amount);
+        previous_level = layers.levels[index];
+    }
+    return layers;
+}
+
+// Expected payout of the hero over who wins the layers from first_layer on. The winner of a layer is drawn
+// from its eligible players in proportion to their equity and takes every layer they're eligible for, the layers left
+// are drawn among those who put in more.
+static double get_side_pots_icm_payout(const side_pot_layers &layers,
+                                       const size_t first_layer,
+                                       const std::vector<uint64_t> &contributions,
+                                       const std::vector<double> &win_probabilities,
+                                       std::vector<uint64_t> &stacks,
+                                       const size_t hero_pos,
+                                       icm_calculator &calculator)
+{
+    if (first_layer == layers.levels.size())
+    {
+        return calculator.get_expected_payouts(stacks).at(hero_pos);
+    }
+
+    const auto level = layers.levels[first_layer];
+    double probability_sum = 0;
+    size_t num_of_eligible = 0;
+    for (size_t pos = 0; pos < stacks.size(); ++pos)
+    {
+        if (win_probabilities[pos] >= 0 && contributions[pos] >= level)
+        {
+            probability_sum += win_probabilities[pos];
+            ++num_of_eligible;
+        }
+    }
+
+    double expected_payout = 0;
+    for (size_t pos = 0; pos < stacks.size(); ++pos)
+    {
+        if (win_probabilities[pos] < 0 || contributions[pos] < level)
+        {
+            continue;
+        }
+        // Nobody eligible has any equity, e.g. the pot is already decided. Split the chances evenly.
+        const auto probability = probability_sum > 0 ? win_probabilities[pos] / probability_sum : 1.0 / static_cast<double>(num_of_eligible);
+        if (probability <= 0)
+        {
+            continue;
+        }
+
+        uint64_t won = 0;
+        auto layer = first_layer;
+        for (; layer < layers.levels.size() && layers.levels[layer] <= contributions[pos]; ++layer)
+        {
+            won += layers.amounts[layer];
+        }
+
+        stacks[pos] += won;
+        expected_payout += probability * get_side_pots_icm_payout(layers, layer, contributions, win_probabilities, stacks, hero_pos, calculator);
+        stacks[pos] -= won;
+    }
+    return expected_payout;
+}
+
+double calculate_action_icm_payout(const table_state &table,
+                                   const std::vector<double> &equities,
+                                   const player_action_t &action,
+                                   icm_calculator &calculator)
+{
+    const auto num_of_players = table.get_num_of_players();
+    const auto hero_pos = table.acting_player_pos;
+
+    std::vector<uint64_t> stacks(num_of_players);
+    std::vector<uint64_t> contributions(num_of_players);
+    for (size_t pos = 0; pos < num_of_players; ++pos)
+    {
+        stacks[pos] = table.get_stack(pos);
+        contributions[pos] = table.get_contribution(pos);
+    }
+
+    uint64_t hero_increment = 0;
+    if (const auto *raise = std::get_if<player_action_raise>(&action))
+    {
+        hero_increment = table.get_acting_player_amount_to_call() + raise->amount_raised_above_call;
+    }
+    else if (std::holds_alternative<player_action_check_or_call>(action))
+    {
+        hero_increment = table.get_acting_player_amount_to_call();
+    }
+    hero_increment = std::min(hero_increment, stacks[hero_pos]);
+
+    const bool is_fold = std::holds_alternative<player_action_fold>(action);
+    if (!is_fold)
+    {
+        stacks[hero_pos] -= hero_increment;
+        contributions[hero_pos] += hero_increment;
+    }
+
+    // Contesting players have a win probability, the others are marked with -1
+    std::vector<double> win_probabilities(num_of_players, -1);
+    std::vector<bool> is_contesting(num_of_players, false);
+    for (size_t pos = 0; pos < num_of_players; ++pos)
+    {
+        if (table.has_folded(pos) || (is_fold && pos == hero_pos))
+        {
+            continue;
+        }
+        is_contesting[pos] = true;
+        win_probabilities[pos] = equities.at(pos);
+
+        if (!is_fold && pos != hero_pos && contributions[hero_pos] > contributions[pos])
+        {
+            const auto call = std::min(contributions[hero_pos] - contributions[pos], stacks[pos]);
+            stacks[pos] -= call;
+            contributions[pos] += call;
+        }
+    }
+
+    const auto layers = make_side_pot_layers(contributions, is_contesting);
+    return get_side_pots_icm_payout(layers, 0, contributions, win_probabilities, stacks, hero_pos, calculator);
+}
+
+my_poker_lib::my_poker_lib(look_ahead_config config)
+:
+    _look_ahead_config(std::move(config))
+{
+}
+
+void my_poker_lib::set_opponent_stats(std::shared_ptr<opponent_stats_store> store, std::string path)
+{
+    _opponent_stats = std::move(store);
+    _opponent_stats_path = std::move(path);
+}
+
+void my_poker_lib::set_worker_cpus(std::vector<size_t> cpus)
+{
+    _worker_cpus = std::move(cpus);
+
+    // Tables are allocated by the thread touching them first so they're built on one running on the CPUs
+    std::thread([this]()
+    {
+        set_current_thread_affinity(_worker_cpus);
+        _hand_evaluator = batch_hand_evaluator(batch_hand_evaluator::get_best_isa(),
+                                               _worker_cpus.empty() ? hand_evaluator_tables::shared : hand_evaluator_tables::local);
+    }).join();
+}
+
+void my_poker_lib::record_finished_round(const table_state &table)
+{
+    _range_tracker.reset();
+    if (!_opponent_stats)
+    {
+        return;
+    }
+
+    _opponent_stats->update(table);
+    if (!_opponent_stats_path.empty())
+    {
+        _opponent_stats->save(_opponent_stats_path);
+    }
+}
+
+void my_poker_lib::record_action(const table_state &table, const player_action_t &action)
+{
+    // Only the player's first action since the round started uses the prior
+    std::optional<pocket_combo_weights> prior;
+    const auto &player_name = table.get_acting_player().player_name;
+    if (_opponent_stats && !_range_tracker.get_weights(table.acting_player_pos) && !_opponent_stats->get_range(player_name).empty())
+    {
+        prior = get_vpip_prior_weights(_opponent_stats->find(player_name)->get_vpip());
+    }
+    _range_tracker.observe_action(table, action, prior ? &*prior : nullptr);
+}
+
 size_t my_poker_lib::get_num_of_parsed_cards(const std::string &cards) const
 {
     return omp::bitCount(omp::CardRange::getCardMask(cards));
@@ -92,26 +345,149 @@ player_analysis my_poker_lib::make_acting_player_analysis(const table_state &tab
     player_analysis analysis;
 
     const auto amount_to_call = table.get_acting_player_amount_to_call();
+    const auto card_masks = get_table_card_masks(table);
 
-    analysis.equity = calculate_equities(table).at(table.acting_player_pos);
+    std::vector<double> equities;
+    if (_equity_engine_config)
+    {
+        std::vector<const pocket_combo_weights*> ranges;
+        for (size_t pos = 0; pos < table.get_num_of_players(); ++pos)
+        {
+            ranges.emplace_back(_range_tracker.get_weights(pos));
+        }
+        auto config = *_equity_engine_config;
+        if (config.worker_cpus.empty())
+        {
+            config.worker_cpus = _worker_cpus;
+        }
+        const auto result = calculate_seeded_equities(table, card_masks, config, _hand_evaluator, &_performance_stats, ranges);
+        equities = result.equities;
+        for (size_t pos = 0; pos < table.get_num_of_players(); ++pos)
+        {
+            analysis.equities_vs_opponents.emplace_back(pos == table.acting_player_pos || table.has_folded(pos)
+                ? 0 : result.get_pairwise_equity(table.acting_player_pos, pos));
+        }
+    }
+    else
+    {
+        std::vector<std::string> ranges;
+        bool has_ranges = false;
+        for (size_t pos = 0; pos < table.get_num_of_players(); ++pos)
+        {
+            // OMPEval's ranges aren't weighted so the narrowed range is cut to its likely combos
+            const auto *weights = _range_tracker.get_weights(pos);
+            ranges.emplace_back(weights ? get_likely_combos_range(*weights, 0.25f)
+                                        : _opponent_stats ? _opponent_stats->get_range(table.players.at(pos).player_name)
+                                                          : std::string{});
+            has_ranges = has_ranges || (!table.has_folded(pos) && !ranges.back().empty());
+        }
+
+        // The database only knows equities against a random hand
+        const auto stored_equities = _flop_equity_database && !has_ranges ? _flop_equity_database->find_equities(table) : std::nullopt;
+        if (stored_equities)
+        {
+            _performance_stats.add_to_counter(performance_counter::flop_database_hits, 1);
+            equities = *stored_equities;
+        }
+        else
+        {
+            // OMPEval's workers inherit the affinity of the thread starting them
+            const scoped_thread_affinity affinity(_worker_cpus);
+            equities = calculate_equities(table, card_masks, &_performance_stats, ranges);
+        }
+    }
+    const scoped_latency_timer recommendation_timer(&_performance_stats, pipeline_stage::recommendation);
+    if (table.get_acting_player().pocket_cards)
+    {
+        analysis.hand = classify_hand(card_masks.pockets.at(table.acting_player_pos), card_masks.board, card_masks.dead);
+    }
+    analysis.equity = equities.at(table.acting_player_pos);
     analysis.pot_equity = calculate_pot_equity(table.pot, amount_to_call);
 
+    recommend_chip_ev_action(table, equities, raise_pot_ratio_begin, raise_pot_ratio_end, analysis);
+
+    if (!_icm_calculator)
+    {
+        return analysis;
+    }
+
+    std::vector<player_action_t> actions{player_action_check_or_call{}};
+    if (amount_to_call > 0)
+    {
+        actions.emplace_back(player_action_fold{});
+    }
+    if (std::holds_alternative<player_action_raise>(analysis.recommended_action))
+    {
+        actions.emplace_back(analysis.recommended_action);
+    }
+
+    for (const auto &action : actions)
+    {
+        analysis.action_payouts.emplace_back(action_payout{action, calculate_action_icm_payout(table, equities, action, *_icm_calculator)});
+    }
+
+    _performance_stats.set_counter(performance_counter::icm_cache_hits, _icm_calculator->get_num_of_cache_hits());
+
+    const auto best = std::max_element(analysis.action_payouts.begin(), analysis.action_payouts.end(),
+                                       [](const auto &lhs, const auto &rhs){ return lhs.expected_payout < rhs.expected_payout; });
+    analysis.recommended_action = best->action;
+
+    return analysis;
+}
+
+void my_poker_lib::recommend_chip_ev_action(const table_state &table,
+                                            const std::vector<double> &equities,
+                                            const double raise_pot_ratio_begin,
+                                            const double raise_pot_ratio_end,
+                                            player_analysis &analysis)
+{
+    const auto amount_to_call = table.get_acting_player_amount_to_call();
+
+    if (_heads_up_policy)
+    {
+        if (const auto action = _heads_up_policy->get_recommended_action(table))
+        {
+            _performance_stats.add_to_counter(performance_counter::heads_up_policy_hits, 1);
+            analysis.recommended_action = *action;
+            return;
+        }
+    }
+
+    if (_look_ahead_config)
+    {
+        auto config = *_look_ahead_config;
+        config.raise_pot_ratios = {raise_pot_ratio_begin, raise_pot_ratio_end};
+
+        const scoped_latency_timer search_timer(&_performance_stats, pipeline_stage::look_ahead_search);
+        const auto result = search_best_action(table, equities, config);
+        _performance_stats.add_to_counter(performance_counter::look_ahead_nodes, result.visited_nodes);
+        analysis.recommended_action = result.best_action;
+        for (const auto &root_action : result.root_actions)
+        {
+            if (root_action.action == result.best_action)
+            {
+                analysis.expected_value = root_action.expected_value;
+            }
+        }
+        return;
+    }
+
     if (analysis.pot_equity > analysis.equity)
     {
         analysis.recommended_action = player_action_fold{};
-        return analysis;
+        return;
     }
 
     const auto max_plus_ev_increment = calculate_increment_to_get_pot_eq(table.pot, analysis.equity);
     if (const auto min_raise = amount_to_call + table.pot * raise_pot_ratio_begin; max_plus_ev_increment < min_raise)
     {
         analysis.recommended_action = player_action_check_or_call{};
-        return analysis;
+        return;
     }
 
     auto max_raise = amount_to_call + static_cast<uint64_t>(table.pot * raise_pot_ratio_end);
     max_raise = std::min(max_raise, max_plus_ev_increment);
-    max_raise = std::min(max_raise, table.get_acting_player().current_stack);
+    max_raise = std::min(max_raise, table.get_stack(table.acting_player_pos));
 
     if (max_raise > amount_to_call)
     {
@@ -121,8 +497,6 @@ player_analysis my_poker_lib::make_acting_player_analysis(const table_state &tab
     {
         analysis.recommended_action = player_action_check_or_call{};
     }
-
-    return analysis;
 }
 
 std::unordered_set<size_t> my_poker_lib::get_winner_positions(const table_state &table)
@@ -136,9 +510,9 @@ std::unordered_set<size_t> my_poker_lib::get_winner_positions(const table_state
 
     if (table.get_active_player_count() == 1)
     {
-        for (size_t pos = 0; pos < table.players.size(); ++pos)
+        for (size_t pos = 0; pos < table.get_num_of_players(); ++pos)
         {
-            if (!table.players.at(pos).has_folded())
+            if (!table.has_folded(pos))
             {
                 return {pos};
             }
@@ -151,30 +525,57 @@ std::unordered_set<size_t> my_poker_lib::get_winner_positions(const table_state
         throw std::invalid_argument(oss.str());
     }
 
-    const auto &equity_result = calculate_equity_results(table, true);
+    const scoped_trace_span span("showdown", "get_winner_positions");
+    const auto board_mask = omp::CardRange::getCardMask(table.communal_cards);
 
-    if (equity_result.evaluations != 1)
+    std::vector<size_t> positions;
+    std::vector<seven_cards> hands;
+    uint64_t dealt_cards = board_mask;
+    for (size_t pos = 0; pos < table.get_num_of_players(); ++pos)
     {
-        oss << "During showdown only one evaluation is expected but got " << equity_result.evaluations << " instead. Table: " << table;
-        throw std::logic_error(oss.str());
-    }
+        if (table.has_folded(pos))
+        {
+            continue;
+        }
 
-    std::unordered_set<size_t> winners;
+        const auto &player = table.players.at(pos);
+        if (!player.pocket_cards)
+        {
+            oss << "During showdown active player " << player.player_name << " has no pocket cards set";
+            throw std::runtime_error(oss.str());
+        }
 
-    size_t equity_pos = 0;
-    for (const auto &player : table.players)
-    {
-        if (player.has_folded())
+        const auto pocket_mask = omp::CardRange::getCardMask(*player.pocket_cards);
+        if (omp::bitCount(pocket_mask) != 2 || (pocket_mask & dealt_cards))
         {
-            continue;
+            oss << "Cannot evaluate table. Table: " << table;
+            throw std::invalid_argument(oss.str());
         }
+        dealt_cards |= pocket_mask;
 
-        // OMPEval is a bit odd in case of multiple winners this both wins and ties are checked
-        if (equity_result.wins.at(equity_pos) || equity_result.ties.at(equity_pos))
+        positions.emplace_back(pos);
+        hands.emplace_back();
+        size_t card_index = 0;
+        for (uint8_t card = 0; card < 52; ++card)
+        {
+            if ((board_mask | pocket_mask) & (uint64_t{1} << card))
+            {
+                hands.back()[card_index++] = card;
+            }
+        }
+    }
+
+    std::vector<uint32_t> hand_values(hands.size());
+    _hand_evaluator.evaluate(hands.data(), hands.size(), hand_values.data());
+
+    const auto best_value = *std::max_element(hand_values.begin(), hand_values.end());
+    std::unordered_set<size_t> winners;
+    for (size_t index = 0; index < positions.size(); ++index)
+    {
+        if (hand_values[index] == best_value)
         {
-            winners.emplace(equity_pos);
+            winners.emplace(positions[index]);
         }
-        ++equity_pos;
     }
 
     return winners;
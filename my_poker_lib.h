@@ -1,24 +1,99 @@
 #pragma once
 
+#include <memory>
+#include <optional>
+
+#include "batch_hand_evaluator.h"
+#include "equity_engine.h"
+#include "flop_equity_database.h"
+#include "heads_up_solver.h"
 #include "i_my_poker_lib.h"
+#include "icm.h"
+#include "look_ahead_search.h"
+#include "opponent_stats.h"
+#include "range_narrowing.h"
 
 namespace poker_lib {
 
-std::vector<double> calculate_equities(const table_state &table);
+// Latencies and counters are recorded into stats if given. Players with unknown pocket cards hold the hands of their
+// range in OMPEval's format, indexed by table position, or random ones if it's empty, missing or blocked completely by
+// the known cards.
+std::vector<double> calculate_equities(const table_state &table,
+                                       performance_stats *stats = nullptr,
+                                       const std::vector<std::string> &ranges = {});
+// Same with the table's cards parsed by the caller
+std::vector<double> calculate_equities(const table_state &table,
+                                       const table_card_masks &card_masks,
+                                       performance_stats *stats = nullptr,
+                                       const std::vector<std::string> &ranges = {});
 double calculate_pot_equity(uint64_t pot, uint64_t increment);
 uint64_t calculate_increment_to_get_pot_eq(uint64_t pot, double equity);
+// Expected tournament payout of the acting player taking the action. Every active opponent is assumed to call as far
+// as their stack allows. Each side pot goes to one of the players eligible for it with a probability in proportion to
+// their equity.
+double calculate_action_icm_payout(const table_state &table,
+                                   const std::vector<double> &equities,
+                                   const player_action_t &action,
+                                   icm_calculator &calculator);
 
 class my_poker_lib : public i_my_poker_lib
 {
 public:
+    my_poker_lib() = default;
+    // Recommendations come from a look-ahead search instead of comparing equity to pot odds
+    explicit my_poker_lib(look_ahead_config config);
     ~my_poker_lib() override = default;
 
+    // Heads-up spots covered by policy are recommended from it instead of being analysed
+    void set_heads_up_policy(std::shared_ptr<const heads_up_policy> policy) { _heads_up_policy = std::move(policy); }
+
+    // Recommendations maximise the expected tournament payout instead of chips. payouts[n] is the prize for place n + 1.
+    void set_tournament_payouts(std::vector<double> payouts) { _icm_calculator = std::make_shared<icm_calculator>(std::move(payouts)); }
+
+    // Equities come from the seeded engine so the same spot always gets the same recommendation
+    void set_equity_engine(equity_engine_config config) { _equity_engine_config = config; }
+
+    // Equity workers only run on cpus and the hand evaluator gets its own tables allocated on their NUMA node.
+    // Hosts running many tables give each table's instance the CPUs of one node, see get_numa_node_cpus.
+    void set_worker_cpus(std::vector<size_t> cpus);
+
+    // Heads-up flop equities against a random hand are looked up in database instead of being simulated
+    void set_flop_equity_database(std::shared_ptr<const flop_equity_database> database) { _flop_equity_database = std::move(database); }
+
+    // Opponents' ranges come from store which learns from every finished round. It's saved to path after each
+    // round if path isn't empty.
+    void set_opponent_stats(std::shared_ptr<opponent_stats_store> store, std::string path = "");
+
     size_t get_num_of_parsed_cards(const std::string &cards) const override;
 
     player_analysis make_acting_player_analysis(const table_state &table,
                                                 double raise_pot_ratio_begin,
                                                 double raise_pot_ratio_end) override;
     std::unordered_set<size_t> get_winner_positions(const table_state &table) override;
+    // Narrows the player's range, starting from the VPIP in the opponent stats if there are enough hands of the player
+    void record_action(const table_state &table, const player_action_t &action) override;
+    void record_finished_round(const table_state &table) override;
+
+    performance_stats& get_performance_stats() override { return _performance_stats; }
+
+private:
+    void recommend_chip_ev_action(const table_state &table,
+                                  const std::vector<double> &equities,
+                                  double raise_pot_ratio_begin,
+                                  double raise_pot_ratio_end,
+                                  player_analysis &analysis);
+
+    std::optional<look_ahead_config> _look_ahead_config;
+    std::shared_ptr<const heads_up_policy> _heads_up_policy;
+    std::shared_ptr<icm_calculator> _icm_calculator;
+    std::optional<equity_engine_config> _equity_engine_config;
+    std::shared_ptr<const flop_equity_database> _flop_equity_database;
+    std::shared_ptr<opponent_stats_store> _opponent_stats;
+    std::string _opponent_stats_path;
+    range_tracker _range_tracker;
+    std::vector<size_t> _worker_cpus;
+    performance_stats _performance_stats;
+    batch_hand_evaluator _hand_evaluator;
 };
 
 } // end of namespace poker_lib
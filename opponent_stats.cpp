@@ -0,0 +1,369 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+#include "opponent_stats.h"
+
+namespace poker_lib {
+
+static double get_ratio(const uint32_t count, const uint32_t total)
+{
+    return total ? static_cast<double>(count) / total : 0;
+}
+
+double opponent_stats::get_vpip() const
+{
+    return get_ratio(num_of_voluntary_hands, num_of_hands);
+}
+
+double opponent_stats::get_pre_flop_raise_ratio() const
+{
+    return get_ratio(num_of_pre_flop_raises, num_of_hands);
+}
+
+double opponent_stats::get_aggression_factor() const
+{
+    return num_of_calls ? static_cast<double>(num_of_bets_and_raises) / num_of_calls : num_of_bets_and_raises;
+}
+
+double opponent_stats::get_fold_to_continuation_bet_ratio() const
+{
+    return get_ratio(num_of_folds_to_continuation_bets, num_of_faced_continuation_bets);
+}
+
+bool operator==(const opponent_stats &lhs, const opponent_stats &rhs)
+{
+    return lhs.num_of_hands == rhs.num_of_hands &&
+           lhs.num_of_voluntary_hands == rhs.num_of_voluntary_hands &&
+           lhs.num_of_pre_flop_raises == rhs.num_of_pre_flop_raises &&
+           lhs.num_of_bets_and_raises == rhs.num_of_bets_and_raises &&
+           lhs.num_of_calls == rhs.num_of_calls &&
+           lhs.num_of_faced_continuation_bets == rhs.num_of_faced_continuation_bets &&
+           lhs.num_of_folds_to_continuation_bets == rhs.num_of_folds_to_continuation_bets;
+}
+
+//
+// Ranges
+//
+
+struct pre_flop_hand
+{
+    std::string name;
+    size_t num_of_combos;
+    double score;
+};
+
+double get_chen_score(const size_t high_rank, const size_t low_rank, const bool is_suited)
+{
+    static constexpr std::array<double, 13> high_card_points{1, 1.5, 2, 2.5, 3, 3.5, 4, 4.5, 5, 6, 7, 8, 10};
+
+    if (high_rank == low_rank)
+    {
+        return std::max(5.0, 2 * high_card_points[high_rank]);
+    }
+
+    auto score = high_card_points[high_rank] + (is_suited ? 2 : 0);
+    const auto gap = high_rank - low_rank - 1;
+    static constexpr std::array<double, 5> gap_penalties{0, 1, 2, 4, 5};
+    score -= gap_penalties[std::min<size_t>(gap, 4)];
+    // Connectors below a queen make more straights
+    if (gap <= 1 && high_rank < 10)
+    {
+        score += 1;
+    }
+    return std::ceil(score);
+}
+
+static const std::vector<pre_flop_hand>& get_pre_flop_hands_by_strength()
+{
+    static const auto hands = []()
+    {
+        constexpr char rank_names[] = "23456789TJQKA";
+
+        std::vector<pre_flop_hand> result;
+        for (size_t high_rank = 13; high_rank-- > 0;)
+        {
+            for (size_t low_rank = high_rank + 1; low_rank-- > 0;)
+            {
+                const std::string name{rank_names[high_rank], rank_names[low_rank]};
+                if (high_rank == low_rank)
+                {
+                    result.push_back({name, 6, get_chen_score(high_rank, low_rank, false)});
+                    continue;
+                }
+                result.push_back({name + 's', 4, get_chen_score(high_rank, low_rank, true)});
+                result.push_back({name + 'o', 12, get_chen_score(high_rank, low_rank, false)});
+            }
+        }
+        // Ties keep the higher cards first
+        std::stable_sort(result.begin(), result.end(), [](const auto &lhs, const auto &rhs){ return lhs.score > rhs.score; });
+        return result;
+    }();
+    return hands;
+}
+
+std::string get_top_hands_range(const double fraction)
+{
+    constexpr size_t num_of_combos = 1326;
+
+    std::string result;
+    size_t num_of_range_combos = 0;
+    for (const auto &hand : get_pre_flop_hands_by_strength())
+    {
+        if (num_of_range_combos >= fraction * num_of_combos)
+        {
+            break;
+        }
+        if (!result.empty())
+        {
+            result += ',';
+        }
+        result += hand.name;
+        num_of_range_combos += hand.num_of_combos;
+    }
+    return result;
+}
+
+//
+// Store
+//
+
+void opponent_stats_store::update_range(player_entry &entry)
+{
+    const auto &stats = entry.stats;
+    entry.range = stats.num_of_hands >= min_num_of_hands_for_range && stats.num_of_voluntary_hands > 0
+        ? get_top_hands_range(stats.get_vpip())
+        : std::string{};
+}
+
+static bool is_raise(const player_action_t &action)
+{
+    return std::holds_alternative<player_action_raise>(action);
+}
+
+void opponent_stats_store::update(const table_state &table)
+{
+    constexpr std::array<game_stages, num_of_betting_rounds> betting_rounds{game_stages::pre_flop_betting_round,
+                                                                             game_stages::flop_betting_round,
+                                                                             game_stages::turn_betting_round,
+                                                                             game_stages::river_betting_round};
+
+    const auto num_of_players = table.get_num_of_players();
+    if (num_of_players < 2)
+    {
+        return;
+    }
+
+    // Heads-up the dealer posts the small blind
+    const auto small_blind_pos = num_of_players == 2 ? table.dealer_pos : get_next_pos(table.dealer_pos, num_of_players);
+    const auto big_blind_pos = get_next_pos(small_blind_pos, num_of_players);
+
+    // Every player still in the hand acts once per pass around the table, so the n-th action of a player on a street
+    // was made in the n-th pass. After the flop the passes start left of the dealer.
+    const auto get_post_flop_turn = [&](const size_t pos, const size_t action_index)
+    {
+        return action_index * num_of_players + (pos + num_of_players - table.dealer_pos - 1) % num_of_players;
+    };
+    constexpr auto no_raise = std::numeric_limits<size_t>::max();
+
+    std::array<seat_mask_t, num_of_betting_rounds> raiser_masks{};
+    std::array<std::array<size_t, max_num_of_players>, num_of_betting_rounds> first_raise_turns;
+    for (auto &turns : first_raise_turns)
+    {
+        turns.fill(no_raise);
+    }
+    for (size_t pos = 0; pos < num_of_players; ++pos)
+    {
+        for (size_t round = 0; round < num_of_betting_rounds; ++round)
+        {
+            const auto &actions = table.players.at(pos).get_actions(betting_rounds[round]);
+            const auto raise = std::find_if(actions.begin(), actions.end(), is_raise);
+            if (raise != actions.end())
+            {
+                raiser_masks[round] |= get_seat_bit(pos);
+                if (round > 0)
+                {
+                    first_raise_turns[round][pos] = get_post_flop_turn(pos, static_cast<size_t>(raise - actions.begin()));
+                }
+            }
+        }
+    }
+
+    // The order of raises between players isn't recorded so the pre-flop aggressor is only known if there was one
+    const bool has_single_aggressor = count_seats(raiser_masks[0]) == 1;
+    size_t aggressor_pos = 0;
+    while (has_single_aggressor && !(raiser_masks[0] & get_seat_bit(aggressor_pos)))
+    {
+        ++aggressor_pos;
+    }
+    const auto &aggressor_flop_actions = table.players.at(aggressor_pos).per_betting_state.flop_bets;
+    const bool has_continuation_bet = has_single_aggressor && !aggressor_flop_actions.empty() && is_raise(aggressor_flop_actions.front());
+
+    for (size_t pos = 0; pos < num_of_players; ++pos)
+    {
+        const auto &player = table.players.at(pos);
+        auto &entry = _players[player.player_name];
+        auto &stats = entry.stats;
+        const auto others_mask = static_cast<seat_mask_t>(~get_seat_bit(pos));
+
+        ++stats.num_of_hands;
+
+        const auto &pre_flop_actions = player.per_betting_state.pre_flop_bets;
+        const bool has_raised = raiser_masks[0] & get_seat_bit(pos);
+        const bool has_called = std::any_of(pre_flop_actions.begin(), pre_flop_actions.end(),
+                                            [](const auto &action){ return std::holds_alternative<player_action_check_or_call>(action); });
+        // The big blind checking an unraised pot isn't voluntary
+        if (has_raised || (has_called && (pos != big_blind_pos || (raiser_masks[0] & others_mask))))
+        {
+            ++stats.num_of_voluntary_hands;
+        }
+        stats.num_of_pre_flop_raises += has_raised;
+
+        for (size_t round = 1; round < num_of_betting_rounds; ++round)
+        {
+            // Checks and calls look the same, it's a call if somebody else bet earlier on the street
+            size_t first_bet_turn = no_raise;
+            for (size_t other_pos = 0; other_pos < num_of_players; ++other_pos)
+            {
+                if (other_pos != pos)
+                {
+                    first_bet_turn = std::min(first_bet_turn, first_raise_turns[round][other_pos]);
+                }
+            }
+
+            const auto &actions = player.get_actions(betting_rounds[round]);
+            for (size_t action_index = 0; action_index < actions.size(); ++action_index)
+            {
+                const auto &action = actions[action_index];
+                stats.num_of_bets_and_raises += is_raise(action);
+                stats.num_of_calls += std::holds_alternative<player_action_check_or_call>(action) &&
+                                      first_bet_turn < get_post_flop_turn(pos, action_index);
+            }
+        }
+
+        const auto &flop_actions = player.per_betting_state.flop_bets;
+        if (has_continuation_bet && pos != aggressor_pos && !flop_actions.empty())
+        {
+            ++stats.num_of_faced_continuation_bets;
+            if (std::holds_alternative<player_action_fold>(flop_actions.back()) && !(raiser_masks[1] & get_seat_bit(pos)))
+            {
+                ++stats.num_of_folds_to_continuation_bets;
+            }
+        }
+
+        update_range(entry);
+    }
+}
+
+const opponent_stats* opponent_stats_store::find(const std::string &player_name) const
+{
+    const auto it = _players.find(player_name);
+    return it == _players.end() ? nullptr : &it->second.stats;
+}
+
+const std::string& opponent_stats_store::get_range(const std::string &player_name) const
+{
+    static const std::string random_range;
+    const auto it = _players.find(player_name);
+    return it == _players.end() ? random_range : it->second.range;
+}
+
+//
+// Stats file
+//
+
+struct opponent_stats_header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t stats_size;
+    uint64_t num_of_entries;
+};
+
+// Every entry is the length of the name, the name and the stats
+constexpr char stats_file_magic[8] = {'O', 'P', 'P', 'S', 'T', 'A', 'T', 'S'};
+constexpr uint32_t stats_file_version = 1;
+
+opponent_stats_store opponent_stats_store::load(const std::string &path)
+{
+    opponent_stats_store result;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return result;
+    }
+
+    const auto throw_incompatible = [&path]()
+    {
+        throw std::invalid_argument("File " + path + " is not a compatible opponent stats file");
+    };
+
+    opponent_stats_header header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, stats_file_magic, sizeof(header.magic)) != 0 ||
+        header.version != stats_file_version ||
+        header.stats_size != sizeof(opponent_stats))
+    {
+        throw_incompatible();
+    }
+
+    for (uint64_t entry_index = 0; entry_index < header.num_of_entries; ++entry_index)
+    {
+        uint32_t name_size = 0;
+        if (!file.read(reinterpret_cast<char*>(&name_size), sizeof(name_size)))
+        {
+            throw_incompatible();
+        }
+        std::string name(name_size, '\0');
+        player_entry entry;
+        if (!file.read(name.data(), name_size) ||
+            !file.read(reinterpret_cast<char*>(&entry.stats), sizeof(entry.stats)))
+        {
+            throw_incompatible();
+        }
+        result.update_range(entry);
+        result._players.emplace(std::move(name), std::move(entry));
+    }
+    return result;
+}
+
+void opponent_stats_store::save(const std::string &path) const
+{
+    opponent_stats_header header{};
+    std::memcpy(header.magic, stats_file_magic, sizeof(header.magic));
+    header.version = stats_file_version;
+    header.stats_size = sizeof(opponent_stats);
+    header.num_of_entries = _players.size();
+
+    const auto temporary_path = path + ".tmp";
+    {
+        std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const auto &[name, entry] : _players)
+        {
+            const auto name_size = static_cast<uint32_t>(name.size());
+            file.write(reinterpret_cast<const char*>(&name_size), sizeof(name_size));
+            file.write(name.data(), name_size);
+            file.write(reinterpret_cast<const char*>(&entry.stats), sizeof(entry.stats));
+        }
+        if (!file.flush())
+        {
+            throw std::runtime_error("Cannot write opponent stats file " + temporary_path);
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary_path, path, error);
+    if (error)
+    {
+        throw std::runtime_error("Cannot replace opponent stats file " + path + ": " + error.message());
+    }
+}
+
+} // end of namespace poker_lib
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "table/table_state.h"
+
+namespace poker_lib {
+
+// Counters of one player over all the rounds seen. Actions are only recorded per player and street, so the table order
+// after the flop is worked out from the passes around the table and continuation bets are told apart from donk bets
+// approximately.
+struct opponent_stats
+{
+    uint32_t num_of_hands = 0;
+    // Hands the player put chips into the pot pre-flop without being forced to by the blinds
+    uint32_t num_of_voluntary_hands = 0;
+    uint32_t num_of_pre_flop_raises = 0;
+    // After the flop
+    uint32_t num_of_bets_and_raises = 0;
+    uint32_t num_of_calls = 0;
+    uint32_t num_of_faced_continuation_bets = 0;
+    uint32_t num_of_folds_to_continuation_bets = 0;
+
+    double get_vpip() const;
+    double get_pre_flop_raise_ratio() const;
+    // Bets and raises per call after the flop
+    double get_aggression_factor() const;
+    double get_fold_to_continuation_bet_ratio() const;
+};
+bool operator==(const opponent_stats &lhs, const opponent_stats &rhs);
+
+// Stats of every player seen so far keyed by player name
+class opponent_stats_store
+{
+public:
+    // Below this many hands a player's range stays random
+    static constexpr uint32_t min_num_of_hands_for_range = 20;
+
+    opponent_stats_store() = default;
+
+    // An empty store if the file doesn't exist. Throws if it exists but isn't a compatible stats file.
+    static opponent_stats_store load(const std::string &path);
+    // Writes a temporary file first and renames it over path so a crash never leaves a partial file behind.
+    // Throws if it cannot be written.
+    void save(const std::string &path) const;
+
+    // Counts the actions of a finished round in a single pass, must be called before start_new_round clears them.
+    // Ranges of the players in the round are refreshed here so the equity calculations only look them up.
+    void update(const table_state &table);
+
+    // Null if the player hasn't been seen
+    const opponent_stats* find(const std::string &player_name) const;
+    // Hands the player plays voluntarily in OMPEval's range format, e.g. "AA,KK,AKs". Empty for random.
+    const std::string& get_range(const std::string &player_name) const;
+
+    size_t size() const { return _players.size(); }
+
+private:
+    struct player_entry
+    {
+        opponent_stats stats;
+        std::string range;
+    };
+
+    void update_range(player_entry &entry);
+
+    std::unordered_map<std::string, player_entry> _players;
+};
+
+// Bill Chen's pre-flop hand score, ranks go from deuce (0) to ace (12)
+double get_chen_score(size_t high_rank, size_t low_rank, bool is_suited);
+
+// Best pre-flop hands making up at least the given fraction of all the pocket card combinations, in OMPEval's
+// range format. Hands are ordered by the Chen formula.
+std::string get_top_hands_range(double fraction);
+
+} // end of namespace poker_lib
@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <iomanip>
+#include <thread>
+
+#include "performance_stats.h"
+
+namespace poker_lib {
+
+std::ostream &operator<<(std::ostream &os, const pipeline_stage stage)
+{
+    switch (stage)
+    {
+    case pipeline_stage::input_parsing: return os << "input_parsing";
+    case pipeline_stage::equity_setup: return os << "equity_setup";
+    case pipeline_stage::equity_wait: return os << "equity_wait";
+    case pipeline_stage::look_ahead_search: return os << "look_ahead_search";
+    case pipeline_stage::recommendation: return os << "recommendation";
+    case pipeline_stage::output: return os << "output";
+    }
+    return os << "unknown";
+}
+
+std::ostream &operator<<(std::ostream &os, const performance_counter counter)
+{
+    switch (counter)
+    {
+    case performance_counter::equity_calculations: return os << "equity_calculations";
+    case performance_counter::simulated_hands: return os << "simulated_hands";
+    case performance_counter::look_ahead_nodes: return os << "look_ahead_nodes";
+    case performance_counter::heads_up_policy_hits: return os << "heads_up_policy_hits";
+    case performance_counter::icm_cache_hits: return os << "icm_cache_hits";
+    case performance_counter::flop_database_hits: return os << "flop_database_hits";
+    }
+    return os << "unknown";
+}
+
+size_t latency_histogram::get_bucket_index(const uint64_t value)
+{
+    if (value < num_of_sub_buckets)
+    {
+        return static_cast<size_t>(value);
+    }
+
+    // Shift until only the highest sub_bucket_bits + 1 bits are left, the top one is implicit
+    size_t shift = 0;
+    while ((value >> shift) >= 2 * num_of_sub_buckets)
+    {
+        ++shift;
+    }
+    return (shift + 1) * num_of_sub_buckets + static_cast<size_t>((value >> shift) - num_of_sub_buckets);
+}
+
+uint64_t latency_histogram::get_bucket_upper_bound(const size_t index)
+{
+    if (index < num_of_sub_buckets)
+    {
+        return index;
+    }
+
+    const auto shift = index / num_of_sub_buckets - 1;
+    const auto sub_bucket = index % num_of_sub_buckets;
+    return ((num_of_sub_buckets + sub_bucket + 1) << shift) - 1;
+}
+
+void latency_histogram::record(const std::chrono::nanoseconds latency)
+{
+    const auto value = static_cast<uint64_t>(std::max<std::chrono::nanoseconds::rep>(latency.count(), 0));
+
+    _buckets[get_bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(value, std::memory_order_relaxed);
+
+    auto max = _max.load(std::memory_order_relaxed);
+    while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+std::chrono::nanoseconds latency_histogram::get_mean() const
+{
+    const auto count = get_count();
+    return std::chrono::nanoseconds(count ? _sum.load(std::memory_order_relaxed) / count : 0);
+}
+
+std::chrono::nanoseconds latency_histogram::get_percentile(const double percentile) const
+{
+    const auto count = get_count();
+    if (count == 0)
+    {
+        return std::chrono::nanoseconds(0);
+    }
+
+    const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::clamp(percentile, 0.0, 100.0) / 100 * static_cast<double>(count) + 0.5));
+    uint64_t seen = 0;
+    for (size_t index = 0; index < num_of_buckets; ++index)
+    {
+        seen += _buckets[index].load(std::memory_order_relaxed);
+        if (seen >= rank)
+        {
+            return std::chrono::nanoseconds(std::min(get_bucket_upper_bound(index), _max.load(std::memory_order_relaxed)));
+        }
+    }
+    return get_max();
+}
+
+void performance_stats::add_thread_time(const std::chrono::nanoseconds cpu_time, const std::chrono::nanoseconds wall_time)
+{
+    const auto num_of_threads = std::max(1u, std::thread::hardware_concurrency());
+    _cpu_time.fetch_add(static_cast<uint64_t>(cpu_time.count()), std::memory_order_relaxed);
+    _available_thread_time.fetch_add(static_cast<uint64_t>(wall_time.count()) * num_of_threads, std::memory_order_relaxed);
+}
+
+double performance_stats::get_thread_utilization() const
+{
+    const auto available = _available_thread_time.load(std::memory_order_relaxed);
+    return available ? static_cast<double>(_cpu_time.load(std::memory_order_relaxed)) / static_cast<double>(available) : 0;
+}
+
+void performance_stats::dump(std::ostream &os) const
+{
+    const auto to_micros = [](const std::chrono::nanoseconds latency){ return static_cast<double>(latency.count()) / 1000; };
+
+    os << "Latencies (us):\n" << std::left << std::fixed << std::setprecision(1)
+       << std::setw(20) << "stage" << std::setw(10) << "count" << std::setw(12) << "mean"
+       << std::setw(12) << "p50" << std::setw(12) << "p99" << std::setw(12) << "max" << '\n';
+    for (size_t stage = 0; stage < num_of_pipeline_stages; ++stage)
+    {
+        const auto &histogram = _histograms[stage];
+        os << std::setw(20) << static_cast<pipeline_stage>(stage) << std::setw(10) << histogram.get_count()
+           << std::setw(12) << to_micros(histogram.get_mean()) << std::setw(12) << to_micros(histogram.get_percentile(50))
+           << std::setw(12) << to_micros(histogram.get_percentile(99)) << std::setw(12) << to_micros(histogram.get_max()) << '\n';
+    }
+
+    os << "Counters:\n";
+    for (size_t counter = 0; counter < num_of_performance_counters; ++counter)
+    {
+        os << std::setw(20) << static_cast<performance_counter>(counter) << get_counter(static_cast<performance_counter>(counter)) << '\n';
+    }
+    os << std::setw(20) << "thread_utilization" << (100 * get_thread_utilization()) << "%\n";
+}
+
+} // end of namespace poker_lib
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <ostream>
+
+namespace poker_lib {
+
+// Steps of making a recommendation whose latency is measured
+enum class pipeline_stage : size_t
+{
+    input_parsing = 0,
+    equity_setup,
+    equity_wait,
+    // Part of recommendation when a look-ahead search is configured
+    look_ahead_search,
+    // Everything after equities are calculated
+    recommendation,
+    output,
+};
+constexpr size_t num_of_pipeline_stages = 6;
+std::ostream &operator<<(std::ostream &os, pipeline_stage stage);
+
+enum class performance_counter : size_t
+{
+    equity_calculations = 0,
+    // Hands evaluated by equity calculations
+    simulated_hands,
+    look_ahead_nodes,
+    heads_up_policy_hits,
+    icm_cache_hits,
+    flop_database_hits,
+};
+constexpr size_t num_of_performance_counters = 6;
+std::ostream &operator<<(std::ostream &os, performance_counter counter);
+
+// Log-linear buckets of nanoseconds like HDR histograms: every power of two is split into 16 buckets so values are
+// kept with at most 1/16 relative error. Recording is lock free and thread safe.
+class latency_histogram
+{
+public:
+    void record(std::chrono::nanoseconds latency);
+
+    uint64_t get_count() const { return _count.load(std::memory_order_relaxed); }
+    std::chrono::nanoseconds get_mean() const;
+    std::chrono::nanoseconds get_max() const { return std::chrono::nanoseconds(_max.load(std::memory_order_relaxed)); }
+    // Upper bound of the bucket the percentile (between 0 and 100) falls into
+    std::chrono::nanoseconds get_percentile(double percentile) const;
+
+private:
+    static constexpr size_t sub_bucket_bits = 4;
+    static constexpr size_t num_of_sub_buckets = size_t{1} << sub_bucket_bits;
+    static constexpr size_t num_of_buckets = (64 - sub_bucket_bits + 1) * num_of_sub_buckets;
+
+    static size_t get_bucket_index(uint64_t value);
+    static uint64_t get_bucket_upper_bound(size_t index);
+
+    std::array<std::atomic<uint64_t>, num_of_buckets> _buckets{};
+    std::atomic<uint64_t> _count{0};
+    std::atomic<uint64_t> _sum{0};
+    std::atomic<uint64_t> _max{0};
+};
+
+// Always on latency histograms per pipeline stage and counters. Thread safe.
+class performance_stats
+{
+public:
+    void record_latency(pipeline_stage stage, std::chrono::nanoseconds latency) { _histograms[static_cast<size_t>(stage)].record(latency); }
+    const latency_histogram &get_histogram(pipeline_stage stage) const { return _histograms.at(static_cast<size_t>(stage)); }
+
+    void add_to_counter(performance_counter counter, uint64_t value) { _counters[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed); }
+    void set_counter(performance_counter counter, uint64_t value) { _counters[static_cast<size_t>(counter)].store(value, std::memory_order_relaxed); }
+    uint64_t get_counter(performance_counter counter) const { return _counters.at(static_cast<size_t>(counter)).load(std::memory_order_relaxed); }
+
+    // Process CPU time spent while cores were available for wall_time on all hardware threads
+    void add_thread_time(std::chrono::nanoseconds cpu_time, std::chrono::nanoseconds wall_time);
+    // Ratio of the available thread time spent on CPU, 0 if nothing has been measured
+    double get_thread_utilization() const;
+
+    void dump(std::ostream &os) const;
+
+private:
+    std::array<latency_histogram, num_of_pipeline_stages> _histograms;
+    std::array<std::atomic<uint64_t>, num_of_performance_counters> _counters{};
+    std::atomic<uint64_t> _cpu_time{0};
+    std::atomic<uint64_t> _available_thread_time{0};
+};
+
+// Records the time between its construction and destruction
+class scoped_latency_timer
+{
+public:
+    scoped_latency_timer(performance_stats *stats, pipeline_stage stage)
+    :
+        _stats(stats),
+        _stage(stage),
+        _start(stats ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{})
+    {
+    }
+    scoped_latency_timer(const scoped_latency_timer &) = delete;
+    scoped_latency_timer &operator=(const scoped_latency_timer &) = delete;
+
+    ~scoped_latency_timer()
+    {
+        if (_stats)
+        {
+            _stats->record_latency(_stage, std::chrono::steady_clock::now() - _start);
+        }
+    }
+
+private:
+    performance_stats *const _stats;
+    const pipeline_stage _stage;
+    const std::chrono::steady_clock::time_point _start;
+};
+
+// Measures how much of the cores a blocking call kept busy
+class scoped_thread_utilization_timer
+{
+public:
+    explicit scoped_thread_utilization_timer(performance_stats *stats)
+    :
+        _stats(stats),
+        _start_cpu(stats ? std::clock() : 0),
+        _start(stats ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{})
+    {
+    }
+    scoped_thread_utilization_timer(const scoped_thread_utilization_timer &) = delete;
+    scoped_thread_utilization_timer &operator=(const scoped_thread_utilization_timer &) = delete;
+
+    ~scoped_thread_utilization_timer()
+    {
+        if (_stats)
+        {
+            const auto cpu_seconds = static_cast<double>(std::clock() - _start_cpu) / CLOCKS_PER_SEC;
+            _stats->add_thread_time(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(cpu_seconds)),
+                                    std::chrono::steady_clock::now() - _start);
+        }
+    }
+
+private:
+    performance_stats *const _stats;
+    const std::clock_t _start_cpu;
+    const std::chrono::steady_clock::time_point _start;
+};
+
+} // end of namespace poker_lib
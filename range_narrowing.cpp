@@ -0,0 +1,242 @@
+#include <omp/CardRange.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+
+#include "hand_classification.h"
+#include "opponent_stats.h"
+#include "range_narrowing.h"
+
+namespace poker_lib {
+
+size_t get_pocket_combo_index(const uint8_t first_card, const uint8_t second_card)
+{
+    const size_t high_card = std::max(first_card, second_card);
+    const size_t low_card = std::min(first_card, second_card);
+    return high_card * (high_card - 1) / 2 + low_card;
+}
+
+std::array<uint8_t, 2> get_pocket_combo_cards(const size_t combo_index)
+{
+    static const auto combos = []()
+    {
+        std::array<std::array<uint8_t, 2>, num_of_pocket_combos> result{};
+        for (uint8_t high_card = 1; high_card < 52; ++high_card)
+        {
+            for (uint8_t low_card = 0; low_card < high_card; ++low_card)
+            {
+                result[get_pocket_combo_index(high_card, low_card)] = {high_card, low_card};
+            }
+        }
+        return result;
+    }();
+    return combos.at(combo_index);
+}
+
+static uint64_t get_pocket_combo_mask(const size_t combo_index)
+{
+    const auto cards = get_pocket_combo_cards(combo_index);
+    return (uint64_t{1} << cards[0]) | (uint64_t{1} << cards[1]);
+}
+
+std::string get_likely_combos_range(const pocket_combo_weights &weights, const float min_relative_weight)
+{
+    constexpr char rank_names[] = "23456789TJQKA";
+    constexpr char suit_names[] = "shcd";
+
+    const auto max_weight = *std::max_element(weights.begin(), weights.end());
+
+    std::string result;
+    for (size_t combo = 0; combo < num_of_pocket_combos && max_weight > 0; ++combo)
+    {
+        if (weights[combo] < min_relative_weight * max_weight)
+        {
+            continue;
+        }
+        if (!result.empty())
+        {
+            result += ',';
+        }
+        for (const auto card : get_pocket_combo_cards(combo))
+        {
+            result += rank_names[card / 4];
+            result += suit_names[card % 4];
+        }
+    }
+    return result;
+}
+
+void range_tracker::reset()
+{
+    _weights.clear();
+    _is_narrowed.clear();
+}
+
+// Orders combos on the board, a combo of a higher key is stronger. Pre-flop it's the Chen score, after the flop it's
+// the made hand, then the draws, then the pocket cards' ranks.
+static uint32_t get_strength_key(const size_t combo_index, const uint64_t board_mask)
+{
+    const auto cards = get_pocket_combo_cards(combo_index);
+    const size_t high_rank = cards[0] / 4;
+    const size_t low_rank = cards[1] / 4;
+    if (!board_mask)
+    {
+        // Chen scores are whole numbers from -1
+        const auto score = get_chen_score(std::max(high_rank, low_rank), std::min(high_rank, low_rank), cards[0] % 4 == cards[1] % 4);
+        return static_cast<uint32_t>(2 * (score + 1));
+    }
+
+    const auto hand = classify_hand(get_pocket_combo_mask(combo_index), board_mask);
+    const uint32_t draw = (hand.has_flush_draw || hand.has_open_ended_straight_draw) ? 2 : hand.has_gutshot;
+    return ((static_cast<uint32_t>(hand.made_hand) * 3 + draw) * 13 + static_cast<uint32_t>(std::max(high_rank, low_rank))) * 13 +
+           static_cast<uint32_t>(std::min(high_rank, low_rank));
+}
+
+pocket_combo_weights get_vpip_prior_weights(const double vpip)
+{
+    // Strongest first, the strength keys before the flop don't depend on the board
+    static const auto combos_by_strength = []()
+    {
+        std::array<std::pair<uint32_t, size_t>, num_of_pocket_combos> result{};
+        for (size_t combo = 0; combo < num_of_pocket_combos; ++combo)
+        {
+            result[combo] = {get_strength_key(combo, 0), combo};
+        }
+        std::sort(result.begin(), result.end(), std::greater<>());
+        return result;
+    }();
+
+    pocket_combo_weights weights;
+    weights.fill(min_vpip_prior_weight);
+    const auto num_of_top_combos = static_cast<size_t>(std::ceil(std::clamp(vpip, 0.0, 1.0) * num_of_pocket_combos));
+    if (num_of_top_combos == 0)
+    {
+        return weights;
+    }
+
+    // Combos as strong as the weakest top one are played as well
+    const auto min_top_key = combos_by_strength[num_of_top_combos - 1].first;
+    for (const auto &[key, combo] : combos_by_strength)
+    {
+        if (key < min_top_key)
+        {
+            break;
+        }
+        weights[combo] = 1;
+    }
+    return weights;
+}
+
+void range_tracker::calculate_likelihoods(const uint64_t board_mask, action_likelihoods &likelihoods)
+{
+    std::vector<std::pair<uint32_t, size_t>> keyed_combos;
+    keyed_combos.reserve(num_of_pocket_combos);
+    for (size_t combo = 0; combo < num_of_pocket_combos; ++combo)
+    {
+        if (!(get_pocket_combo_mask(combo) & board_mask))
+        {
+            keyed_combos.emplace_back(get_strength_key(combo, board_mask), combo);
+        }
+    }
+    std::sort(keyed_combos.begin(), keyed_combos.end());
+
+    // Strength is the percentile of the combo among the ones the board doesn't block, equal keys share it
+    for (auto &kind_likelihoods : likelihoods)
+    {
+        kind_likelihoods.fill(0);
+    }
+    for (size_t first = 0; first < keyed_combos.size();)
+    {
+        auto last = first;
+        while (last < keyed_combos.size() && keyed_combos[last].first == keyed_combos[first].first)
+        {
+            ++last;
+        }
+
+        const auto strength = static_cast<float>(first + last) / 2 / static_cast<float>(keyed_combos.size());
+        for (auto index = first; index < last; ++index)
+        {
+            const auto combo = keyed_combos[index].second;
+            // Strong hands check less, call more and raise much more. Weak hands still raise sometimes as bluffs.
+            likelihoods[check][combo] = 1 - 0.6f * strength * strength;
+            likelihoods[call][combo] = 0.2f + 0.8f * strength;
+            likelihoods[raise][combo] = 0.1f + 0.9f * strength * strength * strength;
+        }
+        first = last;
+    }
+}
+
+const range_tracker::action_likelihoods& range_tracker::get_likelihoods(const uint64_t board_mask)
+{
+    const auto it = _likelihoods_by_board.find(board_mask);
+    if (it != _likelihoods_by_board.end())
+    {
+        return it->second;
+    }
+
+    if (_likelihoods_by_board.size() >= max_num_of_cached_boards)
+    {
+        _likelihoods_by_board.clear();
+    }
+    auto &likelihoods = _likelihoods_by_board[board_mask];
+    calculate_likelihoods(board_mask, likelihoods);
+    return likelihoods;
+}
+
+void range_tracker::observe_action(const table_state &table, const player_action_t &action, const pocket_combo_weights *prior)
+{
+    if (std::holds_alternative<player_action_fold>(action))
+    {
+        // A folded player's range doesn't matter anymore
+        return;
+    }
+
+    if (_weights.size() != table.get_num_of_players())
+    {
+        _weights.resize(table.get_num_of_players());
+        _is_narrowed.assign(table.get_num_of_players(), false);
+    }
+
+    const auto kind = std::holds_alternative<player_action_raise>(action)
+        ? raise
+        : (table.get_acting_player_amount_to_call() > 0 ? call : check);
+    const auto &likelihoods = get_likelihoods(omp::CardRange::getCardMask(table.communal_cards))[kind];
+
+    auto &weights = _weights.at(table.acting_player_pos);
+    if (!_is_narrowed[table.acting_player_pos])
+    {
+        const bool is_voluntary = kind != check || table.current_stage != game_stages::pre_flop_betting_round;
+        if (prior && is_voluntary)
+        {
+            weights = *prior;
+        }
+        else
+        {
+            weights.fill(1);
+        }
+    }
+
+    for (size_t combo = 0; combo < num_of_pocket_combos; ++combo)
+    {
+        weights[combo] *= likelihoods[combo];
+    }
+    const auto total_weight = std::accumulate(weights.begin(), weights.end(), 0.0f);
+    // Keeps the mean weight at 1 so repeated updates don't underflow
+    if (total_weight > 0)
+    {
+        const auto scale = static_cast<float>(num_of_pocket_combos) / total_weight;
+        for (auto &weight : weights)
+        {
+            weight *= scale;
+        }
+    }
+    _is_narrowed[table.acting_player_pos] = true;
+}
+
+const pocket_combo_weights* range_tracker::get_weights(const size_t player_pos) const
+{
+    return player_pos < _weights.size() && _is_narrowed[player_pos] ? &_weights[player_pos] : nullptr;
+}
+
+} // end of namespace poker_lib
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "table/table_state.h"
+
+namespace poker_lib {
+
+constexpr size_t num_of_pocket_combos = 1326;
+
+// Relative probability of each two card combination, indexed by get_pocket_combo_index
+using pocket_combo_weights = std::array<float, num_of_pocket_combos>;
+
+// Cards are indexed like in OMPEval and must differ
+size_t get_pocket_combo_index(uint8_t first_card, uint8_t second_card);
+std::array<uint8_t, 2> get_pocket_combo_cards(size_t combo_index);
+
+// Combos with at least min_relative_weight of the heaviest combo's weight in OMPEval's range format, e.g. "AhKh,AsKs"
+std::string get_likely_combos_range(const pocket_combo_weights &weights, float min_relative_weight);
+
+// Weight of the combos outside a player's top hands in get_vpip_prior_weights, players misplay some hands
+constexpr float min_vpip_prior_weight = 0.1f;
+// Range of a player who plays the top vpip fraction of the hands by Chen score, the others keep min_vpip_prior_weight
+pocket_combo_weights get_vpip_prior_weights(double vpip);
+
+// Narrows every player's range with Bayes' rule as their actions are observed. Each combo's weight is multiplied by
+// the likelihood of the action given how strong the combo is on the current board. Likelihoods of every combo are
+// computed once per board and kept for the next rounds, so observing an action is a multiplication of two flat arrays.
+class range_tracker
+{
+public:
+    // Boards whose likelihoods are kept before starting over. Every round starts with the same pre-flop ones.
+    static constexpr size_t max_num_of_cached_boards = 64;
+
+    // Every player's range goes back to all the combos, e.g. when a new round starts
+    void reset();
+
+    // table is the state right before the acting player takes action. The first action of a player since the last
+    // reset narrows prior, e.g. from get_vpip_prior_weights, if given. A check pre-flop isn't voluntary so it narrows
+    // all the combos instead.
+    void observe_action(const table_state &table, const player_action_t &action, const pocket_combo_weights *prior = nullptr);
+
+    // Null if no action of the player has been observed since the last reset
+    const pocket_combo_weights* get_weights(size_t player_pos) const;
+
+private:
+    enum likelihood_kind
+    {
+        check,
+        call,
+        raise,
+        num_of_likelihood_kinds,
+    };
+
+    using action_likelihoods = std::array<pocket_combo_weights, num_of_likelihood_kinds>;
+
+    static void calculate_likelihoods(uint64_t board_mask, action_likelihoods &likelihoods);
+    const action_likelihoods& get_likelihoods(uint64_t board_mask);
+
+    std::vector<pocket_combo_weights> _weights;
+    std::vector<bool> _is_narrowed;
+
+    // Keyed by the board's card mask
+    std::unordered_map<uint64_t, action_likelihoods> _likelihoods_by_board;
+};
+
+} // end of namespace poker_lib
@@ -6,10 +6,11 @@
 
 namespace poker_lib {
 
-streamed_user_interaction::streamed_user_interaction(std::ostream &os, std::istream &is)
+streamed_user_interaction::streamed_user_interaction(std::ostream &os, std::istream &is, const bool asks_for_dead_cards)
 :
     _os(os),
-    _is(is)
+    _is(is),
+    _asks_for_dead_cards(asks_for_dead_cards)
 {
 }
 
@@ -53,6 +54,19 @@ std::string streamed_user_interaction::get_river()
     return card;
 }
 
+std::string streamed_user_interaction::get_dead_cards()
+{
+    if (!_asks_for_dead_cards)
+    {
+        return {};
+    }
+
+    _os << "Which cards are known to be dead, e.g. burned or exposed? Leave empty if none\n";
+    std::string cards;
+    getline(_is, cards);
+    return cards;
+}
+
 player_action_t streamed_user_interaction::get_user_action()
 {
     return read_player_action();
@@ -10,7 +10,8 @@ namespace poker_lib {
 class streamed_user_interaction : public i_user_interaction
 {
 public:
-    streamed_user_interaction(std::ostream& os, std::istream& is);
+    // Dead cards are only asked for if asks_for_dead_cards, otherwise there are none
+    streamed_user_interaction(std::ostream& os, std::istream& is, bool asks_for_dead_cards = false);
     ~streamed_user_interaction() override = default;
 
     std::string get_user_pocket_cards() override;
@@ -18,6 +19,7 @@ public:
     std::string get_flop() override;
     std::string get_turn() override;
     std::string get_river() override;
+    std::string get_dead_cards() override;
 
     player_action_t get_user_action() override;
     player_action_t get_opponent_action() override;
@@ -29,6 +31,7 @@ private:
 
     std::ostream& _os;
     std::istream& _is;
+    const bool _asks_for_dead_cards;
 };
 
 } // end of namespace poker_lib
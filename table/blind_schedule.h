@@ -0,0 +1,27 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace poker_lib {
+
+struct blind_level
+{
+    uint64_t small_blind_size = 0;
+    uint64_t big_blind_size = 0;
+    // Posted by every player before the blinds
+    uint64_t ante_size = 0;
+};
+
+// Levels are moved through at the start of rounds. The last level stays once it's reached.
+struct blind_schedule
+{
+    std::vector<blind_level> levels;
+    // Rounds played at a level before moving to the next one, 0 disables it
+    size_t rounds_per_level = 0;
+    // Time spent at a level before moving to the next one, 0 disables it. Whichever of the two is further ahead wins.
+    std::chrono::seconds level_duration{0};
+};
+
+} // end of namespace poker_lib
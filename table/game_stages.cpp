@@ -1,28 +1,34 @@
 #include <type_traits>
 #include <sstream>
+#include <stdexcept>
 #include "game_stages.h"
 
-#define HANDLE_GAME_STAGE_OSTREAM(name) case poker_lib::game_stages::name: return os << #name;
+#define HANDLE_GAME_STAGE_NAME(name) case poker_lib::game_stages::name: return #name;
 
 namespace poker_lib {
 
 std::ostream &operator<<(std::ostream &os, const game_stages stage)
+{
+    return os << get_game_stage_name(stage);
+}
+
+const char* get_game_stage_name(const game_stages stage)
 {
     switch (stage)
     {
-    HANDLE_GAME_STAGE_OSTREAM(deal_pocket_cards);
-    HANDLE_GAME_STAGE_OSTREAM(pre_flop_betting_round);
-    HANDLE_GAME_STAGE_OSTREAM(deal_communal_cards);
-    HANDLE_GAME_STAGE_OSTREAM(flop_betting_round);
-    HANDLE_GAME_STAGE_OSTREAM(deal_turn_card);
-    HANDLE_GAME_STAGE_OSTREAM(turn_betting_round);
-    HANDLE_GAME_STAGE_OSTREAM(deal_river_card);
-    HANDLE_GAME_STAGE_OSTREAM(river_betting_round);
-    HANDLE_GAME_STAGE_OSTREAM(showdown);
-    HANDLE_GAME_STAGE_OSTREAM(end_of_round);
+    HANDLE_GAME_STAGE_NAME(deal_pocket_cards);
+    HANDLE_GAME_STAGE_NAME(pre_flop_betting_round);
+    HANDLE_GAME_STAGE_NAME(deal_communal_cards);
+    HANDLE_GAME_STAGE_NAME(flop_betting_round);
+    HANDLE_GAME_STAGE_NAME(deal_turn_card);
+    HANDLE_GAME_STAGE_NAME(turn_betting_round);
+    HANDLE_GAME_STAGE_NAME(deal_river_card);
+    HANDLE_GAME_STAGE_NAME(river_betting_round);
+    HANDLE_GAME_STAGE_NAME(showdown);
+    HANDLE_GAME_STAGE_NAME(end_of_round);
     }
 
-    return os << "unknown";
+    return "unknown";
 }
 
 game_stages get_next_game_stage(const game_stages stage)
@@ -35,4 +41,38 @@ game_stages get_next_game_stage(const game_stages stage)
     return static_cast<game_stages>(is_okay_to_increment ? (stage_val + 1) : stage_val);
 }
 
+bool is_betting_round(const game_stages stage)
+{
+    return stage == game_stages::pre_flop_betting_round ||
+           stage == game_stages::flop_betting_round ||
+           stage == game_stages::turn_betting_round ||
+           stage == game_stages::river_betting_round;
+}
+
+size_t get_betting_round_index(const game_stages stage)
+{
+    switch (stage)
+    {
+    case game_stages::deal_pocket_cards:
+    case game_stages::pre_flop_betting_round:
+        return 0;
+
+    case game_stages::deal_communal_cards:
+    case game_stages::flop_betting_round:
+        return 1;
+
+    case game_stages::deal_turn_card:
+    case game_stages::turn_betting_round:
+        return 2;
+
+    case game_stages::deal_river_card:
+    case game_stages::river_betting_round:
+    case game_stages::showdown:
+    case game_stages::end_of_round:
+        return 3;
+    }
+
+    throw std::invalid_argument("Unknown stage enum value");
+}
+
 } // end of namespace poker_lib
\ No newline at end of file
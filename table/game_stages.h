@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <ostream>
 
 namespace poker_lib {
@@ -18,7 +19,15 @@ enum class game_stages
     end_of_round,
 };
 std::ostream& operator<<(std::ostream& os, game_stages stage);
+// Name of the stage as a string literal
+const char* get_game_stage_name(game_stages stage);
 
 game_stages get_next_game_stage(game_stages stage);
 
+bool is_betting_round(game_stages stage);
+
+// Index of the betting round a stage belongs to: 0 for pre-flop, 1 for flop, 2 for turn and 3 for river.
+// Card dealing stages belong to the betting round that follows them while showdown and end of round belong to river.
+size_t get_betting_round_index(game_stages stage);
+
 } // end of namespace poker_lib
@@ -1,9 +1,13 @@
 #include <algorithm>
+#include <cctype>
+#include <optional>
 #include <sstream>
+#include <string_view>
 #include <type_traits>
 #include <set>
 
 #include "holdem_table_state_manager.h"
+#include "table_state_hash.h"
 
 static void throw_if_unexpected_call(const poker_lib::game_stages current_stage,
                                      const poker_lib::game_stages expected_stage,
@@ -20,6 +24,34 @@ static void throw_if_unexpected_call(const poker_lib::game_stages current_stage,
 
 namespace poker_lib {
 
+// Card mask of whitespace separated cards like "As Td", nullopt if any of them can't be parsed or is repeated
+static std::optional<uint64_t> parse_cards(const std::string &cards)
+{
+    constexpr std::string_view ranks = "23456789TJQKA";
+    constexpr std::string_view suits = "SHCD";
+
+    uint64_t mask = 0;
+    std::istringstream iss(cards);
+    std::string card;
+    while (iss >> card)
+    {
+        const auto rank = card.size() == 2 ? ranks.find(static_cast<char>(std::toupper(card[0]))) : std::string_view::npos;
+        const auto suit = card.size() == 2 ? suits.find(static_cast<char>(std::toupper(card[1]))) : std::string_view::npos;
+        if (rank == std::string_view::npos || suit == std::string_view::npos)
+        {
+            return std::nullopt;
+        }
+
+        const auto bit = uint64_t{1} << (4 * rank + suit);
+        if (mask & bit)
+        {
+            return std::nullopt;
+        }
+        mask |= bit;
+    }
+    return mask;
+}
+
 static game_stages get_next_card_deal_turn(const game_stages stage)
 {
     switch (stage)
@@ -53,8 +85,22 @@ holdem_table_state_manager::holdem_table_state_manager(const std::vector<initial
                                                        const uint64_t small_blind_size,
                                                        const uint64_t big_blind_size)
 :
-    _table_state()
+    holdem_table_state_manager(players, dealer_position, blind_schedule{{{small_blind_size, big_blind_size, 0}}})
 {
+}
+
+holdem_table_state_manager::holdem_table_state_manager(const std::vector<initial_player_state> &players,
+                                                       const size_t dealer_position,
+                                                       blind_schedule schedule)
+:
+    _table_state(),
+    _blind_schedule(std::move(schedule))
+{
+    if (_blind_schedule.levels.empty())
+    {
+        throw std::invalid_argument("Blind schedule has no levels");
+    }
+
     // Initialise player states
     for (const auto &initial_state : players)
     {
@@ -62,55 +108,235 @@ holdem_table_state_manager::holdem_table_state_manager(const std::vector<initial
         {
             throw std::invalid_argument("All players need to have non-zero stack");
         }
-        _table_state.players.emplace_back(player_state{ initial_state.current_stack, {}, {}, initial_state.player_name });
+        _table_state.add_player(initial_state.current_stack, initial_state.player_name);
     }
 
-    _table_state.small_blind_size = small_blind_size;
-    _table_state.big_blind_size = big_blind_size;
+    apply_blind_level(0);
     _table_state.dealer_pos = dealer_position;
 
     set_up_table();
+    // Only later rounds let short stacks post what they have
+    throw_if_short_of_blind(_round_blinds->small_blind_pos, "Small", _table_state.small_blind_size);
+    throw_if_short_of_blind(_round_blinds->big_blind_pos, "Big", _table_state.big_blind_size);
+    _table_state.hash = calculate_table_hash(_table_state);
+}
+
+holdem_table_state_manager::holdem_table_state_manager(table_state state)
+:
+    _table_state(std::move(state)),
+    _blind_schedule{{{_table_state.small_blind_size, _table_state.big_blind_size, _table_state.ante_size}}}
+{
+    _table_state.hash = calculate_table_hash(_table_state);
+}
+
+holdem_table_state_manager::holdem_table_state_manager(const table_event_journal &journal,
+                                                       const size_t end_offset,
+                                                       blind_schedule schedule)
+:
+    _table_state(),
+    _blind_schedule(std::move(schedule))
+{
+    if (_blind_schedule.levels.empty())
+    {
+        throw std::invalid_argument("Blind schedule has no levels");
+    }
+
+    auto offset = journal.find_round_start(end_offset);
+    while (offset < end_offset)
+    {
+        std::visit([this](const auto &event){ apply_event(event); }, journal.read(offset));
+    }
+    if (offset != end_offset)
+    {
+        throw std::invalid_argument("Offset " + std::to_string(end_offset) + " is not at the end of an event of the journal");
+    }
+
+    _rebuilt_from_journal = &journal;
+    _rebuilt_from_offset = end_offset;
+    _rebuilt_hash = _table_state.hash;
+}
+
+void holdem_table_state_manager::set_journal(std::shared_ptr<table_event_journal> journal)
+{
+    const bool continues_journal = !journal || (journal.get() == _rebuilt_from_journal
+                                                && journal->size() == _rebuilt_from_offset
+                                                && _table_state.hash == _rebuilt_hash);
+    if (continues_journal)
+    {
+        _journal = std::move(journal);
+        return;
+    }
+
+    throw_if_unexpected_call(_table_state.current_stage, game_stages::deal_pocket_cards, __func__);
+    if (!_round_blinds)
+    {
+        throw std::logic_error("The blinds of a table set up by the caller aren't known");
+    }
+
+    _journal = std::move(journal);
+    append_to_journal(make_round_started_event());
+    append_to_journal(*_round_blinds);
+    if (!_table_state.dead_cards.empty())
+    {
+        append_to_journal(dead_cards_added_event{_table_state.dead_cards});
+    }
 }
 
 void holdem_table_state_manager::set_pocket_cards(size_t player_pos, const std::string &cards)
 {
-    _table_state.players.at(player_pos).per_game_state.pocket_cards = cards;
+    _undo_log.clear();
+    auto &pocket_cards = _table_state.players.at(player_pos).pocket_cards;
+    const auto hash_before = get_card_deal_hash_part(_table_state) ^ get_pocket_cards_hash_key(player_pos, pocket_cards);
+
+    pocket_cards = cards;
 
     if (_table_state.current_stage == game_stages::deal_pocket_cards)
     {
         move_to_next_stage_from_card_deal();
     }
+
+    _table_state.hash ^= hash_before ^ get_card_deal_hash_part(_table_state) ^ get_pocket_cards_hash_key(player_pos, pocket_cards);
+    append_to_journal(pocket_cards_dealt_event{player_pos, cards});
 }
 
 void holdem_table_state_manager::set_flop(const std::string &cards)
 {
     throw_if_unexpected_call(_table_state.current_stage, game_stages::deal_communal_cards, __func__);
+    _undo_log.clear();
+
+    const auto hash_before = get_card_deal_hash_part(_table_state);
 
     _table_state.communal_cards = cards;
     move_to_next_stage_from_card_deal();
+
+    _table_state.hash ^= hash_before ^ get_card_deal_hash_part(_table_state);
+    append_to_journal(communal_cards_dealt_event{game_stages::deal_communal_cards, cards});
 }
 
 void holdem_table_state_manager::set_turn(const std::string &card)
 {
     throw_if_unexpected_call(_table_state.current_stage, game_stages::deal_turn_card, __func__);
+    _undo_log.clear();
+
+    const auto hash_before = get_card_deal_hash_part(_table_state);
 
     _table_state.communal_cards += ' ';
     _table_state.communal_cards += card;
 
     move_to_next_stage_from_card_deal();
+
+    _table_state.hash ^= hash_before ^ get_card_deal_hash_part(_table_state);
+    append_to_journal(communal_cards_dealt_event{game_stages::deal_turn_card, card});
 }
 
 void holdem_table_state_manager::set_river(const std::string &card)
 {
     throw_if_unexpected_call(_table_state.current_stage, game_stages::deal_river_card, __func__);
+    _undo_log.clear();
+
+    const auto hash_before = get_card_deal_hash_part(_table_state);
 
     _table_state.communal_cards += ' ';
     _table_state.communal_cards += card;
 
     move_to_next_stage_from_card_deal();
+
+    _table_state.hash ^= hash_before ^ get_card_deal_hash_part(_table_state);
+    append_to_journal(communal_cards_dealt_event{game_stages::deal_river_card, card});
+}
+
+void holdem_table_state_manager::add_dead_cards(const std::string &cards)
+{
+    const auto dead_mask = parse_cards(cards);
+    if (!dead_mask || *dead_mask == 0)
+    {
+        throw std::invalid_argument("Cannot parse dead cards \"" + cards + "\"");
+    }
+
+    // Cards which can't be parsed are left to the callers having set them
+    auto known_mask = parse_cards(_table_state.communal_cards).value_or(0) | parse_cards(_table_state.dead_cards).value_or(0);
+    for (const auto &player : _table_state.players)
+    {
+        if (player.pocket_cards)
+        {
+            known_mask |= parse_cards(*player.pocket_cards).value_or(0);
+        }
+    }
+    if (*dead_mask & known_mask)
+    {
+        throw std::invalid_argument("Dead cards \"" + cards + "\" are already on the board, dead or in pocket cards");
+    }
+
+    _undo_log.clear();
+
+    const auto hash_before = get_card_deal_hash_part(_table_state);
+
+    if (!_table_state.dead_cards.empty())
+    {
+        _table_state.dead_cards += ' ';
+    }
+    _table_state.dead_cards += cards;
+
+    _table_state.hash ^= hash_before ^ get_card_deal_hash_part(_table_state);
+    append_to_journal(dead_cards_added_event{cards});
 }
 
 void holdem_table_state_manager::set_acting_player_action(const player_action_t &action)
+{
+    // Acting on top of pushed actions would commit them without journaling them
+    if (!_undo_log.empty())
+    {
+        throw std::logic_error(std::string(__func__) + " was called with " + std::to_string(_undo_log.size())
+                               + " pushed actions not popped yet");
+    }
+
+    const auto pos = _table_state.acting_player_pos;
+    const auto stage = _table_state.current_stage;
+    apply_acting_player_action(action);
+    append_to_journal(action_taken_event{pos, stage, action});
+}
+
+void holdem_table_state_manager::push_action(const player_action_t &action)
+{
+    _undo_log.emplace_back(undo_entry{ _table_state.current_stage,
+                                       _table_state.pot,
+                                       _table_state.total_contribution_to_stay_in_game,
+                                       _table_state.acting_player_pos,
+                                       _table_state.seats,
+                                       _table_state.hash });
+    try
+    {
+        apply_acting_player_action(action);
+    }
+    catch (...)
+    {
+        _undo_log.pop_back();
+        throw;
+    }
+}
+
+void holdem_table_state_manager::pop_action()
+{
+    if (_undo_log.empty())
+    {
+        throw std::logic_error(std::string(__func__) + " was called without any pushed action");
+    }
+
+    const auto &entry = _undo_log.back();
+
+    _table_state.players.at(entry.acting_player_pos).get_actions(entry.current_stage).pop_back();
+
+    _table_state.current_stage = entry.current_stage;
+    _table_state.pot = entry.pot;
+    _table_state.total_contribution_to_stay_in_game = entry.total_contribution_to_stay_in_game;
+    _table_state.acting_player_pos = entry.acting_player_pos;
+    _table_state.seats = entry.seats;
+    _table_state.hash = entry.hash;
+
+    _undo_log.pop_back();
+}
+
+void holdem_table_state_manager::apply_acting_player_action(const player_action_t &action)
 {
     switch (_table_state.current_stage)
     {
@@ -133,8 +359,20 @@ void holdem_table_state_manager::set_acting_player_action(const player_action_t
         break;
     }
 
+    const auto pos = _table_state.acting_player_pos;
+    const auto stage = _table_state.current_stage;
+    const auto hash_before = get_betting_hash_part(_table_state, pos);
+
     std::visit([this](const auto& arg){ handle_betting_player_action(arg); }, action);
+    move_to_next_betting_player_or_stage();
+
+    const auto &actions = _table_state.players.at(pos).get_actions(stage);
+    _table_state.hash ^= hash_before ^ get_betting_hash_part(_table_state, pos)
+                         ^ get_action_hash_key(pos, stage, actions.size() - 1, actions.back());
+}
 
+void holdem_table_state_manager::move_to_next_betting_player_or_stage()
+{
     // Are there enough players who haven't folded yet?
     const auto active_player_count = _table_state.get_active_player_count();
     if (active_player_count < 2)
@@ -165,34 +403,32 @@ void holdem_table_state_manager::set_acting_player_action(const player_action_t
 
 void holdem_table_state_manager::handle_betting_player_action(const player_action_fold &action)
 {
-    auto& player = _table_state.get_acting_player();
-    player.per_game_state.has_folded = true;
+    const auto pos = _table_state.acting_player_pos;
+    _table_state.fold(pos);
 
-    _table_state.get_acting_player().get_actions(_table_state.current_stage).emplace_back(action);
+    _table_state.record_action(pos, action);
 }
 
 void holdem_table_state_manager::handle_betting_player_action(const player_action_check_or_call &action)
 {
-    auto& player = _table_state.get_acting_player();
+    const auto pos = _table_state.acting_player_pos;
 
-    const auto amount = std::min(_table_state.get_player_amount_to_call(_table_state.acting_player_pos),
-                                 player.current_stack);
+    const auto amount = std::min(_table_state.get_player_amount_to_call(pos), _table_state.get_stack(pos));
 
-    _table_state.pot += amount;
-    player.current_stack -= amount;
-    player.per_game_state.contribution_to_pot += amount;
+    _table_state.contribute_to_pot(pos, amount);
 
-    _table_state.get_acting_player().get_actions(_table_state.current_stage).emplace_back(action);
+    _table_state.record_action(pos, action);
 }
 
 void holdem_table_state_manager::handle_betting_player_action(const player_action_raise &action)
 {
-    auto& player = _table_state.get_acting_player();
+    const auto pos = _table_state.acting_player_pos;
+    const auto stack = _table_state.get_stack(pos);
 
     const auto amount_to_call = _table_state.get_acting_player_amount_to_call();
 
-    const bool is_really_a_raise = player.current_stack > amount_to_call;
-    const auto amount_contributed = std::min(player.current_stack, amount_to_call + action.amount_raised_above_call);
+    const bool is_really_a_raise = stack > amount_to_call;
+    const auto amount_contributed = std::min(stack, amount_to_call + action.amount_raised_above_call);
 
     // Update all player states to reflect this raise
     if (is_really_a_raise)
@@ -200,29 +436,35 @@ void holdem_table_state_manager::handle_betting_player_action(const player_actio
         const auto raised_amount = amount_contributed - amount_to_call;
         _table_state.total_contribution_to_stay_in_game += raised_amount;
 
-        _table_state.get_acting_player().get_actions(_table_state.current_stage).emplace_back(player_action_raise{raised_amount});
+        _table_state.record_action(pos, player_action_raise{raised_amount});
     }
     else
     {
-        _table_state.get_acting_player().get_actions(_table_state.current_stage).emplace_back(player_action_check_or_call{});
+        _table_state.record_action(pos, player_action_check_or_call{});
     }
 
-    _table_state.pot += amount_contributed;
-    player.current_stack -= amount_contributed;
-    player.per_game_state.contribution_to_pot += amount_contributed;
+    _table_state.contribute_to_pot(pos, amount_contributed);
+}
+
+void holdem_table_state_manager::post_blind(const size_t player_pos, const uint64_t blind_size)
+{
+    _table_state.contribute_to_pot(player_pos, std::min(blind_size, _table_state.get_stack(player_pos)));
+    _table_state.total_contribution_to_stay_in_game = std::max(_table_state.total_contribution_to_stay_in_game,
+                                                               _table_state.get_contribution(player_pos));
 }
 
 std::vector<split_pot> holdem_table_state_manager::execute_showdown(const std::unordered_set<size_t> &winner_positions)
 {
     throw_if_unexpected_call(_table_state.current_stage, game_stages::showdown, __func__);
+    _undo_log.clear();
     _table_state.current_stage = game_stages::end_of_round;
 
-    const auto& players = _table_state.players;
+    const auto num_of_players = _table_state.get_num_of_players();
 
     for (const auto &pos : winner_positions)
     {
         const auto &player = _table_state.players.at(pos);
-        if (player.has_folded())
+        if (_table_state.has_folded(pos))
         {
             std::ostringstream oss;
             oss << "Player " << player.player_name << " at position " << pos << " is marked as winner as well as folded";
@@ -233,8 +475,7 @@ std::vector<split_pot> holdem_table_state_manager::execute_showdown(const std::u
     std::set<uint64_t> contribution_limits;
     for (const auto &position : winner_positions)
     {
-        const auto& player = players.at(position);
-        contribution_limits.insert(player.per_game_state.contribution_to_pot);
+        contribution_limits.insert(_table_state.get_contribution(position));
     }
 
     std::vector<split_pot> split_pots;
@@ -246,15 +487,15 @@ std::vector<split_pot> holdem_table_state_manager::execute_showdown(const std::u
         split_pots.emplace_back();
         auto& current_split = split_pots.back();
 
-        for (size_t pos = 0; pos < players.size(); ++pos)
+        for (size_t pos = 0; pos < num_of_players; ++pos)
         {
-            const auto& player = players.at(pos);
-            if (player.per_game_state.contribution_to_pot > prev_contr_limit)
+            const auto contribution = _table_state.get_contribution(pos);
+            if (contribution > prev_contr_limit)
             {
-                const auto increment = std::min(limit, player.per_game_state.contribution_to_pot) - prev_contr_limit;
+                const auto increment = std::min(limit, contribution) - prev_contr_limit;
                 current_split.split_size += increment;
 
-                if (winner_positions.count(pos) && player.per_game_state.contribution_to_pot >= limit)
+                if (winner_positions.count(pos) && contribution >= limit)
                 {
                     current_split.participant_positions.emplace(pos);
                 }
@@ -271,38 +512,94 @@ std::vector<split_pot> holdem_table_state_manager::execute_showdown(const std::u
 
         for (const auto &pos : split.participant_positions)
         {
-            auto& player = _table_state.players.at(pos);
-            player.current_stack += per_winner_split;
+            _table_state.add_to_stack(pos, per_winner_split);
         }
     }
 
+    _table_state.hash = calculate_table_hash(_table_state);
+
+    seat_mask_t winner_mask = 0;
+    for (const auto &pos : winner_positions)
+    {
+        winner_mask |= get_seat_bit(pos);
+    }
+    append_to_journal(showdown_event{winner_mask});
+
     return split_pots;
 }
 
 bool holdem_table_state_manager::start_new_round()
 {
     throw_if_unexpected_call(_table_state.current_stage, game_stages::end_of_round, __func__);
+    _undo_log.clear();
     _table_state.current_stage = game_stages::deal_pocket_cards;
 
-    if (_table_state.start_new_round())
+    ++_num_of_rounds_played;
+    size_t level_index = 0;
+    if (_blind_schedule.rounds_per_level > 0)
+    {
+        level_index = _num_of_rounds_played / _blind_schedule.rounds_per_level;
+    }
+    if (_blind_schedule.level_duration.count() > 0)
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - _start_time;
+        level_index = std::max(level_index, static_cast<size_t>(elapsed / _blind_schedule.level_duration));
+    }
+    apply_blind_level(std::min(level_index, _blind_schedule.levels.size() - 1));
+
+    const bool has_enough_players = _table_state.start_new_round();
+    _round_blinds.reset();
+    if (_journal)
+    {
+        append_to_journal(make_round_started_event());
+    }
+    if (has_enough_players)
     {
         set_up_table();
-        return true;
+        append_to_journal(*_round_blinds);
+    }
+
+    // Seats may have been shifted by eliminations so everything is rehashed
+    _table_state.hash = calculate_table_hash(_table_state);
+    return has_enough_players;
+}
+
+void holdem_table_state_manager::post_antes()
+{
+    if (_table_state.ante_size == 0)
+    {
+        return;
+    }
+
+    for (size_t pos = 0; pos < _table_state.get_num_of_players(); ++pos)
+    {
+        _table_state.contribute_to_pot(pos, std::min(_table_state.ante_size, _table_state.get_stack(pos)));
+        _table_state.total_contribution_to_stay_in_game = std::max(_table_state.total_contribution_to_stay_in_game,
+                                                                   _table_state.get_contribution(pos));
     }
-    return false;
+}
+
+void holdem_table_state_manager::apply_blind_level(const size_t level_index)
+{
+    const auto &level = _blind_schedule.levels.at(level_index);
+    _blind_level_index = level_index;
+    _table_state.small_blind_size = level.small_blind_size;
+    _table_state.big_blind_size = level.big_blind_size;
+    _table_state.ante_size = level.ante_size;
 }
 
 void holdem_table_state_manager::set_up_table()
 {
     _table_state.current_stage = game_stages::deal_pocket_cards;
-    if (_table_state.players.size() < 2)
+    const auto num_of_players = _table_state.get_num_of_players();
+    if (num_of_players < 2)
     {
-        throw std::invalid_argument("Not enough players: " + std::to_string(_table_state.players.size()));
+        throw std::invalid_argument("Not enough players: " + std::to_string(num_of_players));
     }
-    if (_table_state.players.size() <= _table_state.dealer_pos)
+    if (num_of_players <= _table_state.dealer_pos)
     {
         std::ostringstream oss;
-        oss << "Player count " << _table_state.players.size() << " is not enough to have the dealer at position (zero indexed) " << _table_state.dealer_pos;
+        oss << "Player count " << num_of_players << " is not enough to have the dealer at position (zero indexed) " << _table_state.dealer_pos;
         throw std::invalid_argument(oss.str());
     }
     if (_table_state.small_blind_size >= _table_state.big_blind_size)
@@ -313,38 +610,160 @@ void holdem_table_state_manager::set_up_table()
     }
 
     // Heads-up has special rules
-    const bool is_heads_up = _table_state.players.size() == 2;
-    _table_state.acting_player_pos = is_heads_up ? _table_state.dealer_pos : get_next_pos(_table_state.dealer_pos, _table_state.players.size());
+    const bool is_heads_up = num_of_players == 2;
+    post_antes();
+    const auto small_blind_pos = is_heads_up ? _table_state.dealer_pos : get_next_pos(_table_state.dealer_pos, num_of_players);
+    const auto big_blind_pos = get_next_pos(small_blind_pos, num_of_players);
+    post_blind(small_blind_pos, _table_state.small_blind_size);
+    post_blind(big_blind_pos, _table_state.big_blind_size);
+    _table_state.acting_player_pos = big_blind_pos;
+    _table_state.move_to_next_betting_player();
 
-    auto &small_blind = _table_state.get_acting_player();
-    if (small_blind.current_stack < _table_state.small_blind_size)
+    _round_blinds = blinds_posted_event{ small_blind_pos,
+                                         big_blind_pos,
+                                         _table_state.small_blind_size,
+                                         _table_state.big_blind_size,
+                                         _table_state.ante_size };
+}
+
+void holdem_table_state_manager::throw_if_short_of_blind(const size_t player_pos,
+                                                         const char * const blind_name,
+                                                         const uint64_t blind_size) const
+{
+    const auto contribution = _table_state.get_contribution(player_pos);
+    if (contribution < _table_state.ante_size + blind_size)
     {
         std::ostringstream oss;
-        oss << "Small blind only has " << small_blind.current_stack
-            << " which is less than small blind " << _table_state.small_blind_size;
+        oss << blind_name << " blind only has " << contribution << " which is less than ante "
+            << _table_state.ante_size << " and " << blind_name << " blind " << blind_size;
         throw std::invalid_argument(oss.str());
     }
-    handle_betting_player_action(player_action_raise{_table_state.small_blind_size});
-    _table_state.get_acting_player().per_betting_state.pre_flop_bets.clear();
-    _table_state.move_to_next_betting_player();
+}
 
-    auto &big_blind = _table_state.get_acting_player();
-    if (big_blind.current_stack < _table_state.big_blind_size)
+round_started_event holdem_table_state_manager::make_round_started_event() const
+{
+    round_started_event event;
+    event.dealer_pos = _table_state.dealer_pos;
+    event.blind_level_index = _blind_level_index;
+    event.num_of_rounds_played = _num_of_rounds_played;
+    event.elapsed_milliseconds = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _start_time).count());
+    event.small_blind_size = _table_state.small_blind_size;
+    event.big_blind_size = _table_state.big_blind_size;
+    event.ante_size = _table_state.ante_size;
+    event.num_of_players = _table_state.get_num_of_players();
+    for (size_t pos = 0; pos < event.num_of_players; ++pos)
+    {
+        event.stacks[pos] = _table_state.get_stack(pos) + _table_state.get_contribution(pos);
+        event.player_names[pos] = _table_state.players[pos].player_name;
+    }
+    return event;
+}
+
+void holdem_table_state_manager::append_to_journal(const table_event &event)
+{
+    if (_journal)
+    {
+        _journal->append(event);
+    }
+}
+
+void holdem_table_state_manager::apply_event(const round_started_event &event)
+{
+    if (event.blind_level_index >= _blind_schedule.levels.size())
+    {
+        throw std::invalid_argument("Blind schedule has no level " + std::to_string(event.blind_level_index));
+    }
+
+    _undo_log.clear();
+    _table_state = table_state();
+    for (size_t pos = 0; pos < event.num_of_players; ++pos)
+    {
+        _table_state.add_player(event.stacks[pos], std::string(event.player_names[pos]));
+    }
+    _table_state.small_blind_size = event.small_blind_size;
+    _table_state.big_blind_size = event.big_blind_size;
+    _table_state.ante_size = event.ante_size;
+    _table_state.dealer_pos = event.dealer_pos;
+    _table_state.acting_player_pos = event.dealer_pos;
+
+    _blind_level_index = event.blind_level_index;
+    _num_of_rounds_played = event.num_of_rounds_played;
+    // The game goes on from the time it had been running for, the time since the round started is lost
+    _start_time = std::chrono::steady_clock::now() - std::chrono::milliseconds(event.elapsed_milliseconds);
+    _round_blinds.reset();
+    _table_state.hash = calculate_table_hash(_table_state);
+}
+
+void holdem_table_state_manager::apply_event(const blinds_posted_event &event)
+{
+    _table_state.small_blind_size = event.small_blind_size;
+    _table_state.big_blind_size = event.big_blind_size;
+    _table_state.ante_size = event.ante_size;
+    set_up_table();
+    if (_round_blinds->small_blind_pos != event.small_blind_pos || _round_blinds->big_blind_pos != event.big_blind_pos)
+    {
+        throw std::invalid_argument("Blinds of the journal were posted by other players");
+    }
+    _table_state.hash = calculate_table_hash(_table_state);
+}
+
+void holdem_table_state_manager::apply_event(const pocket_cards_dealt_event &event)
+{
+    set_pocket_cards(event.player_pos, std::string(event.cards));
+}
+
+void holdem_table_state_manager::apply_event(const communal_cards_dealt_event &event)
+{
+    switch (event.stage)
+    {
+    case game_stages::deal_communal_cards: set_flop(std::string(event.cards)); return;
+    case game_stages::deal_turn_card: set_turn(std::string(event.cards)); return;
+    case game_stages::deal_river_card: set_river(std::string(event.cards)); return;
+    default: break;
+    }
+
+    std::ostringstream oss;
+    oss << "Communal cards can't be dealt in stage " << event.stage;
+    throw std::invalid_argument(oss.str());
+}
+
+void holdem_table_state_manager::apply_event(const dead_cards_added_event &event)
+{
+    add_dead_cards(std::string(event.cards));
+}
+
+void holdem_table_state_manager::apply_event(const action_taken_event &event)
+{
+    if (event.player_pos != _table_state.acting_player_pos || event.stage != _table_state.current_stage)
     {
         std::ostringstream oss;
-        oss << "Big blind only has " << big_blind.current_stack
-            << " which is less than big blind " << _table_state.big_blind_size;
+        oss << "Action of player at position " << event.player_pos << " in stage " << event.stage
+            << " doesn't match acting player at position " << _table_state.acting_player_pos << " in stage " << _table_state.current_stage;
         throw std::invalid_argument(oss.str());
     }
-    handle_betting_player_action(player_action_raise{_table_state.big_blind_size - _table_state.small_blind_size});
-    _table_state.get_acting_player().per_betting_state.pre_flop_bets.clear();
-    _table_state.move_to_next_betting_player();
+    set_acting_player_action(event.action);
+}
+
+void holdem_table_state_manager::apply_event(const showdown_event &event)
+{
+    std::unordered_set<size_t> winner_positions;
+    for (size_t pos = 0; pos < max_num_of_players; ++pos)
+    {
+        if (event.winner_mask & get_seat_bit(pos)) { winner_positions.emplace(pos); }
+    }
+    execute_showdown(winner_positions);
 }
 
 void holdem_table_state_manager::move_to_next_stage_from_card_deal()
 {
-    // Are there enough players who can raise? If not then we just need to learn what all the communal cards are
-    const bool not_enough_players = _table_state.get_active_and_not_all_in_player_count() < 2;
+    // Are there enough players who can raise? If not then we just need to learn what all the communal cards are,
+    // unless the one player who can still bet has to call or fold to a short stack's all-in blind
+    const auto num_of_betting_players = _table_state.get_active_and_not_all_in_player_count();
+    const auto pos = _table_state.acting_player_pos;
+    const bool has_to_call = num_of_betting_players == 1 && !_table_state.is_all_in(pos)
+                             && _table_state.get_player_amount_to_call(pos) > 0;
+    const bool not_enough_players = num_of_betting_players < 2 && !has_to_call;
     _table_state.current_stage = not_enough_players ? get_next_card_deal_turn(_table_state.current_stage) : get_next_game_stage(_table_state.current_stage);
 }
 
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <vector>
 
+#include "blind_schedule.h"
 #include "i_table_state_manager.h"
 #include "i_my_poker_lib.h"
+#include "table_event_journal.h"
 #include "table_state.h"
 #include "initial_player_state.h"
 
@@ -17,6 +21,16 @@ public:
                                size_t dealer_position,
                                uint64_t small_blind_size,
                                uint64_t big_blind_size);
+    // Blinds and antes follow schedule starting from its first level. Throws if schedule has no levels.
+    holdem_table_state_manager(const std::vector<initial_player_state> &players,
+                               size_t dealer_position,
+                               blind_schedule schedule);
+    // Continues a game from an already set up table, e.g. to play out what-if scenarios on a copy of a live table
+    explicit holdem_table_state_manager(table_state state);
+    // Rebuilds the table as it was at end_offset of journal by replaying the events from the last round started
+    // before it. Blinds follow schedule from the recorded level and game time on. Throws if the events don't apply to
+    // the table.
+    holdem_table_state_manager(const table_event_journal &journal, size_t end_offset, blind_schedule schedule);
 
     ~holdem_table_state_manager() override = default;
 
@@ -32,24 +46,89 @@ public:
     void set_turn(const std::string &card) override;
     // Throws if current stage is not deal_river_card
     void set_river(const std::string &card) override;
+    // Cards can be burned or exposed at any stage of the game. They are cleared by start_new_round. Throws
+    // std::invalid_argument unless cards are whitespace separated cards like "As Td" none of which is on the board,
+    // dead already or in known pocket cards.
+    void add_dead_cards(const std::string &cards) override;
 
-    // Throws if current stage is not any of the betting rounds
+    // Throws if current stage is not any of the betting rounds or if pushed actions haven't been popped
     void set_acting_player_action(const player_action_t &action) override;
 
     std::vector<split_pot> execute_showdown(const std::unordered_set<size_t> &winner_positions) override;
 
+    // Moves to the next blind level when the schedule says so before eliminating players
     bool start_new_round() override;
 
+    size_t get_blind_level_index() const { return _blind_level_index; }
+
+    // Appends an event for every further change of the table to journal. Pushed actions aren't journaled.
+    // A table still dealing the pocket cards starts with the events setting up its round, and a table rebuilt from
+    // all events of journal and unchanged since continues it. Throws for any other table. Null stops journaling.
+    void set_journal(std::shared_ptr<table_event_journal> journal);
+
+    // Same as set_acting_player_action but the action can be reverted by pop_action. Meant for look-ahead searches.
+    // Card deals, showdowns and new rounds clear the actions pushed so far.
+    void push_action(const player_action_t &action);
+    // Reverts the last pushed action. Throws if there's no pushed action.
+    void pop_action();
+    size_t get_num_of_pushed_actions() const { return _undo_log.size(); }
+
 private:
+    // Everything a betting action changes apart from the acting player's action history
+    struct undo_entry
+    {
+        game_stages current_stage;
+        uint64_t pot;
+        uint64_t total_contribution_to_stay_in_game;
+        size_t acting_player_pos;
+        seats_state seats;
+        uint64_t hash;
+    };
+
+    void apply_acting_player_action(const player_action_t &action);
+    void move_to_next_betting_player_or_stage();
+
     void handle_betting_player_action(const player_action_fold &action);
     void handle_betting_player_action(const player_action_check_or_call &action);
     void handle_betting_player_action(const player_action_raise &action);
+    // Blinds are forced bets so they aren't recorded as actions, short stacks go all-in
+    void post_blind(size_t player_pos, uint64_t blind_size);
+    // Antes are dead money posted by everyone, short stacks go all-in
+    void post_antes();
+    void apply_blind_level(size_t level_index);
 
     void set_up_table();
+    void throw_if_short_of_blind(size_t player_pos, const char *blind_name, uint64_t blind_size) const;
+
+    // Stacks are taken from before the antes and blinds
+    round_started_event make_round_started_event() const;
+    void append_to_journal(const table_event &event);
+
+    void apply_event(const round_started_event &event);
+    void apply_event(const blinds_posted_event &event);
+    void apply_event(const pocket_cards_dealt_event &event);
+    void apply_event(const communal_cards_dealt_event &event);
+    void apply_event(const dead_cards_added_event &event);
+    void apply_event(const action_taken_event &event);
+    void apply_event(const showdown_event &event);
 
     void move_to_next_stage_from_card_deal();
 
     table_state _table_state;
+    std::vector<undo_entry> _undo_log;
+
+    blind_schedule _blind_schedule;
+    size_t _blind_level_index = 0;
+    size_t _num_of_rounds_played = 0;
+    std::chrono::steady_clock::time_point _start_time = std::chrono::steady_clock::now();
+
+    // Unknown for tables set up by the caller
+    std::optional<blinds_posted_event> _round_blinds;
+    std::shared_ptr<table_event_journal> _journal;
+    // Where the table was rebuilt from, so it can continue the journal
+    const table_event_journal *_rebuilt_from_journal = nullptr;
+    size_t _rebuilt_from_offset = 0;
+    uint64_t _rebuilt_hash = 0;
 };
 
 } // end of namespace poker_lib
@@ -15,13 +15,6 @@ void print_actions(std::ostream& os, const std::vector<player_action_t>& contain
     }
 }
 
-std::ostream& operator<<(std::ostream &os, const per_game_player_state &state)
-{
-    return os << "has_folded: " << std::boolalpha << state.has_folded << std::noboolalpha
-              << ", pocket_cards: " << state.pocket_cards.value_or("")
-              << ", contribution_to_pot: " << state.contribution_to_pot;
-}
-
 std::ostream& operator<<(std::ostream &os, const per_betting_player_state &state)
 {
     if (state.pre_flop_bets.empty()
@@ -58,18 +51,10 @@ std::ostream& operator<<(std::ostream &os, const per_betting_player_state &state
 
 std::ostream& operator<<(std::ostream &os, const player_state &state)
 {
-    return os << "current_stack: " << state.current_stack
-              << ", per_game_state: " << state.per_game_state
+    return os << "pocket_cards: " << state.pocket_cards.value_or("")
               << ", per_betting_state: " << state.per_betting_state;
 }
 
-bool operator==(const per_game_player_state &lhs, const per_game_player_state &rhs)
-{
-    return lhs.has_folded == rhs.has_folded &&
-           lhs.pocket_cards == rhs.pocket_cards &&
-           lhs.contribution_to_pot == rhs.contribution_to_pot;
-}
-
 bool operator==(const per_betting_player_state &lhs, const per_betting_player_state &rhs)
 {
     return lhs.pre_flop_bets == rhs.pre_flop_bets
@@ -80,8 +65,7 @@ bool operator==(const per_betting_player_state &lhs, const per_betting_player_st
 
 bool operator==(const player_state &lhs, const player_state &rhs)
 {
-    return lhs.current_stack == rhs.current_stack &&
-           lhs.per_game_state == rhs.per_game_state &&
+    return lhs.pocket_cards == rhs.pocket_cards &&
            lhs.per_betting_state == rhs.per_betting_state;
 }
 
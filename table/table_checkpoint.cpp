@@ -0,0 +1,354 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "table_checkpoint.h"
+
+namespace poker_lib {
+
+//
+// Checkpoint file
+//
+
+struct table_checkpoint_header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t num_of_event_bytes;
+};
+
+// The header is followed by the events of the journal
+constexpr char checkpoint_file_magic[8] = {'T', 'B', 'L', 'C', 'K', 'P', 'N', 'T'};
+constexpr uint32_t checkpoint_file_version = 2;
+
+#ifdef _WIN32
+
+static void write_synced_file(const std::string &path, const std::vector<uint8_t> &bytes)
+{
+    const HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("Cannot create table checkpoint " + path);
+    }
+
+    DWORD num_of_written_bytes = 0;
+    const bool is_written = WriteFile(file, bytes.data(), static_cast<DWORD>(bytes.size()), &num_of_written_bytes, nullptr) &&
+                            num_of_written_bytes == bytes.size() &&
+                            FlushFileBuffers(file);
+    CloseHandle(file);
+    if (!is_written)
+    {
+        throw std::runtime_error("Cannot write table checkpoint " + path);
+    }
+}
+
+static void replace_synced_file(const std::string &from_path, const std::string &to_path)
+{
+    if (!MoveFileExA(from_path.c_str(), to_path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+    {
+        throw std::runtime_error("Cannot replace table checkpoint " + to_path);
+    }
+}
+
+#else
+
+static void write_synced_file(const std::string &path, const std::vector<uint8_t> &bytes)
+{
+    const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Cannot create table checkpoint " + path);
+    }
+
+    size_t num_of_written_bytes = 0;
+    while (num_of_written_bytes < bytes.size())
+    {
+        const auto result = ::write(fd, bytes.data() + num_of_written_bytes, bytes.size() - num_of_written_bytes);
+        if (result < 0 && errno != EINTR)
+        {
+            break;
+        }
+        num_of_written_bytes += result < 0 ? 0 : static_cast<size_t>(result);
+    }
+    const bool is_written = num_of_written_bytes == bytes.size() && fsync(fd) == 0;
+    if (close(fd) != 0 || !is_written)
+    {
+        throw std::runtime_error("Cannot write table checkpoint " + path);
+    }
+}
+
+// The rename is only durable once the directory holding the file is synced too
+static void replace_synced_file(const std::string &from_path, const std::string &to_path)
+{
+    if (std::rename(from_path.c_str(), to_path.c_str()) != 0)
+    {
+        throw std::runtime_error("Cannot replace table checkpoint " + to_path);
+    }
+
+    const auto directory = std::filesystem::path(to_path).parent_path();
+    const int fd = open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY);
+    const bool is_synced = fd >= 0 && fsync(fd) == 0;
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    if (!is_synced)
+    {
+        throw std::runtime_error("Cannot sync the directory of table checkpoint " + to_path);
+    }
+}
+
+#endif
+
+// The file is written and synced under a temporary name before replacing the checkpoint, so a crash or a power loss
+// leaves either the previous or the new checkpoint on disk
+static void save_table_checkpoint(const std::string &path, const std::vector<uint8_t> &event_bytes)
+{
+    table_checkpoint_header header{};
+    std::memcpy(header.magic, checkpoint_file_magic, sizeof(header.magic));
+    header.version = checkpoint_file_version;
+    header.num_of_event_bytes = event_bytes.size();
+
+    std::vector<uint8_t> file_bytes(sizeof(header));
+    std::memcpy(file_bytes.data(), &header, sizeof(header));
+    file_bytes.insert(file_bytes.end(), event_bytes.begin(), event_bytes.end());
+
+    const auto temporary_path = path + ".tmp";
+    write_synced_file(temporary_path, file_bytes);
+    replace_synced_file(temporary_path, path);
+}
+
+std::shared_ptr<table_event_journal> load_table_checkpoint(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Cannot open table checkpoint " + path);
+    }
+
+    const auto throw_incompatible = [&path]()
+    {
+        throw std::invalid_argument("File " + path + " is not a compatible table checkpoint");
+    };
+
+    table_checkpoint_header header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, checkpoint_file_magic, sizeof(header.magic)) != 0 ||
+        header.version != checkpoint_file_version)
+    {
+        throw_incompatible();
+    }
+
+    std::vector<uint8_t> event_bytes(static_cast<size_t>(header.num_of_event_bytes));
+    if (!file.read(reinterpret_cast<char*>(event_bytes.data()), static_cast<std::streamsize>(event_bytes.size())) ||
+        file.peek() != std::ifstream::traits_type::eof())
+    {
+        throw_incompatible();
+    }
+
+    try
+    {
+        return std::make_shared<table_event_journal>(std::move(event_bytes));
+    }
+    catch (const std::invalid_argument&)
+    {
+        throw_incompatible();
+    }
+    return nullptr;
+}
+
+//
+// Writer
+//
+
+table_checkpoint_writer::table_checkpoint_writer(std::string path)
+:
+    _path(std::move(path)),
+    _thread([this](){ run(); })
+{
+}
+
+table_checkpoint_writer::~table_checkpoint_writer()
+{
+    {
+        const std::lock_guard<std::mutex> lock(_mutex);
+        _is_stopping = true;
+    }
+    _has_pending.notify_all();
+    _thread.join();
+}
+
+void table_checkpoint_writer::write(const table_event_journal &journal)
+{
+    std::exception_ptr exception;
+    {
+        const std::lock_guard<std::mutex> lock(_mutex);
+        _pending_bytes.assign(journal.data(), journal.data() + journal.size());
+        _pending = pending_operation::write;
+        exception = std::exchange(_exception, nullptr);
+    }
+    _has_pending.notify_all();
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+void table_checkpoint_writer::remove()
+{
+    std::exception_ptr exception;
+    {
+        const std::lock_guard<std::mutex> lock(_mutex);
+        _pending = pending_operation::remove;
+        exception = std::exchange(_exception, nullptr);
+    }
+    _has_pending.notify_all();
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+void table_checkpoint_writer::flush()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _is_idle.wait(lock, [this](){ return _pending == pending_operation::none && !_is_saving; });
+    if (_exception)
+    {
+        std::rethrow_exception(std::exchange(_exception, nullptr));
+    }
+}
+
+void table_checkpoint_writer::run()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true)
+    {
+        _has_pending.wait(lock, [this](){ return _pending != pending_operation::none || _is_stopping; });
+        const auto operation = std::exchange(_pending, pending_operation::none);
+        if (operation == pending_operation::none)
+        {
+            return;
+        }
+
+        std::swap(_pending_bytes, _saved_bytes);
+        _is_saving = true;
+        lock.unlock();
+
+        std::exception_ptr exception;
+        try
+        {
+            if (operation == pending_operation::write)
+            {
+                save_table_checkpoint(_path, _saved_bytes);
+            }
+            else
+            {
+                std::filesystem::remove(_path);
+            }
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+
+        lock.lock();
+        _is_saving = false;
+        if (exception && !_exception)
+        {
+            _exception = exception;
+        }
+        _is_idle.notify_all();
+    }
+}
+
+//
+// Checkpointed table
+//
+
+checkpointed_table_state_manager::checkpointed_table_state_manager(holdem_table_state_manager &manager,
+                                                                   std::string path,
+                                                                   std::shared_ptr<table_event_journal> journal)
+:
+    _manager(manager),
+    _writer(std::move(path))
+{
+    start_journal(journal ? std::move(journal) : std::make_shared<table_event_journal>());
+}
+
+void checkpointed_table_state_manager::start_journal(std::shared_ptr<table_event_journal> journal)
+{
+    _manager.set_journal(journal);
+    _journal = std::move(journal);
+    _writer.write(*_journal);
+}
+
+void checkpointed_table_state_manager::set_pocket_cards(const size_t player_pos, const std::string &cards)
+{
+    _manager.set_pocket_cards(player_pos, cards);
+    _writer.write(*_journal);
+}
+
+void checkpointed_table_state_manager::set_flop(const std::string &cards)
+{
+    _manager.set_flop(cards);
+    _writer.write(*_journal);
+}
+
+void checkpointed_table_state_manager::set_turn(const std::string &card)
+{
+    _manager.set_turn(card);
+    _writer.write(*_journal);
+}
+
+void checkpointed_table_state_manager::set_river(const std::string &card)
+{
+    _manager.set_river(card);
+    _writer.write(*_journal);
+}
+
+void checkpointed_table_state_manager::add_dead_cards(const std::string &cards)
+{
+    _manager.add_dead_cards(cards);
+    _writer.write(*_journal);
+}
+
+void checkpointed_table_state_manager::set_acting_player_action(const player_action_t &action)
+{
+    _manager.set_acting_player_action(action);
+    _writer.write(*_journal);
+}
+
+std::vector<split_pot> checkpointed_table_state_manager::execute_showdown(const std::unordered_set<size_t> &winner_positions)
+{
+    auto split_pots = _manager.execute_showdown(winner_positions);
+    _writer.write(*_journal);
+    return split_pots;
+}
+
+bool checkpointed_table_state_manager::start_new_round()
+{
+    if (!_manager.start_new_round())
+    {
+        _manager.set_journal(nullptr);
+        _writer.remove();
+        return false;
+    }
+
+    start_journal(std::make_shared<table_event_journal>());
+    return true;
+}
+
+} // end of namespace poker_lib
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "holdem_table_state_manager.h"
+#include "i_table_state_manager.h"
+#include "table_event_journal.h"
+
+namespace poker_lib {
+
+// Journal saved by table_checkpoint_writer. Rebuilding a holdem_table_state_manager from all of its events restores
+// the table. Throws if the file can't be read or isn't a compatible checkpoint.
+std::shared_ptr<table_event_journal> load_table_checkpoint(const std::string &path);
+
+// Saves checkpoints on its own thread so callers only pay for copying the bytes. Files are synced to disk and replaced
+// atomically by renaming a temporary file, so a crash leaves either the previous or the new checkpoint. Errors of
+// saving are rethrown by the next call, so a game doesn't go on without its checkpoints unnoticed.
+class table_checkpoint_writer
+{
+public:
+    explicit table_checkpoint_writer(std::string path);
+    // Saves the pending checkpoint before returning
+    ~table_checkpoint_writer();
+
+    table_checkpoint_writer(const table_checkpoint_writer&) = delete;
+    table_checkpoint_writer& operator=(const table_checkpoint_writer&) = delete;
+
+    // Copies the events and returns. A checkpoint not saved yet is replaced as only the latest one matters. Rethrows
+    // the first error of saving since the last call after queuing the events.
+    void write(const table_event_journal &journal);
+    // Deletes the checkpoint file after the pending checkpoint, e.g. once the game has ended. Rethrows like write.
+    void remove();
+    // Waits until the pending checkpoint is saved. Rethrows the first error of saving since the last call.
+    void flush();
+
+private:
+    enum class pending_operation
+    {
+        none,
+        write,
+        remove,
+    };
+
+    void run();
+
+    const std::string _path;
+
+    std::mutex _mutex;
+    std::condition_variable _has_pending;
+    std::condition_variable _is_idle;
+    pending_operation _pending = pending_operation::none;
+    // Swapped with the bytes being saved so copying a checkpoint doesn't allocate once the buffers have grown
+    std::vector<uint8_t> _pending_bytes;
+    std::vector<uint8_t> _saved_bytes;
+    bool _is_saving = false;
+    bool _is_stopping = false;
+    std::exception_ptr _exception;
+    std::thread _thread;
+};
+
+// Saves a checkpoint of the table after every change. Every round starts a new journal, so checkpoints only hold the
+// events of the current round and the memory needed stays the same however long the game runs.
+class checkpointed_table_state_manager : public i_table_state_manager
+{
+public:
+    // Continues journal if manager was rebuilt from all of its events, e.g. from load_table_checkpoint. Otherwise
+    // manager has to still be dealing the pocket cards and a new journal is started.
+    checkpointed_table_state_manager(holdem_table_state_manager &manager,
+                                     std::string path,
+                                     std::shared_ptr<table_event_journal> journal = nullptr);
+    ~checkpointed_table_state_manager() override = default;
+
+    const table_state& get_table_state() const override { return _manager.get_table_state(); }
+    const player_state& get_acting_player_state() const override { return _manager.get_acting_player_state(); }
+
+    void set_pocket_cards(size_t player_pos, const std::string &cards) override;
+    void set_flop(const std::string &cards) override;
+    void set_turn(const std::string &card) override;
+    void set_river(const std::string &card) override;
+    void add_dead_cards(const std::string &cards) override;
+
+    void set_acting_player_action(const player_action_t &action) override;
+
+    std::vector<split_pot> execute_showdown(const std::unordered_set<size_t> &winner_positions) override;
+
+    // Deletes the checkpoint once the game has ended
+    bool start_new_round() override;
+
+    table_checkpoint_writer& get_writer() { return _writer; }
+
+private:
+    void start_journal(std::shared_ptr<table_event_journal> journal);
+
+    holdem_table_state_manager &_manager;
+    std::shared_ptr<table_event_journal> _journal;
+    table_checkpoint_writer _writer;
+};
+
+} // end of namespace poker_lib
@@ -0,0 +1,354 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "table_event_journal.h"
+
+namespace poker_lib {
+
+namespace {
+
+// Same order as the alternatives of table_event
+enum class table_event_type : uint8_t
+{
+    round_started,
+    blinds_posted,
+    pocket_cards_dealt,
+    communal_cards_dealt,
+    dead_cards_added,
+    action_taken,
+    showdown,
+};
+
+constexpr size_t max_num_of_number_bytes = 10;
+
+// 7 bits per byte starting with the lowest ones, the high bit is set on all bytes but the last
+size_t encode_number(uint64_t value, uint8_t *bytes)
+{
+    size_t num_of_bytes = 0;
+    while (value >= 0x80)
+    {
+        bytes[num_of_bytes++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    bytes[num_of_bytes++] = static_cast<uint8_t>(value);
+    return num_of_bytes;
+}
+
+class event_writer
+{
+public:
+    explicit event_writer(std::vector<uint8_t> &data) : _data(data) {}
+
+    void write_byte(const uint8_t value) { _data.emplace_back(value); }
+
+    void write_number(const uint64_t value)
+    {
+        uint8_t bytes[max_num_of_number_bytes];
+        _data.insert(_data.end(), bytes, bytes + encode_number(value, bytes));
+    }
+
+    void write_string(const std::string_view value)
+    {
+        write_number(value.size());
+        _data.insert(_data.end(), value.begin(), value.end());
+    }
+
+    void write_payload(const round_started_event &event)
+    {
+        write_number(event.dealer_pos);
+        write_number(event.blind_level_index);
+        write_number(event.num_of_rounds_played);
+        write_number(event.elapsed_milliseconds);
+        write_number(event.small_blind_size);
+        write_number(event.big_blind_size);
+        write_number(event.ante_size);
+        write_number(event.num_of_players);
+        for (size_t pos = 0; pos < event.num_of_players; ++pos)
+        {
+            write_number(event.stacks.at(pos));
+            write_string(event.player_names.at(pos));
+        }
+    }
+
+    void write_payload(const blinds_posted_event &event)
+    {
+        write_number(event.small_blind_pos);
+        write_number(event.big_blind_pos);
+        write_number(event.small_blind_size);
+        write_number(event.big_blind_size);
+        write_number(event.ante_size);
+    }
+
+    void write_payload(const pocket_cards_dealt_event &event)
+    {
+        write_number(event.player_pos);
+        write_string(event.cards);
+    }
+
+    void write_payload(const communal_cards_dealt_event &event)
+    {
+        write_byte(static_cast<uint8_t>(event.stage));
+        write_string(event.cards);
+    }
+
+    void write_payload(const dead_cards_added_event &event)
+    {
+        write_string(event.cards);
+    }
+
+    void write_payload(const action_taken_event &event)
+    {
+        write_number(event.player_pos);
+        write_byte(static_cast<uint8_t>(event.stage));
+        write_byte(static_cast<uint8_t>(event.action.index()));
+        if (const auto *raise = std::get_if<player_action_raise>(&event.action))
+        {
+            write_number(raise->amount_raised_above_call);
+        }
+    }
+
+    void write_payload(const showdown_event &event)
+    {
+        write_number(event.winner_mask);
+    }
+
+private:
+    std::vector<uint8_t> &_data;
+};
+
+class event_reader
+{
+public:
+    event_reader(const uint8_t *data, const size_t size, const size_t event_offset)
+    :
+        _data(data),
+        _size(size),
+        _offset(event_offset),
+        _event_offset(event_offset)
+    {
+    }
+
+    size_t get_offset() const { return _offset; }
+
+    [[noreturn]] void throw_corrupt() const
+    {
+        throw std::invalid_argument("Table event at offset " + std::to_string(_event_offset) + " is corrupt");
+    }
+
+    // Events can't be read past end
+    void limit(const size_t end)
+    {
+        if (end > _size) { throw_corrupt(); }
+        _size = end;
+    }
+
+    uint8_t read_byte()
+    {
+        if (_offset >= _size) { throw_corrupt(); }
+        return _data[_offset++];
+    }
+
+    uint64_t read_number()
+    {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7)
+        {
+            const auto byte = read_byte();
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+            {
+                return value;
+            }
+        }
+        throw_corrupt();
+    }
+
+    size_t read_pos()
+    {
+        const auto pos = read_number();
+        if (pos >= max_num_of_players) { throw_corrupt(); }
+        return static_cast<size_t>(pos);
+    }
+
+    game_stages read_stage()
+    {
+        const auto stage = read_byte();
+        if (stage > static_cast<uint8_t>(game_stages::end_of_round)) { throw_corrupt(); }
+        return static_cast<game_stages>(stage);
+    }
+
+    std::string_view read_string()
+    {
+        const auto length = read_number();
+        if (length > _size - _offset) { throw_corrupt(); }
+        const std::string_view result(reinterpret_cast<const char*>(_data + _offset), static_cast<size_t>(length));
+        _offset += static_cast<size_t>(length);
+        return result;
+    }
+
+    table_event read_payload(const table_event_type type)
+    {
+        switch (type)
+        {
+        case table_event_type::round_started:
+        {
+            round_started_event event;
+            event.dealer_pos = read_pos();
+            event.blind_level_index = static_cast<size_t>(read_number());
+            event.num_of_rounds_played = static_cast<size_t>(read_number());
+            event.elapsed_milliseconds = read_number();
+            event.small_blind_size = read_number();
+            event.big_blind_size = read_number();
+            event.ante_size = read_number();
+            event.num_of_players = static_cast<size_t>(read_number());
+            if (event.num_of_players > max_num_of_players) { throw_corrupt(); }
+            for (size_t pos = 0; pos < event.num_of_players; ++pos)
+            {
+                event.stacks[pos] = read_number();
+                event.player_names[pos] = read_string();
+            }
+            return event;
+        }
+
+        case table_event_type::blinds_posted:
+        {
+            blinds_posted_event event;
+            event.small_blind_pos = read_pos();
+            event.big_blind_pos = read_pos();
+            event.small_blind_size = read_number();
+            event.big_blind_size = read_number();
+            event.ante_size = read_number();
+            return event;
+        }
+
+        case table_event_type::pocket_cards_dealt:
+        {
+            pocket_cards_dealt_event event;
+            event.player_pos = read_pos();
+            event.cards = read_string();
+            return event;
+        }
+
+        case table_event_type::communal_cards_dealt:
+        {
+            communal_cards_dealt_event event;
+            event.stage = read_stage();
+            event.cards = read_string();
+            return event;
+        }
+
+        case table_event_type::dead_cards_added:
+            return dead_cards_added_event{read_string()};
+
+        case table_event_type::action_taken:
+        {
+            action_taken_event event;
+            event.player_pos = read_pos();
+            event.stage = read_stage();
+            switch (read_byte())
+            {
+            case 0: event.action = player_action_fold{}; break;
+            case 1: event.action = player_action_check_or_call{}; break;
+            case 2: event.action = player_action_raise{read_number()}; break;
+            default: throw_corrupt();
+            }
+            return event;
+        }
+
+        case table_event_type::showdown:
+        {
+            const auto winner_mask = read_number();
+            if (winner_mask > get_seats_mask(max_num_of_players)) { throw_corrupt(); }
+            return showdown_event{static_cast<seat_mask_t>(winner_mask)};
+        }
+        }
+
+        throw_corrupt();
+    }
+
+private:
+    const uint8_t *_data;
+    size_t _size;
+    size_t _offset;
+    const size_t _event_offset;
+};
+
+static_assert(std::variant_size_v<table_event> == static_cast<size_t>(table_event_type::showdown) + 1, "Every event needs a type");
+static_assert(std::variant_size_v<player_action_t> == 3, "Actions are encoded by their index");
+
+} // end of anonymous namespace
+
+table_event read_table_event(const uint8_t *data, const size_t size, size_t &offset)
+{
+    event_reader reader(data, size, offset);
+    const auto type = reader.read_byte();
+    if (type > static_cast<uint8_t>(table_event_type::showdown))
+    {
+        reader.throw_corrupt();
+    }
+    const auto payload_size = reader.read_number();
+    if (payload_size > size - reader.get_offset())
+    {
+        reader.throw_corrupt();
+    }
+    const auto end = reader.get_offset() + static_cast<size_t>(payload_size);
+    reader.limit(end);
+
+    auto event = reader.read_payload(static_cast<table_event_type>(type));
+    if (reader.get_offset() != end)
+    {
+        reader.throw_corrupt();
+    }
+    offset = end;
+    return event;
+}
+
+table_event_journal::table_event_journal(std::vector<uint8_t> data)
+:
+    _data(std::move(data))
+{
+    for (size_t offset = 0; offset < _data.size();)
+    {
+        const auto event_offset = offset;
+        if (std::holds_alternative<round_started_event>(read(offset)))
+        {
+            _round_start_offsets.emplace_back(event_offset);
+        }
+    }
+}
+
+size_t table_event_journal::append(const table_event &event)
+{
+    const auto offset = _data.size();
+    if (std::holds_alternative<round_started_event>(event))
+    {
+        _round_start_offsets.emplace_back(offset);
+    }
+
+    // The payload is written first and moved behind its size once that's known. Payloads of all but round starts
+    // are shorter than 128 bytes unless the cards are bogus, so the size usually takes one byte.
+    event_writer writer(_data);
+    writer.write_byte(static_cast<uint8_t>(event.index()));
+    const auto payload_offset = _data.size();
+    std::visit([&writer](const auto &typed_event){ writer.write_payload(typed_event); }, event);
+
+    uint8_t size_bytes[max_num_of_number_bytes];
+    const auto num_of_size_bytes = encode_number(_data.size() - payload_offset, size_bytes);
+    _data.insert(_data.begin() + static_cast<std::ptrdiff_t>(payload_offset), size_bytes, size_bytes + num_of_size_bytes);
+
+    return offset;
+}
+
+size_t table_event_journal::find_round_start(const size_t end_offset) const
+{
+    const auto it = std::lower_bound(_round_start_offsets.begin(), _round_start_offsets.end(), end_offset);
+    if (it == _round_start_offsets.begin())
+    {
+        throw std::invalid_argument("No round started before offset " + std::to_string(end_offset) + " of the journal");
+    }
+    return *std::prev(it);
+}
+
+} // end of namespace poker_lib
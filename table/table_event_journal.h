@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "game_stages.h"
+#include "player_actions.h"
+#include "table_state.h"
+
+namespace poker_lib {
+
+// Everything needed to set up a round without earlier events. Stacks are the ones before antes and blinds.
+struct round_started_event
+{
+    size_t dealer_pos = 0;
+    size_t blind_level_index = 0;
+    size_t num_of_rounds_played = 0;
+    // Time the game had been running for when the round started, blind levels by time go on from it
+    uint64_t elapsed_milliseconds = 0;
+    uint64_t small_blind_size = 0;
+    uint64_t big_blind_size = 0;
+    uint64_t ante_size = 0;
+    size_t num_of_players = 0;
+    std::array<uint64_t, max_num_of_players> stacks{};
+    std::array<std::string_view, max_num_of_players> player_names{};
+};
+
+struct blinds_posted_event
+{
+    size_t small_blind_pos = 0;
+    size_t big_blind_pos = 0;
+    uint64_t small_blind_size = 0;
+    uint64_t big_blind_size = 0;
+    uint64_t ante_size = 0;
+};
+
+struct pocket_cards_dealt_event
+{
+    size_t player_pos = 0;
+    std::string_view cards;
+};
+
+// The flop, turn or river depending on stage
+struct communal_cards_dealt_event
+{
+    game_stages stage = game_stages::deal_communal_cards;
+    std::string_view cards;
+};
+
+struct dead_cards_added_event
+{
+    std::string_view cards;
+};
+
+struct action_taken_event
+{
+    size_t player_pos = 0;
+    game_stages stage = game_stages::pre_flop_betting_round;
+    player_action_t action;
+};
+
+struct showdown_event
+{
+    seat_mask_t winner_mask = 0;
+};
+
+// Strings of decoded events point into the bytes they were read from
+using table_event = std::variant<round_started_event, blinds_posted_event, pocket_cards_dealt_event,
+                                 communal_cards_dealt_event, dead_cards_added_event, action_taken_event, showdown_event>;
+
+// Decodes the event at offset and moves offset past it. Throws if the bytes at offset aren't a complete event.
+table_event read_table_event(const uint8_t *data, size_t size, size_t &offset);
+
+// Append-only log of the events of a table. Every event takes a type byte, its size and its fields with integers
+// as variable length quantities, so betting actions take 5 bytes or a few more for raises. Consumers can tail it
+// by reading events from the end offset of their last read, decoded events don't copy the cards or names. Appending
+// may move the bytes, so tailing is only safe on the thread appending or under the lock it appends with.
+class table_event_journal
+{
+public:
+    table_event_journal() = default;
+    // Continues events written before, e.g. by another process. Throws if they're corrupt.
+    explicit table_event_journal(std::vector<uint8_t> data);
+
+    // Returns the offset of the event
+    size_t append(const table_event &event);
+
+    // Appending may move the bytes and invalidate events decoded from them
+    const uint8_t* data() const { return _data.data(); }
+    size_t size() const { return _data.size(); }
+
+    table_event read(size_t &offset) const { return read_table_event(data(), size(), offset); }
+
+    // Offset of the last round started before end_offset, which is where rebuilding the table at end_offset starts.
+    // Throws if there's none.
+    size_t find_round_start(size_t end_offset) const;
+
+private:
+    std::vector<uint8_t> _data;
+    std::vector<size_t> _round_start_offsets;
+};
+
+} // end of namespace poker_lib
@@ -1,23 +1,80 @@
 #include <algorithm>
+#include <bitset>
+#include <sstream>
+#include <type_traits>
 #include "table_state.h"
 #include "game_stages.h"
 
-namespace std {
+namespace poker_lib {
+
+static_assert(std::is_trivially_copyable<seats_state>::value, "seats_state is expected to be copyable with memcpy");
+static_assert(max_num_of_players <= sizeof(seat_mask_t) * 8, "seat_mask_t can't hold all the seats");
+
+size_t count_seats(const seat_mask_t mask)
+{
+    return std::bitset<sizeof(seat_mask_t) * 8>(mask).count();
+}
+
+bool operator==(const seats_state &lhs, const seats_state &rhs)
+{
+    const auto count = lhs.count;
+    return lhs.count == rhs.count &&
+           std::equal(lhs.stacks.begin(), std::next(lhs.stacks.begin(), count), rhs.stacks.begin()) &&
+           std::equal(lhs.contributions.begin(), std::next(lhs.contributions.begin(), count), rhs.contributions.begin()) &&
+           lhs.folded_mask == rhs.folded_mask &&
+           lhs.all_in_mask == rhs.all_in_mask &&
+           lhs.acted_masks == rhs.acted_masks;
+}
+
+bool table_state::has_acted(const size_t player_pos, const game_stages stage) const
+{
+    return seats.acted_masks[get_betting_round_index(stage)] & get_seat_bit(player_pos);
+}
 
-template <typename T>
-std::ostream& operator<<(std::ostream& os, const std::vector<T>& container)
+void table_state::add_player(const uint64_t stack, const std::string &player_name)
 {
-    for (size_t pos = 0; pos < container.size(); ++pos)
+    if (seats.count == max_num_of_players)
     {
-        const auto& elem = container[pos];
-        os << "pos: " << pos << ", elem: " << elem << ",, ";
+        std::ostringstream oss;
+        oss << "Cannot add player " << player_name << ", all " << max_num_of_players << " seats are taken";
+        throw std::invalid_argument(oss.str());
     }
-    return os;
+
+    const auto pos = seats.count++;
+    seats.stacks[pos] = stack;
+    seats.contributions[pos] = 0;
+    if (stack == 0) { seats.all_in_mask |= get_seat_bit(pos); }
+
+    players.emplace_back(player_state{ player_name, {}, {} });
 }
 
-} // end of namespace std
+void table_state::contribute_to_pot(const size_t player_pos, const uint64_t amount)
+{
+    auto &stack = seats.stacks.at(player_pos);
 
-namespace poker_lib {
+    pot += amount;
+    stack -= amount;
+    seats.contributions[player_pos] += amount;
+
+    if (stack == 0) { seats.all_in_mask |= get_seat_bit(player_pos); }
+}
+
+void table_state::add_to_stack(const size_t player_pos, const uint64_t amount)
+{
+    seats.stacks.at(player_pos) += amount;
+    if (amount > 0) { seats.all_in_mask &= ~get_seat_bit(player_pos); }
+}
+
+void table_state::fold(const size_t player_pos)
+{
+    seats.folded_mask |= get_seat_bit(player_pos);
+}
+
+void table_state::record_action(const size_t player_pos, const player_action_t &action)
+{
+    players.at(player_pos).get_actions(current_stage).emplace_back(action);
+    seats.acted_masks[get_betting_round_index(current_stage)] |= get_seat_bit(player_pos);
+}
 
 player_state &table_state::get_acting_player()
 {
@@ -31,22 +88,20 @@ const player_state &table_state::get_acting_player() const
 
 size_t table_state::get_active_player_count() const
 {
-    auto may_act = [](const player_state& player){ return !player.has_folded(); };
-    return static_cast<size_t>(std::count_if(players.begin(), players.end(), may_act));
+    return count_seats(get_seats_mask(seats.count) & ~seats.folded_mask);
 }
 
 size_t table_state::get_active_and_not_all_in_player_count() const
 {
-    auto may_act = [](const player_state& player){ return !player.has_folded() && !player.is_all_in(); };
-    return static_cast<size_t>(std::count_if(players.begin(), players.end(), may_act));
+    return count_seats(get_seats_mask(seats.count) & ~seats.folded_mask & ~seats.all_in_mask);
 }
 
 bool table_state::move_to_next_betting_player()
 {
     const auto pos_has_just_acted = acting_player_pos;
-    for (size_t pos = get_next_pos(pos_has_just_acted, players.size());
+    for (size_t pos = get_next_pos(pos_has_just_acted, seats.count);
          pos != pos_has_just_acted;
-         pos = get_next_pos(pos, players.size()))
+         pos = get_next_pos(pos, seats.count))
     {
         if (may_act_in_betting_round(pos))
         {
@@ -61,12 +116,11 @@ bool table_state::move_to_next_betting_player()
 void table_state::elect_next_acting_player_after_betting()
 {
     // Find first active player after dealer
-    for (auto pos = get_next_pos(dealer_pos, players.size());
+    for (auto pos = get_next_pos(dealer_pos, seats.count);
          pos != dealer_pos;
-         pos = get_next_pos(pos, players.size()))
+         pos = get_next_pos(pos, seats.count))
     {
-        auto& player = players.at(pos);
-        if (!player.has_folded())
+        if (!has_folded(pos))
         {
             acting_player_pos = pos;
             return;
@@ -76,54 +130,75 @@ void table_state::elect_next_acting_player_after_betting()
 
 uint64_t table_state::get_player_amount_to_call(size_t player_pos) const
 {
-    const auto &player = players.at(player_pos);
-    const auto amount_to_call = total_contribution_to_stay_in_game - player.per_game_state.contribution_to_pot;
+    const auto amount_to_call = total_contribution_to_stay_in_game - get_contribution(player_pos);
 
     return amount_to_call;
 }
 
 bool table_state::may_act_in_betting_round(size_t player_pos) const
 {
-    const auto& player = players.at(player_pos);
-    if (player.has_folded() || player.is_all_in())
+    if ((seats.folded_mask | seats.all_in_mask) & get_seat_bit(player_pos))
     {
         return false;
     }
 
-    const bool has_taken_no_action = player.get_actions(current_stage).empty();
+    const bool has_taken_no_action = !has_acted(player_pos, current_stage);
     const bool need_to_contribute_to_stay_in = get_player_amount_to_call(player_pos) > 0;
     return has_taken_no_action || need_to_contribute_to_stay_in;
 }
 
 bool table_state::start_new_round()
 {
-    for (size_t pos = 0; pos < players.size();)
+    // Compact the remaining players to the front of the seats
+    size_t new_count = 0;
+    for (size_t pos = 0; pos < seats.count; ++pos)
     {
-        player_state& player = players.at(pos);
-
-        if (player.current_stack < big_blind_size)
+        if (seats.stacks[pos] == 0)
         {
-            players.erase(std::next(players.begin(), pos));
-            if (pos <= dealer_pos) { --dealer_pos; }
-            if (pos <= acting_player_pos) { --acting_player_pos; }
+            // The dealer shifts down with the seats so the next dealer is the remaining player after it
+            if (new_count <= dealer_pos) { --dealer_pos; }
+            continue;
         }
-        else
-        {
-            player.per_game_state = {};
-            player.per_betting_state = {};
 
-            ++pos;
+        seats.stacks[new_count] = seats.stacks[pos];
+        if (new_count != pos)
+        {
+            players[new_count] = std::move(players[pos]);
         }
+
+        auto &player = players[new_count];
+        player.pocket_cards.reset();
+        player.per_betting_state = {};
+
+        ++new_count;
     }
 
+    std::fill(std::next(seats.stacks.begin(), new_count), seats.stacks.end(), 0);
+    seats.contributions.fill(0);
+    seats.count = new_count;
+    seats.folded_mask = 0;
+    seats.all_in_mask = 0;
+    seats.acted_masks.fill(0);
+    players.resize(new_count);
+
     pot = 0;
     total_contribution_to_stay_in_game = 0;
     communal_cards.clear();
+    dead_cards.clear();
+
+    if (new_count < 2)
+    {
+        dealer_pos = 0;
+        acting_player_pos = 0;
+        return false;
+    }
+    // Removing the dealer from the first seat wraps the dealer around to the last one
+    if (dealer_pos >= new_count) { dealer_pos = new_count - 1; }
 
     elect_next_acting_player_after_betting();
     dealer_pos = acting_player_pos;
 
-    return players.size() > 1;
+    return seats.count > 1;
 }
 
 bool operator==(const table_state &lhs, const table_state &rhs)
@@ -131,24 +206,43 @@ bool operator==(const table_state &lhs, const table_state &rhs)
     return lhs.current_stage == rhs.current_stage &&
            lhs.small_blind_size == rhs.small_blind_size &&
            lhs.big_blind_size == rhs.big_blind_size &&
+           lhs.ante_size == rhs.ante_size &&
            lhs.pot == rhs.pot &&
            lhs.total_contribution_to_stay_in_game == rhs.total_contribution_to_stay_in_game &&
            lhs.communal_cards == rhs.communal_cards &&
+           lhs.dead_cards == rhs.dead_cards &&
+           lhs.seats == rhs.seats &&
            lhs.players == rhs.players &&
            lhs.acting_player_pos == rhs.acting_player_pos &&
            lhs.dealer_pos == rhs.dealer_pos;
 }
 
+static void print_seats(std::ostream &os, const table_state &state)
+{
+    for (size_t pos = 0; pos < state.get_num_of_players(); ++pos)
+    {
+        os << "pos: " << pos
+           << ", stack: " << state.get_stack(pos)
+           << ", contribution_to_pot: " << state.get_contribution(pos)
+           << ", has_folded: " << std::boolalpha << state.has_folded(pos)
+           << ", is_all_in: " << state.is_all_in(pos) << std::noboolalpha
+           << ", " << state.players.at(pos) << ",, ";
+    }
+}
+
 std::ostream& operator<<(std::ostream &os, const table_state &state)
 {
-    return os << "current_stage: " << state.current_stage
-              << ", small_blind_size: " << state.small_blind_size
-              << ", big_blind_size: " << state.big_blind_size
-              << ", pot: " << state.pot
-              << ", total_contribution_to_stay_in_game: " << state.total_contribution_to_stay_in_game
-              << ", communal_cards: " << state.communal_cards
-              << ", players: " << state.players
-              << ", acting_player_pos: " << state.acting_player_pos
+    os << "current_stage: " << state.current_stage
+       << ", small_blind_size: " << state.small_blind_size
+       << ", big_blind_size: " << state.big_blind_size
+       << ", ante_size: " << state.ante_size
+       << ", pot: " << state.pot
+       << ", total_contribution_to_stay_in_game: " << state.total_contribution_to_stay_in_game
+       << ", communal_cards: " << state.communal_cards
+       << ", dead_cards: " << state.dead_cards
+       << ", players: ";
+    print_seats(os, state);
+    return os << ", acting_player_pos: " << state.acting_player_pos
               << ", dealer_pos: " << state.dealer_pos;
 }
 
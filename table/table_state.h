@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -9,6 +10,33 @@
 
 namespace poker_lib {
 
+constexpr size_t max_num_of_players = 10;
+constexpr size_t num_of_betting_rounds = 4;
+
+// Bit N is set if the player at position N is part of the set
+using seat_mask_t = uint16_t;
+
+constexpr seat_mask_t get_seat_bit(const size_t pos) { return static_cast<seat_mask_t>(1u << pos); }
+constexpr seat_mask_t get_seats_mask(const size_t num_of_players) { return static_cast<seat_mask_t>((1u << num_of_players) - 1); }
+size_t count_seats(seat_mask_t mask);
+
+// Betting related data of all the seats stored as structure of arrays. It is trivially copyable so the whole
+// struct can be copied with a memcpy.
+struct seats_state
+{
+    size_t count = 0;
+
+    std::array<uint64_t, max_num_of_players> stacks{};
+    std::array<uint64_t, max_num_of_players> contributions{};
+
+    seat_mask_t folded_mask = 0;
+    // Seats with an empty stack. Folded seats are filtered out by the queries.
+    seat_mask_t all_in_mask = 0;
+    // Seats which have taken an action per betting round. Indexed by get_betting_round_index.
+    std::array<seat_mask_t, num_of_betting_rounds> acted_masks{};
+};
+bool operator==(const seats_state &lhs, const seats_state &rhs);
+
 struct table_state
 {
     // Fields
@@ -16,17 +44,41 @@ struct table_state
 
     uint64_t small_blind_size = 0;
     uint64_t big_blind_size = 0;
+    uint64_t ante_size = 0;
 
     uint64_t pot = 0;
     uint64_t total_contribution_to_stay_in_game = 0;
     std::string communal_cards;
+    // Burned, mucked or exposed cards known to be out of play. Same format as communal_cards.
+    std::string dead_cards;
 
+    seats_state seats;
+    // Names, pocket cards and action history, one entry per seat
     std::vector<player_state> players;
     // Positions are 0 based
     size_t acting_player_pos = 0;
     size_t dealer_pos = 0;
 
+    // See table_state_hash.h. It's maintained by holdem_table_state_manager and it's not part of operator==.
+    uint64_t hash = 0;
+
     // Methods
+    size_t get_num_of_players() const { return seats.count; }
+    uint64_t get_stack(size_t player_pos) const { return seats.stacks.at(player_pos); }
+    uint64_t get_contribution(size_t player_pos) const { return seats.contributions.at(player_pos); }
+    bool has_folded(size_t player_pos) const { return seats.folded_mask & get_seat_bit(player_pos); }
+    bool is_all_in(size_t player_pos) const { return (seats.all_in_mask & ~seats.folded_mask) & get_seat_bit(player_pos); }
+    bool has_acted(size_t player_pos, game_stages stage) const;
+
+    // Throws if all the seats are taken
+    void add_player(uint64_t stack, const std::string &player_name);
+    // Moves amount from the player's stack into the pot. Amount must not exceed the player's stack.
+    void contribute_to_pot(size_t player_pos, uint64_t amount);
+    void add_to_stack(size_t player_pos, uint64_t amount);
+    void fold(size_t player_pos);
+    // Appends action to the player's actions of the current stage
+    void record_action(size_t player_pos, const player_action_t &action);
+
     player_state& get_acting_player();
     const player_state& get_acting_player() const;
     uint64_t get_player_amount_to_call(size_t player_pos) const;
@@ -44,6 +96,7 @@ struct table_state
     // Sets acting player to the first active player after the dealer.
     void elect_next_acting_player_after_betting();
 
+    // Eliminates players who have no chips left, short stacks stay in and post what they have
     bool start_new_round();
 };
 bool operator==(const table_state &lhs, const table_state &rhs);
@@ -0,0 +1,124 @@
+#include "table_state_hash.h"
+
+namespace poker_lib {
+
+enum class hashed_field : uint64_t
+{
+    current_stage = 1,
+    small_blind_size,
+    big_blind_size,
+    pot,
+    total_contribution_to_stay_in_game,
+    communal_cards,
+    acting_player_pos,
+    dealer_pos,
+    stack,
+    contribution,
+    folded,
+    pocket_cards,
+    action,
+    ante_size,
+    dead_cards,
+};
+
+// splitmix64 finalizer. It's a bijection so different values of the same field never share a key.
+static uint64_t mix(uint64_t value)
+{
+    value += 0x9e3779b97f4a7c15ull;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+}
+
+// FNV-1a, stable across platforms unlike std::hash
+static uint64_t hash_string(const std::string &text)
+{
+    uint64_t result = 0xcbf29ce484222325ull;
+    for (const auto c : text)
+    {
+        result ^= static_cast<unsigned char>(c);
+        result *= 0x100000001b3ull;
+    }
+    return result;
+}
+
+static uint64_t get_key(const hashed_field field, const uint64_t slot, const uint64_t value)
+{
+    return mix(mix((static_cast<uint64_t>(field) << 32) | slot) ^ value);
+}
+
+static uint64_t get_key(const hashed_field field, const uint64_t value)
+{
+    return get_key(field, 0, value);
+}
+
+uint64_t get_betting_hash_part(const table_state &table, const size_t player_pos)
+{
+    return get_key(hashed_field::current_stage, static_cast<uint64_t>(table.current_stage)) ^
+           get_key(hashed_field::pot, table.pot) ^
+           get_key(hashed_field::total_contribution_to_stay_in_game, table.total_contribution_to_stay_in_game) ^
+           get_key(hashed_field::acting_player_pos, table.acting_player_pos) ^
+           get_key(hashed_field::stack, player_pos, table.get_stack(player_pos)) ^
+           get_key(hashed_field::contribution, player_pos, table.get_contribution(player_pos)) ^
+           get_key(hashed_field::folded, player_pos, table.has_folded(player_pos));
+}
+
+uint64_t get_card_deal_hash_part(const table_state &table)
+{
+    return get_key(hashed_field::current_stage, static_cast<uint64_t>(table.current_stage)) ^
+           get_key(hashed_field::communal_cards, hash_string(table.communal_cards)) ^
+           get_key(hashed_field::dead_cards, hash_string(table.dead_cards));
+}
+
+uint64_t get_pocket_cards_hash_key(const size_t player_pos, const std::optional<std::string> &cards)
+{
+    // Unknown cards and an empty string must differ
+    const auto value = cards ? hash_string(*cards) : 0;
+    return get_key(hashed_field::pocket_cards, player_pos, mix(value) ^ static_cast<bool>(cards));
+}
+
+uint64_t get_action_hash_key(const size_t player_pos, const game_stages stage, const size_t index, const player_action_t &action)
+{
+    const auto slot = player_pos + max_num_of_players * (get_betting_round_index(stage) + num_of_betting_rounds * index);
+    const auto *raise = std::get_if<player_action_raise>(&action);
+    const uint64_t amount = raise ? raise->amount_raised_above_call : 0;
+    return get_key(hashed_field::action, slot, mix(amount) ^ action.index());
+}
+
+uint64_t calculate_table_hash(const table_state &table)
+{
+    uint64_t result = get_card_deal_hash_part(table) ^
+                      get_key(hashed_field::small_blind_size, table.small_blind_size) ^
+                      get_key(hashed_field::big_blind_size, table.big_blind_size) ^
+                      get_key(hashed_field::ante_size, table.ante_size) ^
+                      get_key(hashed_field::pot, table.pot) ^
+                      get_key(hashed_field::total_contribution_to_stay_in_game, table.total_contribution_to_stay_in_game) ^
+                      get_key(hashed_field::acting_player_pos, table.acting_player_pos) ^
+                      get_key(hashed_field::dealer_pos, table.dealer_pos);
+
+    for (size_t pos = 0; pos < table.get_num_of_players(); ++pos)
+    {
+        result ^= get_key(hashed_field::stack, pos, table.get_stack(pos)) ^
+                  get_key(hashed_field::contribution, pos, table.get_contribution(pos)) ^
+                  get_key(hashed_field::folded, pos, table.has_folded(pos));
+
+        const auto &player = table.players.at(pos);
+        result ^= get_pocket_cards_hash_key(pos, player.pocket_cards);
+
+        for (const auto stage : {game_stages::pre_flop_betting_round,
+                                 game_stages::flop_betting_round,
+                                 game_stages::turn_betting_round,
+                                 game_stages::river_betting_round})
+        {
+            const auto &actions = player.get_actions(stage);
+            for (size_t index = 0; index < actions.size(); ++index)
+            {
+                result ^= get_action_hash_key(pos, stage, index, actions[index]);
+            }
+        }
+    }
+
+    return result;
+}
+
+} // end of namespace poker_lib
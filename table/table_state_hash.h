@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "table_state.h"
+
+namespace poker_lib {
+
+// Zobrist style hash of a table. Every field (and every seat's field) maps its value to a pseudo random key and the
+// hash is the xor of all the keys. Updating a field only needs its old key xor-ed out and the new one xor-ed in.
+// Player names are not hashed as they aren't part of table_state equality either.
+uint64_t calculate_table_hash(const table_state &table);
+
+// Xor of the keys a betting action of the player at player_pos may change: stage, pot, amount to stay in game,
+// acting player and the player's stack, contribution and fold flag.
+uint64_t get_betting_hash_part(const table_state &table, size_t player_pos);
+// Xor of the keys a card deal may change: stage, communal and dead cards
+uint64_t get_card_deal_hash_part(const table_state &table);
+uint64_t get_pocket_cards_hash_key(size_t player_pos, const std::optional<std::string> &cards);
+// Key of the action at index in the player's list of actions for stage
+uint64_t get_action_hash_key(size_t player_pos, game_stages stage, size_t index, const player_action_t &action);
+
+// Allows keying hash containers with tables whose hash field is maintained, e.g. by holdem_table_state_manager
+struct table_state_hasher
+{
+    size_t operator()(const table_state &table) const { return static_cast<size_t>(table.hash); }
+};
+
+// Rejects different tables by their hash and only compares them deeply when the hashes match
+struct table_state_equal_to
+{
+    bool operator()(const table_state &lhs, const table_state &rhs) const { return lhs.hash == rhs.hash && lhs == rhs; }
+};
+
+} // end of namespace poker_lib
@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "thread_placement.h"
+
+namespace poker_lib {
+
+std::vector<size_t> parse_cpu_list(const std::string &cpu_list)
+{
+    std::vector<size_t> result;
+
+    std::istringstream iss(cpu_list);
+    std::string range;
+    while (std::getline(iss, range, ','))
+    {
+        range.erase(std::remove_if(range.begin(), range.end(), [](const char c){ return std::isspace(static_cast<unsigned char>(c)); }), range.end());
+        if (range.empty())
+        {
+            continue;
+        }
+
+        const auto dash = range.find('-');
+        const auto first_text = range.substr(0, dash);
+        const auto last_text = dash == std::string::npos ? first_text : range.substr(dash + 1);
+        const auto is_number = [](const std::string &text)
+        {
+            return !text.empty() && std::all_of(text.begin(), text.end(), [](const char c){ return std::isdigit(static_cast<unsigned char>(c)); });
+        };
+        if (!is_number(first_text) || !is_number(last_text) || std::stoull(first_text) > std::stoull(last_text))
+        {
+            throw std::invalid_argument("Invalid CPU list " + cpu_list);
+        }
+
+        for (auto cpu = std::stoull(first_text); cpu <= std::stoull(last_text); ++cpu)
+        {
+            result.emplace_back(static_cast<size_t>(cpu));
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+std::vector<std::vector<size_t>> get_numa_node_cpus()
+{
+    std::vector<std::vector<size_t>> result;
+#ifdef __linux__
+    for (size_t node = 0;; ++node)
+    {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        std::string cpu_list;
+        if (!file || !std::getline(file, cpu_list))
+        {
+            break;
+        }
+        result.emplace_back(parse_cpu_list(cpu_list));
+    }
+#endif
+
+    if (result.empty())
+    {
+        std::vector<size_t> cpus(std::max(1u, std::thread::hardware_concurrency()));
+        for (size_t cpu = 0; cpu < cpus.size(); ++cpu) { cpus[cpu] = cpu; }
+        result.emplace_back(std::move(cpus));
+    }
+    return result;
+}
+
+#ifdef _WIN32
+
+// Affinity masks of a thread only cover the 64 CPUs of its processor group
+static DWORD_PTR make_affinity_mask(const std::vector<size_t> &cpus)
+{
+    DWORD_PTR mask = 0;
+    for (const auto cpu : cpus)
+    {
+        if (cpu < sizeof(DWORD_PTR) * 8) { mask |= DWORD_PTR{1} << cpu; }
+    }
+    return mask;
+}
+
+bool set_current_thread_affinity(const std::vector<size_t> &cpus)
+{
+    const auto mask = make_affinity_mask(cpus);
+    return mask && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+}
+
+scoped_thread_affinity::scoped_thread_affinity(const std::vector<size_t> &cpus)
+{
+    const auto mask = make_affinity_mask(cpus);
+    const auto previous_mask = mask ? SetThreadAffinityMask(GetCurrentThread(), mask) : 0;
+    _is_pinned = previous_mask != 0;
+    for (size_t cpu = 0; cpu < sizeof(DWORD_PTR) * 8 && _is_pinned; ++cpu)
+    {
+        if (previous_mask & (DWORD_PTR{1} << cpu)) { _previous_cpus.emplace_back(cpu); }
+    }
+}
+
+#elif defined(__linux__)
+
+bool set_current_thread_affinity(const std::vector<size_t> &cpus)
+{
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (const auto cpu : cpus)
+    {
+        if (cpu < CPU_SETSIZE) { CPU_SET(cpu, &cpu_set); }
+    }
+    return CPU_COUNT(&cpu_set) > 0 && pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+}
+
+scoped_thread_affinity::scoped_thread_affinity(const std::vector<size_t> &cpus)
+{
+    cpu_set_t previous_cpu_set;
+    CPU_ZERO(&previous_cpu_set);
+    if (cpus.empty() || pthread_getaffinity_np(pthread_self(), sizeof(previous_cpu_set), &previous_cpu_set) != 0)
+    {
+        return;
+    }
+    for (size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+        if (CPU_ISSET(cpu, &previous_cpu_set)) { _previous_cpus.emplace_back(cpu); }
+    }
+    _is_pinned = set_current_thread_affinity(cpus);
+}
+
+#else
+
+bool set_current_thread_affinity(const std::vector<size_t>&)
+{
+    return false;
+}
+
+scoped_thread_affinity::scoped_thread_affinity(const std::vector<size_t>&)
+{
+}
+
+#endif
+
+scoped_thread_affinity::~scoped_thread_affinity()
+{
+    if (_is_pinned)
+    {
+        set_current_thread_affinity(_previous_cpus);
+    }
+}
+
+} // end of namespace poker_lib
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace poker_lib {
+
+// CPUs like in Linux's cpulist files, e.g. "0-3,8,10-11". Throws if the list is invalid.
+std::vector<size_t> parse_cpu_list(const std::string &cpu_list);
+
+// CPUs of every NUMA node. A single node with every CPU where the topology isn't known.
+std::vector<std::vector<size_t>> get_numa_node_cpus();
+
+// Lets the calling thread only run on cpus. Returns false if cpus is empty or pinning isn't supported on this
+// platform, Linux and Windows are.
+bool set_current_thread_affinity(const std::vector<size_t> &cpus);
+
+// Pins the calling thread to cpus for the scope and restores its previous affinity when destroyed. Threads started
+// meanwhile inherit the affinity on Linux, including the ones OMPEval starts. Does nothing if cpus is empty.
+class scoped_thread_affinity
+{
+public:
+    explicit scoped_thread_affinity(const std::vector<size_t> &cpus);
+    ~scoped_thread_affinity();
+
+    scoped_thread_affinity(const scoped_thread_affinity&) = delete;
+    scoped_thread_affinity& operator=(const scoped_thread_affinity&) = delete;
+
+private:
+    bool _is_pinned = false;
+    std::vector<size_t> _previous_cpus;
+};
+
+} // end of namespace poker_lib
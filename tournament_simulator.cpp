@@ -0,0 +1,276 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+#include "batch_hand_evaluator.h"
+#include "table/holdem_table_state_manager.h"
+#include "tournament_simulator.h"
+
+namespace poker_lib {
+
+static std::string card_to_string(const unsigned card)
+{
+    static constexpr char ranks[] = "23456789TJQKA";
+    static constexpr char suits[] = "shcd";
+    return {ranks[card / 4], suits[card % 4]};
+}
+
+static player_action_t sample_action(const opponent_response &response, std::mt19937_64 &rng)
+{
+    const auto sample = std::uniform_real_distribution<double>(0, 1)(rng);
+    if (sample < response.fold)
+    {
+        return player_action_fold{};
+    }
+    if (sample < response.fold + response.check_or_call)
+    {
+        return player_action_check_or_call{};
+    }
+    return player_action_raise{response.raise_amount};
+}
+
+// Plays tournaments one after the other and counts the places players finished at
+class tournament_simulator
+{
+public:
+    explicit tournament_simulator(const tournament_simulation_config &config)
+    :
+        _config(config),
+        _place_counts(config.stacks.size(), std::vector<size_t>(config.stacks.size(), 0))
+    {
+    }
+
+    void simulate_tournament(const size_t tournament_index)
+    {
+        std::seed_seq seed{_config.seed, static_cast<uint64_t>(tournament_index)};
+        _rng.seed(seed);
+        // Shuffles carry on from the previous deck so it's reset to keep tournaments independent of each other
+        for (size_t card = 0; card < _deck.size(); ++card)
+        {
+            _deck[card] = static_cast<uint8_t>(card);
+        }
+
+        const auto num_of_players = _config.stacks.size();
+        std::vector<initial_player_state> players;
+        for (size_t index = 0; index < num_of_players; ++index)
+        {
+            players.push_back({_config.stacks[index], std::to_string(index)});
+        }
+
+        holdem_table_state_manager state_manager(players,
+                                                 std::uniform_int_distribution<size_t>(0, num_of_players - 1)(_rng),
+                                                 _config.blinds);
+
+        _next_worst_place = num_of_players;
+        for (size_t round = 0; round < _config.max_rounds_per_tournament; ++round)
+        {
+            ++_num_of_rounds;
+            play_round(state_manager);
+
+            const auto table_before = state_manager.get_table_state();
+            const bool has_enough_players = state_manager.start_new_round();
+            place_eliminated_players(table_before, state_manager.get_table_state());
+
+            if (!has_enough_players)
+            {
+                break;
+            }
+        }
+
+        // Whoever is left is placed by stack, normally only the winner
+        place_eliminated_players(state_manager.get_table_state(), table_state{});
+    }
+
+    const std::vector<std::vector<size_t>>& get_place_counts() const { return _place_counts; }
+    size_t get_num_of_rounds() const { return _num_of_rounds; }
+
+private:
+    void play_round(holdem_table_state_manager &state_manager)
+    {
+        const auto &table = state_manager.get_table_state();
+        const auto num_of_players = table.get_num_of_players();
+
+        // Only as many cards are shuffled as dealt
+        const auto num_of_dealt_cards = 2 * num_of_players + 5;
+        for (size_t card = 0; card < num_of_dealt_cards; ++card)
+        {
+            std::swap(_deck[card], _deck[std::uniform_int_distribution<size_t>(card, _deck.size() - 1)(_rng)]);
+        }
+        const auto board_card = [this, num_of_players](const size_t index){ return card_to_string(_deck[2 * num_of_players + index]); };
+
+        for (size_t pos = 0; pos < num_of_players; ++pos)
+        {
+            state_manager.set_pocket_cards(pos, card_to_string(_deck[2 * pos]) + card_to_string(_deck[2 * pos + 1]));
+        }
+
+        while (table.current_stage != game_stages::end_of_round)
+        {
+            switch (table.current_stage)
+            {
+            case game_stages::deal_communal_cards:
+                state_manager.set_flop(board_card(0) + board_card(1) + board_card(2));
+                break;
+
+            case game_stages::deal_turn_card:
+                state_manager.set_turn(board_card(3));
+                break;
+
+            case game_stages::deal_river_card:
+                state_manager.set_river(board_card(4));
+                break;
+
+            case game_stages::pre_flop_betting_round:
+            case game_stages::flop_betting_round:
+            case game_stages::turn_betting_round:
+            case game_stages::river_betting_round:
+                state_manager.set_acting_player_action(sample_action(_config.policy->get_response(table), _rng));
+                break;
+
+            case game_stages::showdown:
+                state_manager.execute_showdown(get_winner_positions(table));
+                break;
+
+            case game_stages::deal_pocket_cards:
+            case game_stages::end_of_round:
+                throw std::logic_error("Unexpected stage during simulated round");
+            }
+        }
+    }
+
+    std::unordered_set<size_t> get_winner_positions(const table_state &table)
+    {
+        const auto num_of_players = table.get_num_of_players();
+
+        _showdown_positions.clear();
+        _showdown_hands.clear();
+        for (size_t pos = 0; pos < num_of_players; ++pos)
+        {
+            if (table.has_folded(pos))
+            {
+                continue;
+            }
+
+            seven_cards hand;
+            std::copy_n(std::next(_deck.begin(), 2 * num_of_players), 5, hand.begin());
+            hand[5] = _deck[2 * pos];
+            hand[6] = _deck[2 * pos + 1];
+            _showdown_hands.emplace_back(hand);
+            _showdown_positions.emplace_back(pos);
+        }
+
+        _showdown_values.resize(_showdown_hands.size());
+        _evaluator.evaluate(_showdown_hands.data(), _showdown_hands.size(), _showdown_values.data());
+
+        const auto best_value = *std::max_element(_showdown_values.begin(), _showdown_values.end());
+        std::unordered_set<size_t> winners;
+        for (size_t index = 0; index < _showdown_positions.size(); ++index)
+        {
+            if (_showdown_values[index] == best_value)
+            {
+                winners.emplace(_showdown_positions[index]);
+            }
+        }
+        return winners;
+    }
+
+    // Players at table_before missing from table_after take the worst places not taken yet, smaller stacks first
+    void place_eliminated_players(const table_state &table_before, const table_state &table_after)
+    {
+        std::vector<std::pair<uint64_t, size_t>> eliminated;
+        for (size_t pos = 0; pos < table_before.get_num_of_players(); ++pos)
+        {
+            const auto &name = table_before.players[pos].player_name;
+            const bool is_still_in = std::any_of(table_after.players.begin(), table_after.players.end(),
+                                                 [&name](const auto &player){ return player.player_name == name; });
+            if (!is_still_in)
+            {
+                eliminated.emplace_back(table_before.get_stack(pos), std::stoull(name));
+            }
+        }
+
+        std::sort(eliminated.begin(), eliminated.end());
+        for (const auto &[stack, player_index] : eliminated)
+        {
+            ++_place_counts[player_index][--_next_worst_place];
+        }
+    }
+
+    const tournament_simulation_config &_config;
+    batch_hand_evaluator _evaluator;
+    // Reused between showdowns
+    std::vector<size_t> _showdown_positions;
+    std::vector<seven_cards> _showdown_hands;
+    std::vector<uint32_t> _showdown_values;
+    std::mt19937_64 _rng;
+    std::array<uint8_t, 52> _deck{};
+
+    std::vector<std::vector<size_t>> _place_counts;
+    size_t _next_worst_place = 0;
+    size_t _num_of_rounds = 0;
+};
+
+tournament_simulation_result simulate_tournaments(const tournament_simulation_config &config)
+{
+    const auto num_of_players = config.stacks.size();
+    if (num_of_players < 2 || num_of_players > max_num_of_players)
+    {
+        throw std::invalid_argument("Tournaments can be simulated with 2 to " + std::to_string(max_num_of_players) + " players");
+    }
+    if (!config.policy)
+    {
+        throw std::invalid_argument("No policy to simulate players with");
+    }
+
+    const auto start_time = std::chrono::steady_clock::now();
+    const size_t num_of_threads = std::min(config.num_of_tournaments,
+                                           config.num_of_threads ? config.num_of_threads : std::max(1u, std::thread::hardware_concurrency()));
+
+    std::vector<tournament_simulator> simulators(num_of_threads, tournament_simulator(config));
+    std::vector<std::thread> threads;
+    for (size_t thread_index = 0; thread_index < num_of_threads; ++thread_index)
+    {
+        threads.emplace_back([&config, &simulator = simulators[thread_index], thread_index, num_of_threads]()
+        {
+            for (auto tournament = thread_index; tournament < config.num_of_tournaments; tournament += num_of_threads)
+            {
+                simulator.simulate_tournament(tournament);
+            }
+        });
+    }
+    for (auto &thread : threads) { thread.join(); }
+
+    tournament_simulation_result result;
+    result.num_of_tournaments = config.num_of_tournaments;
+    result.placement_probabilities.assign(num_of_players, std::vector<double>(num_of_players, 0));
+    for (const auto &simulator : simulators)
+    {
+        result.num_of_rounds += simulator.get_num_of_rounds();
+        for (size_t player = 0; player < num_of_players; ++player)
+        {
+            for (size_t place = 0; place < num_of_players; ++place)
+            {
+                result.placement_probabilities[player][place] += static_cast<double>(simulator.get_place_counts()[player][place]);
+            }
+        }
+    }
+    for (auto &probabilities : result.placement_probabilities)
+    {
+        for (auto &probability : probabilities)
+        {
+            probability /= static_cast<double>(std::max<size_t>(config.num_of_tournaments, 1));
+        }
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    if (result.seconds > 0)
+    {
+        result.tournaments_per_second = static_cast<double>(result.num_of_tournaments) / result.seconds;
+        result.rounds_per_second = static_cast<double>(result.num_of_rounds) / result.seconds;
+    }
+    return result;
+}
+
+} // end of namespace poker_lib
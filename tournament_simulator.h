@@ -0,0 +1,42 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "look_ahead_search.h"
+#include "table/blind_schedule.h"
+
+namespace poker_lib {
+
+struct tournament_simulation_config
+{
+    std::vector<uint64_t> stacks;
+    // Schedules by time follow the wall clock so they only make sense with rounds_per_level
+    blind_schedule blinds{{{10, 20, 0}}};
+    size_t num_of_tournaments = 10000;
+    // 0 means one thread per core
+    size_t num_of_threads = 0;
+    // Every tournament is seeded from this and its index so results don't depend on the number of threads
+    uint64_t seed = 1;
+    // Players still in after this many rounds are placed by their stacks
+    size_t max_rounds_per_tournament = 100000;
+    // Every player acts by sampling the model's response
+    std::shared_ptr<const i_opponent_model> policy = std::make_shared<pot_odds_opponent_model>();
+};
+
+struct tournament_simulation_result
+{
+    // placement_probabilities[player][place], places are zero based
+    std::vector<std::vector<double>> placement_probabilities;
+    size_t num_of_tournaments = 0;
+    size_t num_of_rounds = 0;
+    double seconds = 0;
+    double tournaments_per_second = 0;
+    double rounds_per_second = 0;
+};
+
+// Plays out complete games with holdem_table_state_manager dealing random cards until only one player is left.
+// Players eliminated in the same round are placed by their stacks at the end of the round.
+tournament_simulation_result simulate_tournaments(const tournament_simulation_config &config);
+
+} // end of namespace poker_lib
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <omp/CardRange.h>
+#include <omp/HandEvaluator.h>
+#include "batch_hand_evaluator.h"
+
+static poker_lib::seven_cards make_hand(const std::string &cards)
+{
+    poker_lib::seven_cards hand{};
+    const auto mask = omp::CardRange::getCardMask(cards);
+    size_t index = 0;
+    for (uint8_t card = 0; card < 52; ++card)
+    {
+        if (mask & (uint64_t{1} << card))
+        {
+            hand.at(index++) = card;
+        }
+    }
+    EXPECT_EQ(7, index);
+    return hand;
+}
+
+TEST(test_batch_hand_evaluator, categories_and_order)
+{
+    const poker_lib::batch_hand_evaluator evaluator(poker_lib::hand_evaluator_isa::scalar);
+
+    // From the weakest to the strongest
+    const std::vector<std::pair<std::string, unsigned>> hands{
+        {"2c 3d 4h 5s 7c 8d Th", 0},
+        {"2c 3d 4h 5s 7c 8d Jh", 0},
+        {"2c 2d 4h 5s 7c 8d Jh", 1},
+        {"2c 2d 4h 4s 7c 8d Jh", 2},
+        {"2c 2d 4h 4s 7c 7d 3h", 2},
+        {"2c 2d 2h 4s 7c 8d Jh", 3},
+        {"Ac 2d 3h 4s 5c 8d Jh", 4},
+        {"2c 3d 4h 5s 6c 8d Jh", 4},
+        {"Tc Jd Qh Ks Ac 8d 2h", 4},
+        {"2c 4c 6c 8c Tc 8d Jh", 5},
+        {"2c 2d 2h 4s 4c 8d Jh", 6},
+        {"3c 3d 3h 2s 2c 8d Jh", 6},
+        {"3c 3d 3h 4s 4c 8d Jh", 6},
+        {"2c 2d 2h 2s 3c 8d Jh", 7},
+        {"Ac 2c 3c 4c 5c 8d Jh", 8},
+        {"Tc Jc Qc Kc Ac 8d Jh", 8},
+    };
+
+    uint32_t previous_value = 0;
+    for (const auto &[cards, category] : hands)
+    {
+        const auto value = evaluator.evaluate(make_hand(cards));
+        EXPECT_EQ(category, poker_lib::get_hand_category(value)) << cards;
+        EXPECT_GT(value, previous_value) << cards;
+        previous_value = value;
+    }
+
+    // Suits don't matter apart from flushes
+    EXPECT_EQ(evaluator.evaluate(make_hand("2c 2d 4h 4s 7c 8d Jh")), evaluator.evaluate(make_hand("2h 2s 4c 4d 7s 8h Jc")));
+    // Two trips make a full house of the higher one
+    EXPECT_EQ(evaluator.evaluate(make_hand("2c 2d 2h 3s 3c 3d Jh")), evaluator.evaluate(make_hand("3c 3d 3h 2s 2c 8d Jh")));
+    // Only the best five cards count
+    EXPECT_EQ(evaluator.evaluate(make_hand("Ac Ad Kh Ks Qc 3d 2h")), evaluator.evaluate(make_hand("Ac Ad Kh Ks Qc 4d 2h")));
+}
+
+TEST(test_batch_hand_evaluator, instruction_sets_agree)
+{
+    EXPECT_TRUE(poker_lib::batch_hand_evaluator::is_supported(poker_lib::hand_evaluator_isa::scalar));
+
+    std::mt19937_64 rng(3);
+    std::vector<poker_lib::seven_cards> hands(1003);
+    for (auto &hand : hands)
+    {
+        std::array<uint8_t, 52> deck{};
+        for (uint8_t card = 0; card < 52; ++card) { deck[card] = card; }
+        for (size_t card = 0; card < hand.size(); ++card)
+        {
+            std::swap(deck[card], deck[std::uniform_int_distribution<size_t>(card, 51)(rng)]);
+            hand[card] = deck[card];
+        }
+    }
+
+    const poker_lib::batch_hand_evaluator scalar(poker_lib::hand_evaluator_isa::scalar);
+    std::vector<uint32_t> expected(hands.size());
+    scalar.evaluate(hands.data(), hands.size(), expected.data());
+    for (size_t index = 0; index < hands.size(); ++index)
+    {
+        EXPECT_EQ(expected[index], scalar.evaluate(hands[index]));
+    }
+
+    if (!poker_lib::batch_hand_evaluator::is_supported(poker_lib::hand_evaluator_isa::avx2))
+    {
+        EXPECT_ANY_THROW(poker_lib::batch_hand_evaluator(poker_lib::hand_evaluator_isa::avx2));
+        return;
+    }
+
+    const poker_lib::batch_hand_evaluator avx2(poker_lib::hand_evaluator_isa::avx2);
+    std::vector<uint32_t> values(hands.size());
+    avx2.evaluate(hands.data(), hands.size(), values.data());
+    EXPECT_EQ(expected, values);
+}
+
+TEST(test_batch_hand_evaluator, orders_hands_like_ompeval)
+{
+    const poker_lib::batch_hand_evaluator evaluator;
+    const omp::HandEvaluator omp_evaluator;
+
+    // Pairs of hands sharing a board so that close decisions on kickers and ties come up often
+    std::mt19937_64 rng(5);
+    for (size_t trial = 0; trial < 100000; ++trial)
+    {
+        std::array<uint8_t, 52> deck{};
+        for (uint8_t card = 0; card < 52; ++card) { deck[card] = card; }
+        for (size_t card = 0; card < 9; ++card)
+        {
+            std::swap(deck[card], deck[std::uniform_int_distribution<size_t>(card, 51)(rng)]);
+        }
+
+        const poker_lib::seven_cards first{deck[0], deck[1], deck[4], deck[5], deck[6], deck[7], deck[8]};
+        const poker_lib::seven_cards second{deck[2], deck[3], deck[4], deck[5], deck[6], deck[7], deck[8]};
+        const auto get_omp_value = [&omp_evaluator](const poker_lib::seven_cards &hand)
+        {
+            auto omp_hand = omp::Hand::empty();
+            for (const auto card : hand) { omp_hand += omp::Hand(card); }
+            return omp_evaluator.evaluate(omp_hand);
+        };
+
+        const auto value = evaluator.evaluate(first);
+        const auto other_value = evaluator.evaluate(second);
+        const auto omp_value = get_omp_value(first);
+        const auto other_omp_value = get_omp_value(second);
+        ASSERT_EQ(value < other_value, omp_value < other_omp_value) << trial;
+        ASSERT_EQ(value == other_value, omp_value == other_omp_value) << trial;
+        // OMPEval's categories start at 1 for high card
+        ASSERT_EQ(poker_lib::get_hand_category(value) + 1, omp_value >> omp::HAND_CATEGORY_SHIFT) << trial;
+    }
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include "equity_engine.h"
+
+static poker_lib::table_state make_table(const std::string &hero_cards, const size_t num_of_opponents)
+{
+    poker_lib::table_state table;
+    table.current_stage = poker_lib::game_stages::pre_flop_betting_round;
+    table.add_player(1000, "hero");
+    table.players.back().pocket_cards = hero_cards;
+    for (size_t opponent = 0; opponent < num_of_opponents; ++opponent)
+    {
+        table.add_player(1000, "opponent");
+    }
+    return table;
+}
+
+TEST(test_equity_engine, counter_rng)
+{
+    poker_lib::counter_rng first(1, 0);
+    poker_lib::counter_rng same(1, 0);
+    poker_lib::counter_rng other_stream(1, 1);
+
+    const auto value = first();
+    EXPECT_EQ(value, same());
+    EXPECT_NE(value, other_stream());
+
+    for (size_t draw = 0; draw < 1000; ++draw)
+    {
+        EXPECT_LT(first.next_below(52), 52);
+    }
+}
+
+TEST(test_equity_engine, bit_identical_regardless_of_threads)
+{
+    const poker_lib::batch_hand_evaluator evaluator;
+    const auto table = make_table("As Ad", 2);
+
+    poker_lib::equity_engine_config config;
+    config.num_of_samples = 20000;
+    config.samples_per_stream = 1000;
+    config.num_of_threads = 1;
+    const auto single_threaded = poker_lib::calculate_seeded_equities(table, config, evaluator);
+
+    config.num_of_threads = 3;
+    const auto multi_threaded = poker_lib::calculate_seeded_equities(table, config, evaluator);
+    EXPECT_EQ(single_threaded.equities, multi_threaded.equities);
+
+    // Aces are about 73% against two random hands
+    EXPECT_NEAR(0.73, single_threaded.equities[0], 0.02);
+    EXPECT_NEAR(1, single_threaded.equities[0] + single_threaded.equities[1] + single_threaded.equities[2], 1e-9);
+
+    config.seed = 2;
+    EXPECT_NE(single_threaded.equities, poker_lib::calculate_seeded_equities(table, config, evaluator).equities);
+}
+
+TEST(test_equity_engine, known_cards)
+{
+    const poker_lib::batch_hand_evaluator evaluator;
+    auto table = make_table("As Ks", 1);
+    table.players.back().pocket_cards = "Qs Js";
+    // Royal flush on the board
+    table.communal_cards = "Ah Kh Qh Jh Th";
+    auto result = poker_lib::calculate_seeded_equities(table, poker_lib::equity_engine_config{}, evaluator);
+    EXPECT_EQ(0.5, result.equities[0]);
+
+    table.communal_cards = "Ts Qs 3d";
+    // Duplicated card
+    EXPECT_ANY_THROW(poker_lib::calculate_seeded_equities(table, poker_lib::equity_engine_config{}, evaluator));
+
+    table.communal_cards = "Ts 2c 3d";
+    table.fold(1);
+    result = poker_lib::calculate_seeded_equities(table, poker_lib::equity_engine_config{}, evaluator);
+    EXPECT_EQ(1, result.equities[0]);
+    EXPECT_EQ(0, result.equities[1]);
+}
+
+TEST(test_equity_engine, stratified_sampling)
+{
+    const poker_lib::batch_hand_evaluator evaluator;
+    auto table = make_table("Ah Kh", 2);
+    table.communal_cards = "Qh 7h 2c";
+
+    poker_lib::equity_engine_config config;
+    config.num_of_samples = 32000;
+    config.samples_per_stream = 1000;
+    config.sampling = poker_lib::equity_sampling::plain;
+    const auto plain = poker_lib::calculate_seeded_equities(table, config, evaluator);
+
+    config.sampling = poker_lib::equity_sampling::stratified;
+    const auto stratified = poker_lib::calculate_seeded_equities(table, config, evaluator);
+    EXPECT_EQ(stratified.equities, poker_lib::calculate_seeded_equities(table, config, evaluator).equities);
+
+    // The nut flush draw with overcards is about 59% against two random hands
+    EXPECT_NEAR(0.593, plain.equities[0], 4 * plain.standard_errors[0]);
+    EXPECT_NEAR(0.593, stratified.equities[0], 4 * stratified.standard_errors[0]);
+    EXPECT_GT(plain.standard_errors[0], 0);
+    EXPECT_LT(stratified.standard_errors[0], plain.standard_errors[0]);
+}
+
+TEST(test_equity_engine, target_standard_error)
+{
+    const poker_lib::batch_hand_evaluator evaluator;
+    const auto table = make_table("Qc Qd", 2);
+
+    poker_lib::equity_engine_config config;
+    config.num_of_samples = 1000000;
+    config.samples_per_stream = 1000;
+    config.target_standard_error = 0.005;
+    config.num_of_threads = 1;
+    const auto result = poker_lib::calculate_seeded_equities(table, config, evaluator);
+    EXPECT_LT(result.num_of_samples, config.num_of_samples);
+    for (const auto standard_error : result.standard_errors)
+    {
+        EXPECT_LE(standard_error, config.target_standard_error);
+    }
+
+    config.num_of_threads = 4;
+    const auto multi_threaded = poker_lib::calculate_seeded_equities(table, config, evaluator);
+    EXPECT_EQ(result.num_of_samples, multi_threaded.num_of_samples);
+    EXPECT_EQ(result.equities, multi_threaded.equities);
+}
+
+TEST(test_equity_engine, dead_cards)
+{
+    const poker_lib::batch_hand_evaluator evaluator;
+    auto table = make_table("As Ad", 1);
+    table.players.back().pocket_cards = "Kh Kd";
+    table.communal_cards = "Kc 7h 2d";
+
+    poker_lib::equity_engine_config config;
+    config.num_of_samples = 20000;
+    // Aces need one of the two other aces and no Ks with it, that's 85 of the 990 turn and river pairs
+    EXPECT_NEAR(85.0 / 990, poker_lib::calculate_seeded_equities(table, config, evaluator).equities[0], 0.005);
+
+    table.dead_cards = "Ac";
+    EXPECT_NEAR(42.0 / 946, poker_lib::calculate_seeded_equities(table, config, evaluator).equities[0], 0.005);
+
+    table.dead_cards = "Ac Ah";
+    EXPECT_EQ(0, poker_lib::calculate_seeded_equities(table, config, evaluator).equities[0]);
+
+    // Dead cards can't be on the board
+    table.dead_cards = "7h";
+    EXPECT_ANY_THROW(poker_lib::calculate_seeded_equities(table, config, evaluator));
+}
+
+TEST(test_equity_engine, pairwise_equities)
+{
+    const poker_lib::batch_hand_evaluator evaluator;
+    auto table = make_table("As Ad", 3);
+    table.players[1].pocket_cards = "Kh Kd";
+    table.players[2].pocket_cards = "7c 2d";
+    table.fold(3);
+
+    poker_lib::equity_engine_config config;
+    config.num_of_samples = 50000;
+    const auto result = poker_lib::calculate_seeded_equities(table, config, evaluator);
+
+    // Aces are about 82% against kings and 88% against seven deuce heads-up, less against both
+    EXPECT_NEAR(0.82, result.get_pairwise_equity(0, 1), 0.01);
+    EXPECT_NEAR(0.88, result.get_pairwise_equity(0, 2), 0.01);
+    EXPECT_LT(result.equities[0], result.get_pairwise_equity(0, 1));
+    for (size_t player = 0; player < 3; ++player)
+    {
+        for (size_t opponent = 0; opponent < 3; ++opponent)
+        {
+            if (player != opponent)
+            {
+                EXPECT_NEAR(1, result.get_pairwise_equity(player, opponent) + result.get_pairwise_equity(opponent, player), 1e-9);
+                EXPECT_EQ(result.pairwise_ties[player][opponent], result.pairwise_ties[opponent][player]);
+            }
+        }
+    }
+    EXPECT_EQ(0, result.pairwise_wins[0][3]);
+    EXPECT_EQ(0, result.pairwise_wins[3][0]);
+}
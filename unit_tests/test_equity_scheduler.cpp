@@ -0,0 +1,73 @@
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+#include "equity_engine.h"
+#include "equity_scheduler.h"
+
+TEST(test_equity_scheduler, runs_every_chunk_once)
+{
+    poker_lib::equity_scheduler scheduler(3);
+    EXPECT_EQ(3, scheduler.get_num_of_threads());
+
+    std::vector<std::atomic<int>> counts(100);
+    scheduler.run(poker_lib::equity_job_priority::live_decision, counts.size(), [&counts](const size_t chunk){ ++counts[chunk]; });
+    for (const auto &count : counts)
+    {
+        EXPECT_EQ(1, count);
+    }
+
+    scheduler.run(poker_lib::equity_job_priority::offline_batch, 0, [](size_t){ FAIL(); });
+    EXPECT_THROW(scheduler.run(poker_lib::equity_job_priority::speculative, 10, [](const size_t chunk)
+    {
+        if (chunk == 7) { throw std::runtime_error("chunk failed"); }
+    }), std::runtime_error);
+}
+
+TEST(test_equity_scheduler, live_decisions_overtake_background_jobs)
+{
+    poker_lib::equity_scheduler scheduler(1);
+
+    constexpr size_t num_of_background_chunks = 200;
+    std::atomic<size_t> num_of_finished_background_chunks{0};
+    std::atomic<bool> has_started{false};
+    std::thread background([&]()
+    {
+        scheduler.run(poker_lib::equity_job_priority::offline_batch, num_of_background_chunks, [&](size_t)
+        {
+            has_started = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            ++num_of_finished_background_chunks;
+        });
+    });
+    while (!has_started) { std::this_thread::yield(); }
+
+    // The worker and this thread take the live chunks right after their current ones
+    scheduler.run(poker_lib::equity_job_priority::live_decision, 10, [](size_t){ std::this_thread::sleep_for(std::chrono::milliseconds(1)); });
+    EXPECT_LT(num_of_finished_background_chunks, num_of_background_chunks / 2);
+
+    background.join();
+    EXPECT_EQ(num_of_background_chunks, num_of_finished_background_chunks);
+}
+
+TEST(test_equity_scheduler, scheduled_equities_match_threaded_ones)
+{
+    poker_lib::table_state table;
+    table.current_stage = poker_lib::game_stages::flop_betting_round;
+    table.add_player(1000, "hero");
+    table.players.back().pocket_cards = "Qs Qd";
+    table.add_player(1000, "villain");
+    table.communal_cards = "Ks 9d 4c";
+
+    poker_lib::equity_engine_config config;
+    config.num_of_samples = 20000;
+    config.samples_per_stream = 1024;
+    const poker_lib::batch_hand_evaluator evaluator;
+    const auto result = poker_lib::calculate_seeded_equities(table, config, evaluator);
+
+    config.scheduler = std::make_shared<poker_lib::equity_scheduler>(2);
+    config.priority = poker_lib::equity_job_priority::speculative;
+    const auto scheduled_result = poker_lib::calculate_seeded_equities(table, config, evaluator);
+    EXPECT_EQ(result.equities, scheduled_result.equities);
+    EXPECT_EQ(result.standard_errors, scheduled_result.standard_errors);
+}
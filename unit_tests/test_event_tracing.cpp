@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <set>
+#include <sstream>
+#include <thread>
+#include "event_tracing.h"
+
+static size_t count_occurrences(const std::string &text, const std::string &pattern)
+{
+    size_t count = 0;
+    for (auto pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+    {
+        ++count;
+    }
+    return count;
+}
+
+static std::set<std::string> get_thread_ids(const std::string &trace)
+{
+    const std::string pattern = "\"tid\":";
+    std::set<std::string> thread_ids;
+    for (auto pos = trace.find(pattern); pos != std::string::npos; pos = trace.find(pattern, pos + 1))
+    {
+        const auto begin = pos + pattern.size();
+        thread_ids.emplace(trace.substr(begin, trace.find('}', begin) - begin));
+    }
+    return thread_ids;
+}
+
+TEST(test_event_tracing, chrome_trace)
+{
+    {
+        // Disabled by default
+        const poker_lib::scoped_trace_span span("test", "not_recorded");
+    }
+
+    poker_lib::start_tracing();
+    EXPECT_TRUE(poker_lib::is_tracing_enabled());
+    {
+        const poker_lib::scoped_trace_span span("test", "main_thread");
+    }
+    // Buffers are taken when the first event is recorded so the worker gets its own one
+    std::thread([](){ const poker_lib::scoped_trace_span span("test", "worker_thread"); }).join();
+    poker_lib::stop_tracing();
+    {
+        const poker_lib::scoped_trace_span span("test", "after_stop");
+    }
+
+    std::ostringstream oss;
+    poker_lib::write_chrome_trace(oss);
+    const auto trace = oss.str();
+
+    EXPECT_EQ(0, trace.find("{\"traceEvents\":["));
+    EXPECT_EQ(1, count_occurrences(trace, "\"name\":\"main_thread\""));
+    EXPECT_EQ(1, count_occurrences(trace, "\"name\":\"worker_thread\""));
+    EXPECT_EQ(0, count_occurrences(trace, "not_recorded"));
+    EXPECT_EQ(0, count_occurrences(trace, "after_stop"));
+    EXPECT_EQ(2, count_occurrences(trace, "\"ph\":\"X\""));
+    EXPECT_EQ(2, get_thread_ids(trace).size());
+
+    // Starting again drops the events recorded so far
+    poker_lib::start_tracing();
+    poker_lib::stop_tracing();
+    std::ostringstream restarted;
+    poker_lib::write_chrome_trace(restarted);
+    EXPECT_EQ(0, count_occurrences(restarted.str(), "\"ph\":\"X\""));
+}
+
+TEST(test_event_tracing, ring_buffer_keeps_latest_events)
+{
+    poker_lib::start_tracing();
+    const auto now = std::chrono::steady_clock::now();
+    for (size_t index = 0; index < poker_lib::trace_ring_buffer_capacity + 10; ++index)
+    {
+        poker_lib::record_trace_event("test", index < 10 ? "oldest" : "latest", now, now);
+    }
+    poker_lib::stop_tracing();
+
+    std::ostringstream oss;
+    poker_lib::write_chrome_trace(oss);
+    EXPECT_EQ(0, count_occurrences(oss.str(), "oldest"));
+    EXPECT_EQ(poker_lib::trace_ring_buffer_capacity, count_occurrences(oss.str(), "latest"));
+}
+
+TEST(test_event_tracing, async_spans)
+{
+    poker_lib::start_tracing();
+    const poker_lib::async_trace_span first("io", "request");
+    const poker_lib::async_trace_span second("io", "request");
+    {
+        const poker_lib::scoped_trace_span span("test", "in_between");
+    }
+    // Finished from another thread and in the other order than started
+    std::thread([second](){ second.finish(); }).join();
+    first.finish();
+    poker_lib::stop_tracing();
+
+    std::ostringstream oss;
+    poker_lib::write_chrome_trace(oss);
+    const auto trace = oss.str();
+
+    EXPECT_EQ(1, count_occurrences(trace, "\"ph\":\"X\""));
+    EXPECT_EQ(2, count_occurrences(trace, "\"ph\":\"b\""));
+    EXPECT_EQ(2, count_occurrences(trace, "\"ph\":\"e\""));
+    EXPECT_EQ(2, count_occurrences(trace, "\"id\":1,"));
+    EXPECT_EQ(2, count_occurrences(trace, "\"id\":2,"));
+}
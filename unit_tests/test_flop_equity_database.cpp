@@ -0,0 +1,107 @@
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <omp/CardRange.h>
+#include "equity_engine.h"
+#include "flop_equity_database.h"
+
+template<size_t N>
+static std::array<uint8_t, N> get_cards(const std::string &cards)
+{
+    const auto mask = omp::CardRange::getCardMask(cards);
+    std::array<uint8_t, N> result{};
+    size_t num_of_cards = 0;
+    for (uint8_t card = 0; card < 52; ++card)
+    {
+        if (mask & (uint64_t{1} << card)) { result.at(num_of_cards++) = card; }
+    }
+    EXPECT_EQ(N, num_of_cards);
+    return result;
+}
+
+TEST(test_flop_equity_database, canonical_keys_and_hand_classes)
+{
+    const auto key = poker_lib::get_canonical_flop_key(get_cards<2>("As Ad"), get_cards<3>("Ah Kd 7s"));
+    // Same spot with the suits swapped around
+    EXPECT_EQ(key, poker_lib::get_canonical_flop_key(get_cards<2>("Ac Ah"), get_cards<3>("Ad Kh 7c")));
+    EXPECT_NE(key, poker_lib::get_canonical_flop_key(get_cards<2>("As Ad"), get_cards<3>("Ah Kd 7d")));
+    EXPECT_NE(key, poker_lib::get_canonical_flop_key(get_cards<2>("Ks Kd"), get_cards<3>("Ah Kh 7s")));
+
+    EXPECT_EQ(6, poker_lib::get_hand_class_combos("AA").size());
+    EXPECT_EQ(4, poker_lib::get_hand_class_combos("AKs").size());
+    EXPECT_EQ(12, poker_lib::get_hand_class_combos("AKo").size());
+    EXPECT_EQ(16, poker_lib::get_hand_class_combos("AK").size());
+    EXPECT_THROW(poker_lib::get_hand_class_combos("AAs"), std::invalid_argument);
+    EXPECT_THROW(poker_lib::get_hand_class_combos("A1"), std::invalid_argument);
+    EXPECT_THROW(poker_lib::get_hand_class_combos("AKx"), std::invalid_argument);
+}
+
+TEST(test_flop_equity_database, generate_and_look_up)
+{
+    const std::string database_path = "test_flop_equities.bin";
+
+    poker_lib::flop_equity_database_config config;
+    config.hand_classes = {"AA"};
+    config.samples_per_entry = 200;
+    config.num_of_threads = 2;
+    const auto stats = poker_lib::generate_flop_equity_database(config, database_path);
+    EXPECT_GT(stats.num_of_entries, 0);
+    // Suit isomorphic spots are stored once
+    EXPECT_LT(stats.num_of_entries, 6 * 19600 / 4);
+
+    {
+        const poker_lib::flop_equity_database database(database_path);
+        EXPECT_EQ(stats.num_of_entries, database.size());
+
+        poker_lib::table_state table;
+        table.current_stage = poker_lib::game_stages::flop_betting_round;
+        table.add_player(1000, "hero");
+        table.players.back().pocket_cards = "As Ad";
+        table.add_player(1000, "villain");
+        table.communal_cards = "Ah Kd 7s";
+
+        // Entries are simulated for one suit permutation of the spot with few samples
+        poker_lib::equity_engine_config engine_config;
+        engine_config.num_of_samples = 20000;
+        const auto simulated = poker_lib::calculate_seeded_equities(table, engine_config, poker_lib::batch_hand_evaluator{});
+
+        const auto equity = database.find_equity(get_cards<2>("As Ad"), get_cards<3>("Ah Kd 7s"));
+        ASSERT_TRUE(equity);
+        EXPECT_GT(*equity, 0.8);
+        EXPECT_EQ(*equity, database.find_equity(get_cards<2>("Ac Ah"), get_cards<3>("Ad Kh 7c")).value_or(0));
+
+        const auto equities = database.find_equities(table);
+        ASSERT_TRUE(equities);
+        EXPECT_EQ(2, equities->size());
+        EXPECT_NEAR(simulated.equities[0], equities->at(0), 0.05);
+        EXPECT_NEAR(1, equities->at(0) + equities->at(1), 1e-9);
+
+        // Pocket cards that aren't in the database
+        table.players.front().pocket_cards = "Ks Kd";
+        EXPECT_FALSE(database.find_equities(table));
+        table.players.front().pocket_cards = "As Ad";
+
+        // Dead cards change the equity
+        table.dead_cards = "2c";
+        EXPECT_FALSE(database.find_equities(table));
+        table.dead_cards.clear();
+
+        // Not the flop
+        table.communal_cards = "Ah Kd 7s 2c";
+        EXPECT_FALSE(database.find_equities(table));
+        table.communal_cards = "Ah Kd 7s";
+
+        // Not heads-up
+        table.add_player(1000, "third");
+        EXPECT_FALSE(database.find_equities(table));
+        table.fold(2);
+        EXPECT_TRUE(database.find_equities(table));
+    }
+
+    std::remove(database_path.c_str());
+    EXPECT_ANY_THROW(poker_lib::flop_equity_database{database_path});
+
+    std::ofstream(database_path, std::ios::binary) << "not a flop equity database";
+    EXPECT_THROW(poker_lib::flop_equity_database{database_path}, std::invalid_argument);
+    std::remove(database_path.c_str());
+}
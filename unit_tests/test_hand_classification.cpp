@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <omp/CardRange.h>
+#include "batch_hand_evaluator.h"
+#include "hand_classification.h"
+
+static poker_lib::hand_classification classify(const std::string &pocket_cards, const std::string &board, const std::string &dead_cards = "")
+{
+    return poker_lib::classify_hand(omp::CardRange::getCardMask(pocket_cards),
+                                    omp::CardRange::getCardMask(board),
+                                    omp::CardRange::getCardMask(dead_cards));
+}
+
+TEST(test_hand_classification, made_hands)
+{
+    using poker_lib::hand_class;
+
+    EXPECT_EQ(hand_class::high_card, classify("As Kd", "").made_hand);
+    EXPECT_EQ(hand_class::pair, classify("As Ad", "").made_hand);
+    EXPECT_EQ(hand_class::pair, classify("As Kd", "Ah 7c 2d").made_hand);
+    EXPECT_EQ(hand_class::two_pair, classify("As Kd", "Ah Kc 2d 2s").made_hand);
+    EXPECT_EQ(hand_class::three_of_a_kind, classify("7s 7d", "Ah 7c 2d").made_hand);
+    EXPECT_EQ(hand_class::straight, classify("As 2d", "3h 4c 5d").made_hand);
+    EXPECT_EQ(hand_class::flush, classify("As 2s", "3s 9s Js").made_hand);
+    EXPECT_EQ(hand_class::full_house, classify("7s 7d", "7c 2d 2s 2h").made_hand);
+    EXPECT_EQ(hand_class::four_of_a_kind, classify("7s 7d", "7c 7h 2s").made_hand);
+    EXPECT_EQ(hand_class::straight_flush, classify("As Ks", "Qs Js Ts").made_hand);
+}
+
+TEST(test_hand_classification, same_category_as_evaluator)
+{
+    const poker_lib::batch_hand_evaluator evaluator;
+    std::mt19937 rng(5);
+    for (size_t hand = 0; hand < 10000; ++hand)
+    {
+        std::vector<uint8_t> deck(52);
+        std::iota(deck.begin(), deck.end(), 0);
+        std::shuffle(deck.begin(), deck.end(), rng);
+
+        poker_lib::seven_cards cards{};
+        uint64_t board_mask = 0;
+        uint64_t pocket_mask = 0;
+        for (size_t card = 0; card < 7; ++card)
+        {
+            cards[card] = deck[card];
+            (card < 5 ? board_mask : pocket_mask) |= uint64_t{1} << deck[card];
+        }
+
+        EXPECT_EQ(poker_lib::get_hand_category(evaluator.evaluate(cards)),
+                  static_cast<unsigned>(poker_lib::classify_hand(pocket_mask, board_mask).made_hand));
+    }
+}
+
+TEST(test_hand_classification, draws_and_outs)
+{
+    auto hand = classify("Ah Kh", "Qh 7h 2c");
+    EXPECT_TRUE(hand.has_flush_draw);
+    EXPECT_FALSE(hand.has_open_ended_straight_draw);
+    EXPECT_FALSE(hand.has_gutshot);
+    EXPECT_EQ(9, hand.num_of_flush_outs);
+    EXPECT_EQ(9, hand.num_of_outs);
+
+    // Dead cards aren't outs
+    EXPECT_EQ(7, classify("Ah Kh", "Qh 7h 2c", "3h 4h").num_of_outs);
+
+    hand = classify("9s 8d", "Tc 7h 2c");
+    EXPECT_TRUE(hand.has_open_ended_straight_draw);
+    EXPECT_EQ(8, hand.num_of_straight_outs);
+
+    hand = classify("9s 8d", "Jc 7h 2c");
+    EXPECT_TRUE(hand.has_gutshot);
+    EXPECT_EQ(4, hand.num_of_outs);
+
+    // A double gutshot has as many outs as an open-ended draw but isn't one
+    hand = classify("9s 7d", "Jc 8h 5c");
+    EXPECT_FALSE(hand.has_open_ended_straight_draw);
+    EXPECT_TRUE(hand.has_gutshot);
+    EXPECT_EQ(8, hand.num_of_straight_outs);
+
+    // Only the five completes the wheel draw, the ace is already in the hand
+    hand = classify("As 2d", "3c 4h 9c");
+    EXPECT_FALSE(hand.has_open_ended_straight_draw);
+    EXPECT_TRUE(hand.has_gutshot);
+    hand = classify("5s 2d", "3c 4h 9c");
+    EXPECT_TRUE(hand.has_open_ended_straight_draw);
+
+    // Open-ended straight flush draw, the 6c and Jc complete both
+    hand = classify("9c 8c", "Tc 7c 2h");
+    EXPECT_TRUE(hand.has_flush_draw);
+    EXPECT_TRUE(hand.has_open_ended_straight_draw);
+    EXPECT_EQ(9, hand.num_of_flush_outs);
+    EXPECT_EQ(8, hand.num_of_straight_outs);
+    EXPECT_EQ(15, hand.num_of_outs);
+
+    // Draws have to use a pocket card
+    hand = classify("As Ad", "9h 8h 7h 6h");
+    EXPECT_FALSE(hand.has_flush_draw);
+    EXPECT_FALSE(hand.has_open_ended_straight_draw);
+    EXPECT_EQ(0, hand.num_of_outs);
+
+    // No draws are left on the river
+    EXPECT_EQ(0, classify("Ah Kh", "Qh 7h 2c 3d 4s").num_of_outs);
+}
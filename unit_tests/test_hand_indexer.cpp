@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+#include "hand_indexer.h"
+
+TEST(test_hand_indexer, sizes_match_the_number_of_isomorphism_classes)
+{
+    EXPECT_EQ(169, poker_lib::hand_indexer({2}).size());
+    EXPECT_EQ(1286792, poker_lib::hand_indexer({2, 3}).size());
+    EXPECT_EQ(55190538, poker_lib::hand_indexer({2, 3, 1}).size());
+    EXPECT_EQ(2428287420, poker_lib::hand_indexer({2, 3, 1, 1}).size());
+
+    EXPECT_THROW(poker_lib::hand_indexer({}), std::invalid_argument);
+    EXPECT_THROW(poker_lib::hand_indexer({2, 0}), std::invalid_argument);
+    EXPECT_THROW(poker_lib::hand_indexer({2, 3, 1, 1, 1}), std::invalid_argument);
+    EXPECT_THROW(poker_lib::hand_indexer({5, 3}), std::invalid_argument);
+}
+
+TEST(test_hand_indexer, pre_flop_indices_are_a_bijection)
+{
+    const poker_lib::hand_indexer indexer({2});
+    std::set<uint64_t> indices;
+    for (uint8_t first = 0; first < 52; ++first)
+    {
+        for (uint8_t second = 0; second < 52; ++second)
+        {
+            if (first != second) { indices.emplace(indexer.get_index({first, second})); }
+        }
+    }
+    EXPECT_EQ(169, indices.size());
+    EXPECT_EQ(168, *indices.rbegin());
+
+    for (uint64_t index = 0; index < indexer.size(); ++index)
+    {
+        EXPECT_EQ(index, indexer.get_index(indexer.get_cards(index)));
+    }
+    EXPECT_THROW(indexer.get_cards(169), std::invalid_argument);
+}
+
+TEST(test_hand_indexer, suit_permutations_share_the_index)
+{
+    std::mt19937_64 rng(1);
+    // The last two layouts aren't compiled for their cards per round
+    for (const auto &cards_per_round : std::vector<std::vector<uint8_t>>{{2, 3}, {2, 3, 1}, {2, 3, 1, 1}, {3, 1}, {2, 2, 1}})
+    {
+        const poker_lib::hand_indexer indexer(cards_per_round);
+        for (size_t hand = 0; hand < 2000; ++hand)
+        {
+            std::array<uint8_t, 52> deck{};
+            for (uint8_t card = 0; card < 52; ++card) { deck[card] = card; }
+            std::shuffle(deck.begin(), deck.end(), rng);
+            poker_lib::indexed_cards cards{};
+            std::copy_n(deck.begin(), cards.size(), cards.begin());
+
+            const auto index = indexer.get_index(cards);
+            ASSERT_LT(index, indexer.size());
+
+            std::array<uint8_t, 4> suits{0, 1, 2, 3};
+            std::shuffle(suits.begin(), suits.end(), rng);
+            auto permuted = cards;
+            for (auto &card : permuted) { card = static_cast<uint8_t>(card / 4 * 4 + suits[card % 4]); }
+            // The order within a round doesn't matter either
+            std::reverse(permuted.begin(), permuted.begin() + 2);
+            EXPECT_EQ(index, indexer.get_index(permuted));
+
+            const auto canonical = indexer.get_cards(index);
+            EXPECT_EQ(index, indexer.get_index(canonical));
+
+            const auto random_index = std::uniform_int_distribution<uint64_t>(0, indexer.size() - 1)(rng);
+            EXPECT_EQ(random_index, indexer.get_index(indexer.get_cards(random_index)));
+        }
+    }
+}
+
+TEST(test_hand_indexer, isomorphism_classes_of_strings)
+{
+    EXPECT_EQ(poker_lib::get_isomorphism_class("As Kd", "Qh Jh Th"), poker_lib::get_isomorphism_class("Ac Ks", "Qd Jd Td"));
+    EXPECT_NE(poker_lib::get_isomorphism_class("As Kd", "Qh Jh Th"), poker_lib::get_isomorphism_class("As Kd", "Qd Jd Td"));
+    EXPECT_EQ(poker_lib::get_isomorphism_class("7c 2d", ""), poker_lib::get_isomorphism_class("7h 2s", ""));
+    // Turn and river are different rounds
+    EXPECT_NE(poker_lib::get_isomorphism_class("As Ad", "Kh Qh 2c 2d 3c"), poker_lib::get_isomorphism_class("As Ad", "Kh Qh 2c 3c 2d"));
+
+    EXPECT_THROW(poker_lib::get_isomorphism_class("As", ""), std::invalid_argument);
+    EXPECT_THROW(poker_lib::get_isomorphism_class("As Kd", "Qh Jh"), std::invalid_argument);
+    EXPECT_THROW(poker_lib::get_isomorphism_class("As Kd", "As Jh Th"), std::invalid_argument);
+}
@@ -0,0 +1,64 @@
+#include <cstdio>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include "heads_up_solver.h"
+#include "table/holdem_table_state_manager.h"
+
+TEST(test_heads_up_solver, train_and_query_policy)
+{
+    const auto policy_path = (std::filesystem::temp_directory_path() / "test_heads_up_policy.bin").string();
+
+    poker_lib::heads_up_training_config config;
+    config.abstraction.stack = 40;
+    config.iterations = 2000;
+    config.iterations_per_epoch = 500;
+    config.num_of_threads = 2;
+
+    const auto stats = poker_lib::train_heads_up_policy(config, policy_path);
+    EXPECT_EQ(config.iterations, stats.iterations);
+    EXPECT_GT(stats.num_of_information_sets, 0);
+
+    {
+        const poker_lib::heads_up_policy policy(policy_path);
+        EXPECT_EQ(config.abstraction.stack, policy.get_abstraction().stack);
+        EXPECT_GT(policy.get_num_of_information_sets(), 0);
+
+        poker_lib::holdem_table_state_manager state_manager({{40, ""}, {40, ""}}, 0, 1, 2);
+        // Acting player's pocket cards are unknown
+        EXPECT_FALSE(policy.get_action_probabilities(state_manager.get_table_state()));
+
+        state_manager.set_pocket_cards(0, "As Ad");
+        const auto probabilities = policy.get_action_probabilities(state_manager.get_table_state());
+        ASSERT_TRUE(probabilities);
+        EXPECT_NEAR(1, probabilities->at(0) + probabilities->at(1) + probabilities->at(2), 1e-9);
+        EXPECT_TRUE(policy.get_recommended_action(state_manager.get_table_state()));
+
+        // Betting continues on the flop
+        state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{});
+        state_manager.set_pocket_cards(1, "7c 2d");
+        state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{});
+        state_manager.set_flop("Ah Kd 7s");
+        EXPECT_TRUE(policy.get_action_probabilities(state_manager.get_table_state()));
+
+        // Same game at a higher blind level
+        poker_lib::holdem_table_state_manager higher_blinds({{400, ""}, {400, ""}}, 0, 10, 20);
+        higher_blinds.set_pocket_cards(0, "As Ad");
+        EXPECT_EQ(probabilities, policy.get_action_probabilities(higher_blinds.get_table_state()));
+
+        // Blinds or stack depths the policy wasn't trained for
+        poker_lib::holdem_table_state_manager other_blind_ratio({{400, ""}, {400, ""}}, 0, 5, 20);
+        other_blind_ratio.set_pocket_cards(0, "As Ad");
+        EXPECT_FALSE(policy.get_action_probabilities(other_blind_ratio.get_table_state()));
+        poker_lib::holdem_table_state_manager deep_stacks({{4000, ""}, {400000, ""}}, 0, 10, 20);
+        deep_stacks.set_pocket_cards(0, "As Ad");
+        EXPECT_FALSE(policy.get_action_probabilities(deep_stacks.get_table_state()));
+
+        // Not heads-up
+        poker_lib::holdem_table_state_manager three_players({{40, ""}, {40, ""}, {40, ""}}, 0, 1, 2);
+        three_players.set_pocket_cards(0, "As Ad");
+        EXPECT_FALSE(policy.get_action_probabilities(three_players.get_table_state()));
+    }
+
+    std::remove(policy_path.c_str());
+    EXPECT_ANY_THROW(poker_lib::heads_up_policy{policy_path});
+}
@@ -0,0 +1,268 @@
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "async_holdem_game_orchestrator.h"
+#include "holdem_game_orchestrator.h"
+#include "my_poker_lib.h"
+#include "table/holdem_table_state_manager.h"
+
+namespace {
+
+// Skips the equity calculations, the tests are only about the order of the stages
+class quick_poker_lib : public poker_lib::my_poker_lib
+{
+public:
+    poker_lib::player_analysis make_acting_player_analysis(const poker_lib::table_state&, double, double) override
+    {
+        analysing_thread_id = std::this_thread::get_id();
+        return {};
+    }
+
+    std::thread::id analysing_thread_id;
+};
+
+// Every player checks or calls until the opponent's queens win each showdown. The first pocket cards can't be parsed,
+// the first dead cards are already on the board and the second ones are dealt later.
+struct game_script
+{
+    std::string get_user_pocket_cards() { return _is_first_pocket_cards ? (_is_first_pocket_cards = false, "Xx Yy") : "As Ks"; }
+    std::string get_dead_cards()
+    {
+        switch (_num_of_dead_cards_requests++)
+        {
+        case 0: return "8h";
+        case 2: return "2c";
+        case 3: return "2d";
+        default: return "";
+        }
+    }
+    std::string get_player_pocket_cards() const { return "Qh Qd"; }
+    std::string get_flop() const { return "2c 3d 4h"; }
+    std::string get_turn() const { return "9s"; }
+    std::string get_river() const { return "Tc"; }
+    poker_lib::player_action_t get_action() const { return poker_lib::player_action_check_or_call{}; }
+
+    bool _is_first_pocket_cards = true;
+    size_t _num_of_dead_cards_requests = 0;
+};
+
+class scripted_user_interaction : public poker_lib::i_user_interaction
+{
+public:
+    std::string get_user_pocket_cards() override { return _script.get_user_pocket_cards(); }
+    std::string get_player_pocket_cards(size_t) override { return _script.get_player_pocket_cards(); }
+    std::string get_flop() override { return _script.get_flop(); }
+    std::string get_turn() override { return _script.get_turn(); }
+    std::string get_river() override { return _script.get_river(); }
+    std::string get_dead_cards() override { return _script.get_dead_cards(); }
+
+    poker_lib::player_action_t get_user_action() override { return _script.get_action(); }
+    poker_lib::player_action_t get_opponent_action() override { return _script.get_action(); }
+
+    void notify_player(const std::string &message) override { messages.emplace_back(message); }
+
+    std::vector<std::string> messages;
+
+private:
+    game_script _script;
+};
+
+// Queues the answers on a single threaded event loop shared by all games
+class event_loop_user_interaction : public poker_lib::i_async_user_interaction
+{
+public:
+    explicit event_loop_user_interaction(std::deque<std::function<void()>> &event_loop)
+    :
+        _event_loop(event_loop)
+    {
+    }
+
+    void get_user_pocket_cards(cards_continuation on_cards) override { answer(on_cards, _script.get_user_pocket_cards()); }
+    void get_player_pocket_cards(size_t, cards_continuation on_cards) override { answer(on_cards, _script.get_player_pocket_cards()); }
+    void get_flop(cards_continuation on_cards) override { answer(on_cards, _script.get_flop()); }
+    void get_turn(cards_continuation on_card) override { answer(on_card, _script.get_turn()); }
+    void get_river(cards_continuation on_card) override { answer(on_card, _script.get_river()); }
+    void get_dead_cards(cards_continuation on_cards) override { answer(on_cards, _script.get_dead_cards()); }
+
+    void get_user_action(action_continuation on_action) override { answer(on_action, _script.get_action()); }
+    void get_opponent_action(action_continuation on_action) override { answer(on_action, _script.get_action()); }
+
+    void notify_player(const std::string &message) override { messages.emplace_back(message); }
+
+    std::vector<std::string> messages;
+
+private:
+    template <typename ContinuationT, typename InputT>
+    void answer(ContinuationT continuation, InputT input)
+    {
+        _event_loop.emplace_back([continuation, input](){ continuation(input); });
+    }
+
+    std::deque<std::function<void()>> &_event_loop;
+    game_script _script;
+};
+
+// Runs the analyses one at a time on its worker and queues their continuations for the thread driving the games
+class worker_analysis_executor : public poker_lib::i_analysis_executor
+{
+public:
+    worker_analysis_executor() : _thread([this](){ run_worker(); }) {}
+
+    ~worker_analysis_executor() override
+    {
+        {
+            const std::lock_guard<std::mutex> lock(_mutex);
+            _is_stopping = true;
+        }
+        _has_changed.notify_all();
+        _thread.join();
+    }
+
+    void run(std::function<void()> work, std::function<void()> on_finished) override
+    {
+        {
+            const std::lock_guard<std::mutex> lock(_mutex);
+            _work.emplace_back(std::move(work), std::move(on_finished));
+        }
+        _has_changed.notify_all();
+    }
+
+    // Waits until at least one analysis finished if none is queued
+    std::deque<std::function<void()>> take_finished()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _has_changed.wait(lock, [this](){ return !_finished.empty(); });
+        return std::exchange(_finished, {});
+    }
+
+private:
+    void run_worker()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true)
+        {
+            _has_changed.wait(lock, [this](){ return !_work.empty() || _is_stopping; });
+            if (_work.empty())
+            {
+                return;
+            }
+            auto [work, on_finished] = std::move(_work.front());
+            _work.pop_front();
+
+            lock.unlock();
+            work();
+            lock.lock();
+            _finished.emplace_back(std::move(on_finished));
+            _has_changed.notify_all();
+        }
+    }
+
+    std::mutex _mutex;
+    std::condition_variable _has_changed;
+    std::deque<std::pair<std::function<void()>, std::function<void()>>> _work;
+    std::deque<std::function<void()>> _finished;
+    bool _is_stopping = false;
+    std::thread _thread;
+};
+
+} // end of anonymous namespace
+
+TEST(test_holdem_game_orchestrator, one_thread_drives_many_games)
+{
+    quick_poker_lib poker_lib;
+
+    scripted_user_interaction blocking_interaction;
+    poker_lib::holdem_table_state_manager blocking_table({{60, "user"}, {60, "opponent"}}, 0, 10, 20);
+    poker_lib::holdem_game_orchestrator(poker_lib, blocking_interaction, blocking_table, 0).run_game();
+    ASSERT_FALSE(blocking_interaction.messages.empty());
+    EXPECT_EQ("Cannot parse card(s), please try again", blocking_interaction.messages.front());
+    EXPECT_EQ(1, std::count(blocking_interaction.messages.begin(), blocking_interaction.messages.end(),
+                            "At least one of the cards is already on the board, dead or in known pocket cards"));
+    EXPECT_EQ("Game ended, bye!", blocking_interaction.messages.back());
+
+    constexpr size_t num_of_games = 100;
+    std::deque<std::function<void()>> event_loop;
+    std::vector<std::unique_ptr<event_loop_user_interaction>> interactions;
+    std::vector<std::unique_ptr<poker_lib::holdem_table_state_manager>> tables;
+    std::vector<std::unique_ptr<poker_lib::async_holdem_game_orchestrator>> games;
+    size_t num_of_ended_games = 0;
+    for (size_t game = 0; game < num_of_games; ++game)
+    {
+        interactions.emplace_back(std::make_unique<event_loop_user_interaction>(event_loop));
+        tables.emplace_back(std::make_unique<poker_lib::holdem_table_state_manager>(std::vector<poker_lib::initial_player_state>{{60, "user"}, {60, "opponent"}}, 0, 10, 20));
+        games.emplace_back(std::make_unique<poker_lib::async_holdem_game_orchestrator>(poker_lib, *interactions.back(), *tables.back(), 0));
+        games.back()->start_game([&num_of_ended_games](){ ++num_of_ended_games; });
+        EXPECT_FALSE(games.back()->has_ended());
+    }
+    EXPECT_THROW(games.front()->start_game(), std::logic_error);
+
+    // Every game waits for one input at a time so the games take turns
+    EXPECT_EQ(num_of_games, event_loop.size());
+    while (!event_loop.empty())
+    {
+        const auto next_event = std::move(event_loop.front());
+        event_loop.pop_front();
+        next_event();
+    }
+
+    EXPECT_EQ(num_of_games, num_of_ended_games);
+    for (size_t game = 0; game < num_of_games; ++game)
+    {
+        EXPECT_TRUE(games[game]->has_ended());
+        EXPECT_EQ(blocking_interaction.messages, interactions[game]->messages);
+        EXPECT_EQ(blocking_table.get_table_state().get_stack(1), tables[game]->get_table_state().get_stack(1));
+    }
+}
+
+TEST(test_holdem_game_orchestrator, analyses_run_on_executor)
+{
+    quick_poker_lib poker_lib;
+
+    scripted_user_interaction blocking_interaction;
+    poker_lib::holdem_table_state_manager blocking_table({{60, "user"}, {60, "opponent"}}, 0, 10, 20);
+    poker_lib::holdem_game_orchestrator(poker_lib, blocking_interaction, blocking_table, 0).run_game();
+    EXPECT_EQ(std::this_thread::get_id(), poker_lib.analysing_thread_id);
+
+    constexpr size_t num_of_games = 10;
+    worker_analysis_executor executor;
+    std::deque<std::function<void()>> event_loop;
+    std::vector<std::unique_ptr<event_loop_user_interaction>> interactions;
+    std::vector<std::unique_ptr<poker_lib::holdem_table_state_manager>> tables;
+    std::vector<std::unique_ptr<poker_lib::async_holdem_game_orchestrator>> games;
+    size_t num_of_ended_games = 0;
+    for (size_t game = 0; game < num_of_games; ++game)
+    {
+        interactions.emplace_back(std::make_unique<event_loop_user_interaction>(event_loop));
+        tables.emplace_back(std::make_unique<poker_lib::holdem_table_state_manager>(std::vector<poker_lib::initial_player_state>{{60, "user"}, {60, "opponent"}}, 0, 10, 20));
+        games.emplace_back(std::make_unique<poker_lib::async_holdem_game_orchestrator>(poker_lib, *interactions.back(), *tables.back(), 0, &executor));
+        games.back()->start_game([&num_of_ended_games](){ ++num_of_ended_games; });
+    }
+
+    // Games waiting for their analyses leave the event loop to the others
+    while (num_of_ended_games < num_of_games)
+    {
+        if (event_loop.empty())
+        {
+            event_loop = executor.take_finished();
+        }
+        const auto next_event = std::move(event_loop.front());
+        event_loop.pop_front();
+        next_event();
+    }
+
+    EXPECT_NE(std::this_thread::get_id(), poker_lib.analysing_thread_id);
+    for (size_t game = 0; game < num_of_games; ++game)
+    {
+        EXPECT_EQ(blocking_interaction.messages, interactions[game]->messages);
+        EXPECT_EQ(blocking_table.get_table_state().get_stack(1), tables[game]->get_table_state().get_stack(1));
+    }
+}
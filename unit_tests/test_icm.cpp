@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <numeric>
+#include "icm.h"
+#include "my_poker_lib.h"
+#include "table/holdem_table_state_manager.h"
+
+TEST(test_icm, exact_icm)
+{
+    const std::vector<double> payouts{50, 30, 20};
+
+    for (const auto payout : poker_lib::calculate_icm_exact({1000, 1000, 1000}, payouts))
+    {
+        EXPECT_NEAR(100.0 / 3, payout, 1e-9);
+    }
+
+    // Heads-up the first place is won proportionally to stacks
+    const auto heads_up = poker_lib::calculate_icm_exact({3000, 1000}, {70, 30});
+    EXPECT_NEAR(60, heads_up[0], 1e-9);
+    EXPECT_NEAR(40, heads_up[1], 1e-9);
+
+    // First: 0.5 * 50, second: 0.3 * (0.5 / 0.7 * 30 + 0.2 / 0.5 * 30) ...
+    const auto result = poker_lib::calculate_icm_exact({5000, 3000, 2000}, payouts);
+    EXPECT_NEAR(100, std::accumulate(result.begin(), result.end(), 0.0), 1e-9);
+    EXPECT_NEAR(38.392857, result[0], 1e-6);
+    EXPECT_GT(result[0], result[1]);
+    EXPECT_GT(result[1], result[2]);
+
+    // Busted players take the last places
+    const auto with_busted = poker_lib::calculate_icm_exact({5000, 0, 5000}, payouts);
+    EXPECT_NEAR(20, with_busted[1], 1e-9);
+    EXPECT_NEAR(40, with_busted[0], 1e-9);
+
+    EXPECT_ANY_THROW(poker_lib::calculate_icm_exact(std::vector<uint64_t>(11, 100), payouts));
+}
+
+TEST(test_icm, monte_carlo_matches_exact)
+{
+    const std::vector<uint64_t> stacks{5000, 3000, 2000, 1500, 700, 300, 100};
+    const std::vector<double> payouts{50, 30, 20};
+
+    const auto exact = poker_lib::calculate_icm_exact(stacks, payouts);
+    const auto monte_carlo = poker_lib::calculate_icm_monte_carlo(stacks, payouts, 200000, 7);
+
+    for (size_t pos = 0; pos < stacks.size(); ++pos)
+    {
+        EXPECT_NEAR(exact[pos], monte_carlo[pos], 0.3);
+    }
+    EXPECT_EQ(monte_carlo, poker_lib::calculate_icm_monte_carlo(stacks, payouts, 200000, 7));
+}
+
+TEST(test_icm, calculator_cache)
+{
+    poker_lib::icm_calculator calculator({50, 30, 20}, 1000);
+
+    const auto first = calculator.get_expected_payouts({100, 200, 300});
+    EXPECT_EQ(0, calculator.get_num_of_cache_hits());
+    EXPECT_EQ(first, calculator.get_expected_payouts({100, 200, 300}));
+    EXPECT_EQ(1, calculator.get_num_of_cache_hits());
+
+    // Large fields go through Monte Carlo
+    const auto large_field = calculator.get_expected_payouts(std::vector<uint64_t>(20, 100));
+    EXPECT_NEAR(100, std::accumulate(large_field.begin(), large_field.end(), 0.0), 1e-9);
+
+    EXPECT_ANY_THROW(poker_lib::icm_calculator({}));
+}
+
+TEST(test_icm, folds_coin_flip_on_bubble)
+{
+    // Two paid places and a very short stack at the table, calling an all-in for half of the pot
+    // is profitable in chips but not in tournament payout
+    poker_lib::holdem_table_state_manager state_manager({{1000, "a"}, {1000, "b"}, {100, "c"}}, 2, 10, 20);
+    state_manager.set_pocket_cards(1, "Ks Kd");
+    state_manager.set_acting_player_action(poker_lib::player_action_fold{});
+    state_manager.set_acting_player_action(poker_lib::player_action_raise{980});
+
+    const auto &table = state_manager.get_table_state();
+    ASSERT_EQ(1, table.acting_player_pos);
+
+    poker_lib::icm_calculator calculator({50, 50});
+    const std::vector<double> equities{0.5, 0.5, 0};
+
+    const auto fold = poker_lib::calculate_action_icm_payout(table, equities, poker_lib::player_action_fold{}, calculator);
+    const auto call = poker_lib::calculate_action_icm_payout(table, equities, poker_lib::player_action_check_or_call{}, calculator);
+
+    EXPECT_GT(fold, call);
+    EXPECT_NEAR(25, call, 1);
+}
+
+TEST(test_icm, side_pots)
+{
+    // The short stack is all in and can only win the main pot, the side pot goes to one of the others
+    poker_lib::holdem_table_state_manager state_manager({{1000, "a"}, {1000, "b"}, {100, "c"}}, 2, 10, 20);
+    state_manager.set_pocket_cards(0, "Ks Kd");
+    state_manager.set_acting_player_action(poker_lib::player_action_raise{80});
+
+    const auto &table = state_manager.get_table_state();
+    ASSERT_EQ(0, table.acting_player_pos);
+
+    // Winner takes all so the payout is proportional to the expected stack:
+    // 500 + 0.25 * (300 + 800) + 0.5 * 0.5 * 800 = 975 out of 2100 chips
+    poker_lib::icm_calculator calculator({100});
+    const std::vector<double> equities{0.25, 0.25, 0.5};
+    const auto raise = poker_lib::calculate_action_icm_payout(table, equities, poker_lib::player_action_raise{400}, calculator);
+    EXPECT_NEAR(100 * 975.0 / 2100, raise, 1e-9);
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include "look_ahead_search.h"
+#include "table/holdem_table_state_manager.h"
+
+static poker_lib::holdem_table_state_manager make_heads_up_pre_flop()
+{
+    poker_lib::holdem_table_state_manager state_manager({{1000, ""}, {1000, ""}}, 0, 10, 20);
+    state_manager.set_pocket_cards(0, "As Ad");
+    return state_manager;
+}
+
+TEST(test_look_ahead_search, raises_with_strong_hand)
+{
+    const auto state_manager = make_heads_up_pre_flop();
+
+    const auto result = poker_lib::search_best_action(state_manager.get_table_state(), {0.85, 0.15}, poker_lib::look_ahead_config{});
+
+    EXPECT_TRUE(std::holds_alternative<poker_lib::player_action_raise>(result.best_action));
+    EXPECT_EQ(4, result.root_actions.size());
+    EXPECT_GT(result.visited_nodes, result.root_actions.size());
+}
+
+TEST(test_look_ahead_search, folds_weak_hand_to_big_raise)
+{
+    auto state_manager = make_heads_up_pre_flop();
+    state_manager.set_acting_player_action(poker_lib::player_action_raise{500});
+
+    const auto result = poker_lib::search_best_action(state_manager.get_table_state(), {0.9, 0.1}, poker_lib::look_ahead_config{});
+
+    EXPECT_TRUE(std::holds_alternative<poker_lib::player_action_fold>(result.best_action));
+    for (const auto &root_action : result.root_actions)
+    {
+        EXPECT_LE(root_action.expected_value, 0);
+    }
+}
+
+TEST(test_look_ahead_search, stays_within_budget)
+{
+    const auto state_manager = make_heads_up_pre_flop();
+
+    poker_lib::look_ahead_config config;
+    config.max_nodes = 4;
+
+    const auto result = poker_lib::search_best_action(state_manager.get_table_state(), {0.5, 0.5}, config);
+    EXPECT_TRUE(result.is_budget_exhausted);
+    EXPECT_LE(result.visited_nodes, config.max_nodes);
+}
+
+TEST(test_look_ahead_search, invalid_arguments)
+{
+    poker_lib::holdem_table_state_manager state_manager({{1000, ""}, {1000, ""}}, 0, 10, 20);
+    // Pocket cards haven't been dealt yet
+    EXPECT_ANY_THROW(poker_lib::search_best_action(state_manager.get_table_state(), {0.5, 0.5}, poker_lib::look_ahead_config{}));
+
+    state_manager.set_pocket_cards(0, "As Ad");
+    EXPECT_ANY_THROW(poker_lib::search_best_action(state_manager.get_table_state(), {0.5}, poker_lib::look_ahead_config{}));
+}
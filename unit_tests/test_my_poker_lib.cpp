@@ -25,27 +25,42 @@ TEST(test_my_poker_lib, get_winner_positions)
 
     poker_lib::table_state table;
     table.current_stage = poker_lib::game_stages::showdown;
-    auto& players = table.players;
     EXPECT_ANY_THROW(poker_lib.get_winner_positions(table));
 
     table.communal_cards = "As Ks Qs 2c 3c";
 
-    players.emplace_back(poker_lib::player_state{100, {}, {}, "player1"});
-    players.back().per_game_state.contribution_to_pot = 50;
-    players.back().per_game_state.pocket_cards = "Js Ts";
+    table.add_player(100, "player1");
+    table.seats.contributions.at(0) = 50;
+    table.players.back().pocket_cards = "Js Ts";
 
-    players.emplace_back(poker_lib::player_state{100, {}, {}, "player2"});
-    players.back().per_game_state.contribution_to_pot = 50;
-    players.back().per_game_state.pocket_cards = "Jd Td";
+    table.add_player(100, "player2");
+    table.seats.contributions.at(1) = 50;
+    table.players.back().pocket_cards = "Jd Td";
 
     {
         const auto result = poker_lib.get_winner_positions(table);
         EXPECT_EQ(result, std::unordered_set<size_t>{0});
     }
     {
-        players.front().per_game_state.pocket_cards = "Jh Th";
+        table.players.front().pocket_cards = "Jh Th";
         const auto result = poker_lib.get_winner_positions(table);
         const std::unordered_set<size_t> expected{0, 1};
         EXPECT_EQ(result, expected);
     }
 }
+
+TEST(test_my_poker_lib, calculate_equities_with_blocked_range)
+{
+    poker_lib::table_state table;
+    table.current_stage = poker_lib::game_stages::river_betting_round;
+    table.communal_cards = "As Ah Ad Ks 2c";
+
+    table.add_player(100, "player1");
+    table.players.back().pocket_cards = "Kh Kd";
+    table.add_player(100, "player2");
+
+    // Every combo of the range is blocked, so player2 holds a random hand instead
+    const auto equities = poker_lib::calculate_equities(table, nullptr, {"", "AA,KK"});
+    ASSERT_EQ(2, equities.size());
+    EXPECT_GT(equities.front(), 0.9);
+}
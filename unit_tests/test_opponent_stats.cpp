@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include "opponent_stats.h"
+#include "table/holdem_table_state_manager.h"
+
+// Alice raises, Bob calls from the small blind and Carol folds her big blind. Bob checks the flop, Alice bets and Bob
+// answers with bob_response. A called bet is checked down to Alice winning.
+static poker_lib::table_state play_continuation_bet_round(const poker_lib::player_action_t &bob_response = poker_lib::player_action_fold{})
+{
+    poker_lib::holdem_table_state_manager state_manager({{1000, "alice"}, {1000, "bob"}, {1000, "carol"}}, 0, 10, 20);
+    state_manager.set_pocket_cards(0, "As Ks");
+
+    state_manager.set_acting_player_action(poker_lib::player_action_raise{40});
+    state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{});
+    state_manager.set_acting_player_action(poker_lib::player_action_fold{});
+
+    state_manager.set_flop("Ah 7c 2d");
+    state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{});
+    state_manager.set_acting_player_action(poker_lib::player_action_raise{60});
+    state_manager.set_acting_player_action(bob_response);
+
+    if (std::holds_alternative<poker_lib::player_action_check_or_call>(bob_response))
+    {
+        state_manager.set_turn("9s");
+        state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{});
+        state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{});
+        state_manager.set_river("Tc");
+        state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{});
+        state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{});
+    }
+
+    state_manager.execute_showdown({0});
+    EXPECT_EQ(poker_lib::game_stages::end_of_round, state_manager.get_table_state().current_stage);
+    return state_manager.get_table_state();
+}
+
+TEST(test_opponent_stats, update)
+{
+    poker_lib::opponent_stats_store store;
+    store.update(play_continuation_bet_round());
+    ASSERT_EQ(3, store.size());
+
+    const auto &alice = *store.find("alice");
+    EXPECT_EQ(1, alice.num_of_hands);
+    EXPECT_EQ(1, alice.get_vpip());
+    EXPECT_EQ(1, alice.get_pre_flop_raise_ratio());
+    EXPECT_EQ(1, alice.num_of_bets_and_raises);
+    EXPECT_EQ(0, alice.num_of_faced_continuation_bets);
+
+    const auto &bob = *store.find("bob");
+    EXPECT_EQ(1, bob.get_vpip());
+    EXPECT_EQ(0, bob.get_pre_flop_raise_ratio());
+    // Checking before the bet isn't a call
+    EXPECT_EQ(0, bob.num_of_calls);
+    EXPECT_EQ(1, bob.num_of_faced_continuation_bets);
+    EXPECT_EQ(1, bob.get_fold_to_continuation_bet_ratio());
+
+    const auto &carol = *store.find("carol");
+    EXPECT_EQ(0, carol.get_vpip());
+    EXPECT_EQ(0, carol.num_of_faced_continuation_bets);
+
+    EXPECT_EQ(nullptr, store.find("dave"));
+    EXPECT_TRUE(store.get_range("dave").empty());
+
+    // Calling the bet counts but the checks on the turn and the river don't
+    store.update(play_continuation_bet_round(poker_lib::player_action_check_or_call{}));
+    EXPECT_EQ(1, bob.num_of_calls);
+    EXPECT_EQ(2, bob.num_of_faced_continuation_bets);
+    EXPECT_EQ(0.5, bob.get_fold_to_continuation_bet_ratio());
+    EXPECT_EQ(0, store.find("alice")->num_of_calls);
+}
+
+TEST(test_opponent_stats, ranges)
+{
+    EXPECT_EQ("AA,KK,QQ,AKs,JJ", poker_lib::get_top_hands_range(0.02));
+    const auto all_hands = poker_lib::get_top_hands_range(1);
+    EXPECT_EQ(168, std::count(all_hands.begin(), all_hands.end(), ','));
+
+    poker_lib::opponent_stats_store store;
+    const auto table = play_continuation_bet_round();
+    for (uint32_t round = 1; round < poker_lib::opponent_stats_store::min_num_of_hands_for_range; ++round)
+    {
+        store.update(table);
+    }
+    EXPECT_TRUE(store.get_range("alice").empty());
+
+    store.update(table);
+    EXPECT_EQ(all_hands, store.get_range("alice"));
+    // Never played a hand voluntarily
+    EXPECT_TRUE(store.get_range("carol").empty());
+}
+
+TEST(test_opponent_stats, save_and_load)
+{
+    const auto stats_path = (std::filesystem::temp_directory_path() / "test_opponent_stats.bin").string();
+    std::remove(stats_path.c_str());
+    EXPECT_EQ(0, poker_lib::opponent_stats_store::load(stats_path).size());
+
+    poker_lib::opponent_stats_store store;
+    const auto table = play_continuation_bet_round();
+    for (uint32_t round = 0; round < poker_lib::opponent_stats_store::min_num_of_hands_for_range; ++round)
+    {
+        store.update(table);
+    }
+    store.save(stats_path);
+
+    const auto loaded = poker_lib::opponent_stats_store::load(stats_path);
+    ASSERT_EQ(store.size(), loaded.size());
+    for (const auto *name : {"alice", "bob", "carol"})
+    {
+        EXPECT_EQ(*store.find(name), *loaded.find(name));
+        EXPECT_EQ(store.get_range(name), loaded.get_range(name));
+    }
+
+    {
+        std::ofstream file(stats_path, std::ios::binary | std::ios::trunc);
+        file << "not a stats file";
+    }
+    EXPECT_ANY_THROW(poker_lib::opponent_stats_store::load(stats_path));
+    std::remove(stats_path.c_str());
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include "performance_stats.h"
+
+TEST(test_performance_stats, latency_histogram)
+{
+    poker_lib::latency_histogram histogram;
+    EXPECT_EQ(0, histogram.get_count());
+    EXPECT_EQ(0, histogram.get_percentile(50).count());
+
+    for (int64_t micros = 1; micros <= 1000; ++micros)
+    {
+        histogram.record(std::chrono::microseconds(micros));
+    }
+
+    EXPECT_EQ(1000, histogram.get_count());
+    EXPECT_EQ(1000000, histogram.get_max().count());
+    EXPECT_NEAR(500500, histogram.get_mean().count(), 1);
+    // Buckets are at most 1/16 wide relative to their values
+    EXPECT_NEAR(500000, histogram.get_percentile(50).count(), 500000 / 16);
+    EXPECT_NEAR(990000, histogram.get_percentile(99).count(), 990000 / 16);
+    EXPECT_EQ(1000000, histogram.get_percentile(100).count());
+
+    // Small values are exact
+    poker_lib::latency_histogram small;
+    small.record(std::chrono::nanoseconds(3));
+    EXPECT_EQ(3, small.get_percentile(50).count());
+}
+
+TEST(test_performance_stats, stats)
+{
+    poker_lib::performance_stats stats;
+
+    {
+        const poker_lib::scoped_latency_timer timer(&stats, poker_lib::pipeline_stage::equity_wait);
+    }
+    {
+        // No stats, nothing to record
+        const poker_lib::scoped_latency_timer timer(nullptr, poker_lib::pipeline_stage::equity_wait);
+    }
+    EXPECT_EQ(1, stats.get_histogram(poker_lib::pipeline_stage::equity_wait).get_count());
+    EXPECT_EQ(0, stats.get_histogram(poker_lib::pipeline_stage::output).get_count());
+
+    stats.add_to_counter(poker_lib::performance_counter::simulated_hands, 10);
+    stats.add_to_counter(poker_lib::performance_counter::simulated_hands, 5);
+    EXPECT_EQ(15, stats.get_counter(poker_lib::performance_counter::simulated_hands));
+
+    EXPECT_EQ(0, stats.get_thread_utilization());
+    stats.add_thread_time(std::chrono::milliseconds(1), std::chrono::milliseconds(1));
+    EXPECT_GT(stats.get_thread_utilization(), 0);
+    EXPECT_LE(stats.get_thread_utilization(), 1);
+
+    std::ostringstream oss;
+    stats.dump(oss);
+    EXPECT_NE(std::string::npos, oss.str().find("equity_wait"));
+    EXPECT_NE(std::string::npos, oss.str().find("simulated_hands"));
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <omp/CardRange.h>
+#include "equity_engine.h"
+#include "range_narrowing.h"
+#include "table/holdem_table_state_manager.h"
+
+static size_t get_combo_index(const std::string &cards)
+{
+    const auto mask = omp::CardRange::getCardMask(cards);
+    std::vector<uint8_t> indices;
+    for (uint8_t card = 0; card < 52; ++card)
+    {
+        if (mask & (uint64_t{1} << card)) { indices.emplace_back(card); }
+    }
+    EXPECT_EQ(2, indices.size());
+    return poker_lib::get_pocket_combo_index(indices.at(0), indices.at(1));
+}
+
+TEST(test_range_narrowing, combo_indices)
+{
+    std::vector<bool> is_used(poker_lib::num_of_pocket_combos, false);
+    for (uint8_t high_card = 1; high_card < 52; ++high_card)
+    {
+        for (uint8_t low_card = 0; low_card < high_card; ++low_card)
+        {
+            const auto index = poker_lib::get_pocket_combo_index(low_card, high_card);
+            ASSERT_LT(index, poker_lib::num_of_pocket_combos);
+            EXPECT_FALSE(is_used[index]);
+            is_used[index] = true;
+
+            const auto cards = poker_lib::get_pocket_combo_cards(index);
+            EXPECT_EQ(index, poker_lib::get_pocket_combo_index(cards[0], cards[1]));
+        }
+    }
+
+    poker_lib::pocket_combo_weights weights{};
+    weights[get_combo_index("As Ah")] = 1;
+    weights[get_combo_index("Kd 7c")] = 0.5f;
+    weights[get_combo_index("2c 3c")] = 0.1f;
+    EXPECT_EQ("AhAs", poker_lib::get_likely_combos_range(weights, 0.6f));
+    EXPECT_EQ("Kd7c,AhAs", poker_lib::get_likely_combos_range(weights, 0.2f));
+}
+
+TEST(test_range_narrowing, raises_narrow_to_strong_hands)
+{
+    poker_lib::holdem_table_state_manager state_manager({{1000, "alice"}, {1000, "bob"}}, 0, 10, 20);
+    state_manager.set_pocket_cards(0, "7c 2d");
+
+    poker_lib::range_tracker tracker;
+    EXPECT_EQ(nullptr, tracker.get_weights(1));
+
+    // The small blind calls and the big blind raises
+    tracker.observe_action(state_manager.get_table_state(), poker_lib::player_action_check_or_call{});
+    state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{});
+    tracker.observe_action(state_manager.get_table_state(), poker_lib::player_action_raise{100});
+    state_manager.set_acting_player_action(poker_lib::player_action_raise{100});
+
+    const auto *weights = tracker.get_weights(1);
+    ASSERT_NE(nullptr, weights);
+    EXPECT_GT((*weights)[get_combo_index("As Ah")], 5 * (*weights)[get_combo_index("7h 2s")]);
+    EXPECT_NEAR(poker_lib::num_of_pocket_combos, std::accumulate(weights->begin(), weights->end(), 0.0), 1);
+
+    // Raising on the flop favours the hands the flop hits
+    const auto pre_flop_weights = *weights;
+    state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{});
+    state_manager.set_flop("Ks 9d 4c");
+    tracker.observe_action(state_manager.get_table_state(), poker_lib::player_action_raise{50});
+    const auto hits = (*weights)[get_combo_index("Kh Qh")] / pre_flop_weights[get_combo_index("Kh Qh")];
+    const auto misses = (*weights)[get_combo_index("Jh Th")] / pre_flop_weights[get_combo_index("Jh Th")];
+    EXPECT_GT(hits, misses);
+    // The board blocks some combos
+    EXPECT_EQ(0, (*weights)[get_combo_index("Ks Kh")]);
+
+    tracker.reset();
+    EXPECT_EQ(nullptr, tracker.get_weights(1));
+}
+
+TEST(test_range_narrowing, ranges_feed_the_equity_engine)
+{
+    const poker_lib::batch_hand_evaluator evaluator;
+    poker_lib::table_state table;
+    table.current_stage = poker_lib::game_stages::flop_betting_round;
+    table.add_player(1000, "hero");
+    table.players.back().pocket_cards = "Qs Qd";
+    table.add_player(1000, "villain");
+    table.communal_cards = "Ks 9d 4c";
+
+    poker_lib::equity_engine_config config;
+    config.num_of_samples = 20000;
+    const auto random_result = poker_lib::calculate_seeded_equities(table, config, evaluator);
+
+    // Villain only holds kings or a set of nines
+    poker_lib::pocket_combo_weights weights{};
+    weights[get_combo_index("Kh Kd")] = 1;
+    weights[get_combo_index("9h 9s")] = 1;
+    const auto ranged_result = poker_lib::calculate_seeded_equities(table, config, evaluator, nullptr, {nullptr, &weights});
+    EXPECT_LT(ranged_result.equities[0], 0.1);
+    EXPECT_LT(ranged_result.equities[0], random_result.equities[0]);
+    EXPECT_EQ(ranged_result.equities, poker_lib::calculate_seeded_equities(table, config, evaluator, nullptr, {nullptr, &weights}).equities);
+
+    // Combos blocked by the board or hero leave a random hand
+    weights.fill(0);
+    weights[get_combo_index("Ks Kh")] = 1;
+    EXPECT_EQ(random_result.equities, poker_lib::calculate_seeded_equities(table, config, evaluator, nullptr, {nullptr, &weights}).equities);
+}
+
+TEST(test_range_narrowing, vpip_prior)
+{
+    const auto prior = poker_lib::get_vpip_prior_weights(0.05);
+    EXPECT_EQ(1, prior[get_combo_index("As Ah")]);
+    EXPECT_EQ(poker_lib::min_vpip_prior_weight, prior[get_combo_index("7h 2s")]);
+    const auto num_of_top_combos = std::count(prior.begin(), prior.end(), 1.0f);
+    EXPECT_GE(num_of_top_combos, 0.05 * poker_lib::num_of_pocket_combos);
+    EXPECT_LT(num_of_top_combos, 0.1 * poker_lib::num_of_pocket_combos);
+
+    poker_lib::holdem_table_state_manager state_manager({{1000, "alice"}, {1000, "bob"}, {1000, "carol"}}, 0, 10, 20);
+    state_manager.set_pocket_cards(0, "7c 2d");
+
+    // A tight player's call narrows the prior, a call of a random player everything
+    poker_lib::range_tracker tracker;
+    tracker.observe_action(state_manager.get_table_state(), poker_lib::player_action_check_or_call{}, &prior);
+    state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{});
+    tracker.observe_action(state_manager.get_table_state(), poker_lib::player_action_check_or_call{});
+    state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{});
+    const auto &tight = *tracker.get_weights(0);
+    const auto &loose = *tracker.get_weights(1);
+    EXPECT_GT(tight[get_combo_index("As Ah")] / tight[get_combo_index("7h 2s")],
+              5 * loose[get_combo_index("As Ah")] / loose[get_combo_index("7h 2s")]);
+
+    // The big blind checking isn't voluntary so the prior isn't used
+    tracker.observe_action(state_manager.get_table_state(), poker_lib::player_action_check_or_call{}, &prior);
+    const auto &big_blind = *tracker.get_weights(2);
+    EXPECT_LT(big_blind[get_combo_index("As Ah")] / big_blind[get_combo_index("7h 2s")], 2);
+}
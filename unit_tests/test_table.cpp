@@ -1,54 +1,50 @@
 #include <gtest/gtest.h>
 #include "table/holdem_table_state_manager.h"
 #include "table/initial_player_state.h"
+#include "table/table_state_hash.h"
 
-void contribute_to_pot(poker_lib::table_state &expected, const size_t player_pos, const uint64_t amount)
+void add_player(poker_lib::table_state &expected, const uint64_t stack, const uint64_t contribution_to_pot = 0)
 {
-    auto& player = expected.players.at(player_pos);
-
-    expected.pot += amount;
-
-    player.current_stack -= amount;
-    player.per_game_state.contribution_to_pot += amount;
+    expected.add_player(stack, "");
+    expected.seats.contributions.at(expected.get_num_of_players() - 1) = contribution_to_pot;
 }
 
 void acting_player_folds(poker_lib::table_state &expected)
 {
-    auto &acting_player = expected.players.at(expected.acting_player_pos);
-    acting_player.per_game_state.has_folded = true;
-    acting_player.get_actions(expected.current_stage).emplace_back(poker_lib::player_action_fold{});
+    expected.fold(expected.acting_player_pos);
+    expected.record_action(expected.acting_player_pos, poker_lib::player_action_fold{});
 }
 
 void acting_player_checks_or_calls(poker_lib::table_state &expected)
 {
-    auto &acting_player = expected.players.at(expected.acting_player_pos);
+    const auto pos = expected.acting_player_pos;
 
-    const auto amount_to_call = expected.total_contribution_to_stay_in_game - acting_player.per_game_state.contribution_to_pot;
-    const auto amount_available = std::min(amount_to_call, acting_player.current_stack);
+    const auto amount_to_call = expected.total_contribution_to_stay_in_game - expected.get_contribution(pos);
+    const auto amount_available = std::min(amount_to_call, expected.get_stack(pos));
 
-    contribute_to_pot(expected, expected.acting_player_pos, amount_available);
-    acting_player.get_actions(expected.current_stage).emplace_back(poker_lib::player_action_check_or_call{});
+    expected.contribute_to_pot(pos, amount_available);
+    expected.record_action(pos, poker_lib::player_action_check_or_call{});
 }
 
 void acting_player_raises(poker_lib::table_state &expected, const uint64_t raise_amount)
 {
-    auto &acting_player = expected.players.at(expected.acting_player_pos);
+    const auto pos = expected.acting_player_pos;
 
-    const auto amount_to_call = expected.total_contribution_to_stay_in_game - acting_player.per_game_state.contribution_to_pot;
-    const auto amount_available = std::min(amount_to_call + raise_amount, acting_player.current_stack);
+    const auto amount_to_call = expected.total_contribution_to_stay_in_game - expected.get_contribution(pos);
+    const auto amount_available = std::min(amount_to_call + raise_amount, expected.get_stack(pos));
 
     if (amount_available > amount_to_call)
     {
         const auto raised = amount_available - amount_to_call;
         expected.total_contribution_to_stay_in_game += raised;
-        acting_player.get_actions(expected.current_stage).emplace_back(poker_lib::player_action_raise{raised});
+        expected.record_action(pos, poker_lib::player_action_raise{raised});
     }
     else
     {
-        acting_player.get_actions(expected.current_stage).emplace_back(poker_lib::player_action_check_or_call{});
+        expected.record_action(pos, poker_lib::player_action_check_or_call{});
     }
 
-    contribute_to_pot(expected, expected.acting_player_pos, amount_available);
+    expected.contribute_to_pot(pos, amount_available);
 }
 
 TEST(test_holdem_table_state_manager, invalid_initialisations)
@@ -56,6 +52,8 @@ TEST(test_holdem_table_state_manager, invalid_initialisations)
     // Not enough players
     EXPECT_ANY_THROW(poker_lib::holdem_table_state_manager({}, 0, 10, 20));
     EXPECT_ANY_THROW(poker_lib::holdem_table_state_manager({{100, ""}}, 0, 10, 20));
+    // Too many players
+    EXPECT_ANY_THROW(poker_lib::holdem_table_state_manager(std::vector<poker_lib::initial_player_state>(poker_lib::max_num_of_players + 1, {100, ""}), 0, 10, 20));
     // Invalid dealer pos
     EXPECT_ANY_THROW(poker_lib::holdem_table_state_manager({{100, ""}, {100, ""}}, 2, 10, 20));
     // Incorrect blind sizes
@@ -80,8 +78,8 @@ TEST(test_holdem_table_state_manager, starting_state_heads_up_1st_player_deals)
     expected.acting_player_pos = 0;
     expected.dealer_pos = 0;
 
-    expected.players.emplace_back(poker_lib::player_state{90, {false, {}, 10}, {}, "" });
-    expected.players.emplace_back(poker_lib::player_state{80, {false, {}, 20}, {}, "" });
+    add_player(expected, 90, 10);
+    add_player(expected, 80, 20);
 
     poker_lib::holdem_table_state_manager state_manager({{100, ""}, {100, ""}},
                                                         expected.dealer_pos,
@@ -102,8 +100,8 @@ TEST(test_holdem_table_state_manager, starting_state_heads_up_2nd_player_deals)
     expected.acting_player_pos = 1;
     expected.dealer_pos = 1;
 
-    expected.players.emplace_back(poker_lib::player_state{80, {false, {}, 20}, {}, "" });
-    expected.players.emplace_back(poker_lib::player_state{90, {false, {}, 10}, {}, "" });
+    add_player(expected, 80, 20);
+    add_player(expected, 90, 10);
 
     poker_lib::holdem_table_state_manager state_manager({{100, ""}, {100, ""}},
                                                         expected.dealer_pos,
@@ -124,9 +122,9 @@ TEST(test_holdem_table_state_manager, starting_state_3_players_1st_player_deals)
     expected.acting_player_pos = 0;
     expected.dealer_pos = 0;
 
-    expected.players.emplace_back(poker_lib::player_state{100, {}, {}, "" });
-    expected.players.emplace_back(poker_lib::player_state{90, {false, {}, 10}, {}, "" });
-    expected.players.emplace_back(poker_lib::player_state{80, {false, {}, 20}, {}, "" });
+    add_player(expected, 100);
+    add_player(expected, 90, 10);
+    add_player(expected, 80, 20);
 
     poker_lib::holdem_table_state_manager state_manager({{100, ""}, {100, ""}, {100, ""}},
                                                         expected.dealer_pos,
@@ -147,9 +145,9 @@ TEST(test_holdem_table_state_manager, starting_state_3_players_2nd_player_deals)
     expected.acting_player_pos = 1;
     expected.dealer_pos = 1;
 
-    expected.players.emplace_back(poker_lib::player_state{80, {false, {}, 20}, {}, "" });
-    expected.players.emplace_back(poker_lib::player_state{100, {}, {}, "" });
-    expected.players.emplace_back(poker_lib::player_state{90, {false, {}, 10}, {}, "" });
+    add_player(expected, 80, 20);
+    add_player(expected, 100);
+    add_player(expected, 90, 10);
     
     poker_lib::holdem_table_state_manager state_manager({{100, ""}, {100, ""}, {100, ""}},
                                                         expected.dealer_pos,
@@ -170,8 +168,8 @@ TEST(test_holdem_table_state_manager, throws_if_unexpected_method_called)
     expected.acting_player_pos = 0;
     expected.dealer_pos = 0;
 
-    expected.players.emplace_back(poker_lib::player_state{90, {false, {}, 10}, {}, "" });
-    expected.players.emplace_back(poker_lib::player_state{80, {false, {}, 20}, {}, "" });
+    add_player(expected, 90, 10);
+    add_player(expected, 80, 20);
 
     poker_lib::holdem_table_state_manager state_manager({{100, ""}, {100, ""}},
                                                         expected.dealer_pos,
@@ -187,11 +185,11 @@ TEST(test_holdem_table_state_manager, throws_if_unexpected_method_called)
     EXPECT_EQ(expected, state_manager.get_table_state());
 
     // Move to pre-flop betting
-    expected.players.at(0).per_game_state.pocket_cards.emplace("Ac Kd");
-    expected.players.at(1).per_game_state.pocket_cards.emplace("As Ks");
+    expected.players.at(0).pocket_cards.emplace("Ac Kd");
+    expected.players.at(1).pocket_cards.emplace("As Ks");
     expected.current_stage = poker_lib::game_stages::pre_flop_betting_round;
-    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, *expected.players.at(0).per_game_state.pocket_cards));
-    EXPECT_NO_THROW(state_manager.set_pocket_cards(1, *expected.players.at(1).per_game_state.pocket_cards));
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, *expected.players.at(0).pocket_cards));
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(1, *expected.players.at(1).pocket_cards));
 
     EXPECT_EQ(expected, state_manager.get_table_state());
     EXPECT_ANY_THROW(state_manager.set_flop("Ts 9d 3c"));
@@ -211,8 +209,8 @@ TEST(test_holdem_table_state_manager, throws_if_unexpected_method_called)
     EXPECT_EQ(expected, state_manager.get_table_state());
 
     // Flop
-    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, *expected.players.at(0).per_game_state.pocket_cards));
-    EXPECT_NO_THROW(state_manager.set_pocket_cards(1, *expected.players.at(1).per_game_state.pocket_cards));
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, *expected.players.at(0).pocket_cards));
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(1, *expected.players.at(1).pocket_cards));
     EXPECT_ANY_THROW(state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{}));
     EXPECT_ANY_THROW(state_manager.set_turn("8s"));
     EXPECT_ANY_THROW(state_manager.set_river("9s"));
@@ -225,8 +223,8 @@ TEST(test_holdem_table_state_manager, throws_if_unexpected_method_called)
     EXPECT_EQ(expected, state_manager.get_table_state());
 
     // Flop betting
-    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, *expected.players.at(0).per_game_state.pocket_cards));
-    EXPECT_NO_THROW(state_manager.set_pocket_cards(1, *expected.players.at(1).per_game_state.pocket_cards));
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, *expected.players.at(0).pocket_cards));
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(1, *expected.players.at(1).pocket_cards));
     EXPECT_ANY_THROW(state_manager.set_flop("Ts 9d 3c"));
     EXPECT_ANY_THROW(state_manager.set_turn("8s"));
     EXPECT_ANY_THROW(state_manager.set_river("9s"));
@@ -244,8 +242,8 @@ TEST(test_holdem_table_state_manager, throws_if_unexpected_method_called)
     EXPECT_EQ(expected, state_manager.get_table_state());
 
     // Turn
-    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, *expected.players.at(0).per_game_state.pocket_cards));
-    EXPECT_NO_THROW(state_manager.set_pocket_cards(1, *expected.players.at(1).per_game_state.pocket_cards));
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, *expected.players.at(0).pocket_cards));
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(1, *expected.players.at(1).pocket_cards));
     EXPECT_ANY_THROW(state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{}));
     EXPECT_ANY_THROW(state_manager.set_flop("Ts 9d 3c"));
     EXPECT_ANY_THROW(state_manager.set_river("9s"));
@@ -258,8 +256,8 @@ TEST(test_holdem_table_state_manager, throws_if_unexpected_method_called)
     EXPECT_EQ(expected, state_manager.get_table_state());
 
     // Turn betting
-    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, *expected.players.at(0).per_game_state.pocket_cards));
-    EXPECT_NO_THROW(state_manager.set_pocket_cards(1, *expected.players.at(1).per_game_state.pocket_cards));
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, *expected.players.at(0).pocket_cards));
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(1, *expected.players.at(1).pocket_cards));
     EXPECT_ANY_THROW(state_manager.set_flop("Ts 9d 3c"));
     EXPECT_ANY_THROW(state_manager.set_turn("8s"));
     EXPECT_ANY_THROW(state_manager.set_river("9s"));
@@ -277,8 +275,8 @@ TEST(test_holdem_table_state_manager, throws_if_unexpected_method_called)
     EXPECT_EQ(expected, state_manager.get_table_state());
 
     // River
-    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, *expected.players.at(0).per_game_state.pocket_cards));
-    EXPECT_NO_THROW(state_manager.set_pocket_cards(1, *expected.players.at(1).per_game_state.pocket_cards));
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, *expected.players.at(0).pocket_cards));
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(1, *expected.players.at(1).pocket_cards));
     EXPECT_ANY_THROW(state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{}));
     EXPECT_ANY_THROW(state_manager.set_flop("Ts 9d 3c"));
     EXPECT_ANY_THROW(state_manager.set_turn("8s"));
@@ -291,8 +289,8 @@ TEST(test_holdem_table_state_manager, throws_if_unexpected_method_called)
     EXPECT_EQ(expected, state_manager.get_table_state());
 
     // River betting
-    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, *expected.players.at(0).per_game_state.pocket_cards));
-    EXPECT_NO_THROW(state_manager.set_pocket_cards(1, *expected.players.at(1).per_game_state.pocket_cards));
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, *expected.players.at(0).pocket_cards));
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(1, *expected.players.at(1).pocket_cards));
     EXPECT_ANY_THROW(state_manager.set_flop("Ts 9d 3c"));
     EXPECT_ANY_THROW(state_manager.set_turn("8s"));
     EXPECT_ANY_THROW(state_manager.set_river("9s"));
@@ -310,8 +308,8 @@ TEST(test_holdem_table_state_manager, throws_if_unexpected_method_called)
     EXPECT_EQ(expected, state_manager.get_table_state());
 
     // Showdown
-    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, *expected.players.at(0).per_game_state.pocket_cards));
-    EXPECT_NO_THROW(state_manager.set_pocket_cards(1, *expected.players.at(1).per_game_state.pocket_cards));
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, *expected.players.at(0).pocket_cards));
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(1, *expected.players.at(1).pocket_cards));
     EXPECT_ANY_THROW(state_manager.set_flop("Ts 9d 3c"));
     EXPECT_ANY_THROW(state_manager.set_turn("8s"));
     EXPECT_ANY_THROW(state_manager.set_river("9s"));
@@ -332,10 +330,10 @@ TEST(test_holdem_table_state_manager, full_game_4_players)
     expected.acting_player_pos = 1;
     expected.dealer_pos = 2;
 
-    expected.players.emplace_back(poker_lib::player_state{4980, {false, {}, 20}, {}, "" });
-    expected.players.emplace_back(poker_lib::player_state{4000, {}, {}, "" });
-    expected.players.emplace_back(poker_lib::player_state{2000, {}, {}, "" });
-    expected.players.emplace_back(poker_lib::player_state{4990, {false, {}, 10}, {}, "" });
+    add_player(expected, 4980, 20);
+    add_player(expected, 4000);
+    add_player(expected, 2000);
+    add_player(expected, 4990, 10);
 
     poker_lib::holdem_table_state_manager state_manager({{5000, ""}, {4000, ""}, {2000, ""}, {5000, ""}},
                                                         expected.dealer_pos,
@@ -345,8 +343,8 @@ TEST(test_holdem_table_state_manager, full_game_4_players)
     // Pocket card
     EXPECT_EQ(expected, state_manager.get_table_state());
 
-    expected.players.at(0).per_game_state.pocket_cards.emplace("As Ks");
-    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, *expected.players.at(0).per_game_state.pocket_cards));
+    expected.players.at(0).pocket_cards.emplace("As Ks");
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, *expected.players.at(0).pocket_cards));
     expected.current_stage = poker_lib::game_stages::pre_flop_betting_round;
     EXPECT_EQ(expected, state_manager.get_table_state());
 
@@ -358,8 +356,8 @@ TEST(test_holdem_table_state_manager, full_game_4_players)
         EXPECT_EQ(expected, state_manager.get_table_state());
     }
     {
-        EXPECT_NO_THROW(state_manager.set_acting_player_action(poker_lib::player_action_raise{expected.get_acting_player().current_stack}));
-        acting_player_raises(expected, expected.get_acting_player().current_stack);
+        EXPECT_NO_THROW(state_manager.set_acting_player_action(poker_lib::player_action_raise{expected.get_stack(expected.acting_player_pos)}));
+        acting_player_raises(expected, expected.get_stack(expected.acting_player_pos));
         expected.acting_player_pos = 3;
         EXPECT_EQ(expected, state_manager.get_table_state());
     }
@@ -468,7 +466,7 @@ TEST(test_holdem_table_state_manager, full_game_4_players)
     EXPECT_EQ(2, results.size());
 
     const auto& split_1 = results.front();
-    EXPECT_EQ(2000 * expected.players.size(), split_1.split_size);
+    EXPECT_EQ(2000 * expected.get_num_of_players(), split_1.split_size);
     EXPECT_EQ(3, split_1.participant_positions.size());
 
     const auto& split_2 = results.back();
@@ -477,3 +475,264 @@ TEST(test_holdem_table_state_manager, full_game_4_players)
 
     EXPECT_EQ(expected.pot, split_1.split_size + split_2.split_size);
 }
+
+TEST(test_holdem_table_state_manager, new_round_eliminates_busted_players)
+{
+    poker_lib::holdem_table_state_manager state_manager({{100, "a"}, {50, "b"}, {100, "c"}}, 0, 10, 20);
+
+    // a goes all-in, b calls all-in and c folds
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, "As Ks"));
+    EXPECT_NO_THROW(state_manager.set_acting_player_action(poker_lib::player_action_raise{80}));
+    EXPECT_NO_THROW(state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{}));
+    EXPECT_NO_THROW(state_manager.set_acting_player_action(poker_lib::player_action_fold{}));
+    EXPECT_EQ(poker_lib::game_stages::deal_communal_cards, state_manager.get_table_state().current_stage);
+    EXPECT_NO_THROW(state_manager.set_flop("2c 3c 4c"));
+    EXPECT_NO_THROW(state_manager.set_turn("5d"));
+    EXPECT_NO_THROW(state_manager.set_river("7d"));
+    EXPECT_NO_THROW(state_manager.execute_showdown({0}));
+    EXPECT_TRUE(state_manager.start_new_round());
+
+    poker_lib::table_state expected{};
+    expected.current_stage = poker_lib::game_stages::deal_pocket_cards;
+    expected.small_blind_size = 10;
+    expected.big_blind_size = 20;
+    expected.pot = 30;
+    expected.total_contribution_to_stay_in_game = expected.big_blind_size;
+    expected.acting_player_pos = 1;
+    expected.dealer_pos = 1;
+
+    add_player(expected, 150, 20);
+    add_player(expected, 70, 10);
+
+    const auto& table = state_manager.get_table_state();
+    EXPECT_EQ(expected, table);
+    EXPECT_EQ("a", table.players.at(0).player_name);
+    EXPECT_EQ("c", table.players.at(1).player_name);
+    EXPECT_EQ(2, table.get_active_and_not_all_in_player_count());
+}
+
+TEST(test_holdem_table_state_manager, short_stacks_post_all_in_blinds)
+{
+    // The second level's blinds are larger than every stack
+    poker_lib::blind_schedule schedule{{{10, 20, 0}, {500, 1000, 0}}, 1};
+    poker_lib::holdem_table_state_manager state_manager({{100, "a"}, {100, "b"}, {100, "c"}}, 0, schedule);
+
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, "As Ks"));
+    EXPECT_NO_THROW(state_manager.set_acting_player_action(poker_lib::player_action_fold{}));
+    EXPECT_NO_THROW(state_manager.set_acting_player_action(poker_lib::player_action_fold{}));
+    EXPECT_NO_THROW(state_manager.execute_showdown({2}));
+    EXPECT_TRUE(state_manager.start_new_round());
+    EXPECT_EQ(1, state_manager.get_blind_level_index());
+
+    // c is all-in for the small blind and a for the big blind, b still has to call or fold
+    const auto& table = state_manager.get_table_state();
+    EXPECT_EQ(3, table.get_num_of_players());
+    EXPECT_EQ(1, table.dealer_pos);
+    EXPECT_EQ(1, table.acting_player_pos);
+    EXPECT_EQ(210, table.pot);
+    EXPECT_EQ(110, table.total_contribution_to_stay_in_game);
+    EXPECT_TRUE(table.is_all_in(0));
+    EXPECT_TRUE(table.is_all_in(2));
+    EXPECT_EQ(poker_lib::calculate_table_hash(table), table.hash);
+
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(1, "Qs Qh"));
+    EXPECT_EQ(poker_lib::game_stages::pre_flop_betting_round, table.current_stage);
+    EXPECT_NO_THROW(state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{}));
+    EXPECT_EQ(poker_lib::game_stages::deal_communal_cards, table.current_stage);
+    EXPECT_EQ(300, table.pot);
+
+    EXPECT_NO_THROW(state_manager.set_flop("2c 3c 4c"));
+    EXPECT_NO_THROW(state_manager.set_turn("5d"));
+    EXPECT_NO_THROW(state_manager.set_river("7d"));
+    EXPECT_NO_THROW(state_manager.execute_showdown({1}));
+
+    // Busting everyone but the winner ends the game
+    EXPECT_FALSE(state_manager.start_new_round());
+    EXPECT_EQ(1, table.get_num_of_players());
+    EXPECT_EQ("b", table.players.at(0).player_name);
+    EXPECT_EQ(0, table.dealer_pos);
+}
+
+TEST(test_holdem_table_state_manager, push_and_pop_actions)
+{
+    poker_lib::holdem_table_state_manager state_manager({{1000, ""}, {1000, ""}, {500, ""}}, 0, 10, 20);
+    EXPECT_ANY_THROW(state_manager.pop_action());
+
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, "As Ks"));
+    const auto initial = state_manager.get_table_state();
+
+    // Raise, re-raise all in then the rest calls which moves the game to the flop
+    EXPECT_NO_THROW(state_manager.push_action(poker_lib::player_action_raise{100}));
+    const auto after_raise = state_manager.get_table_state();
+    EXPECT_NO_THROW(state_manager.push_action(poker_lib::player_action_raise{1000}));
+    EXPECT_NO_THROW(state_manager.push_action(poker_lib::player_action_check_or_call{}));
+    EXPECT_NO_THROW(state_manager.push_action(poker_lib::player_action_check_or_call{}));
+    EXPECT_EQ(poker_lib::game_stages::deal_communal_cards, state_manager.get_table_state().current_stage);
+    EXPECT_EQ(4, state_manager.get_num_of_pushed_actions());
+
+    // Betting is not allowed while dealing cards so the log stays intact
+    EXPECT_ANY_THROW(state_manager.push_action(poker_lib::player_action_fold{}));
+    EXPECT_EQ(4, state_manager.get_num_of_pushed_actions());
+    EXPECT_ANY_THROW(state_manager.set_acting_player_action(poker_lib::player_action_fold{}));
+    EXPECT_ANY_THROW(state_manager.set_turn("2c"));
+    EXPECT_ANY_THROW(state_manager.execute_showdown({0}));
+    EXPECT_ANY_THROW(state_manager.start_new_round());
+    EXPECT_EQ(4, state_manager.get_num_of_pushed_actions());
+
+    EXPECT_NO_THROW(state_manager.pop_action());
+    EXPECT_NO_THROW(state_manager.pop_action());
+    EXPECT_NO_THROW(state_manager.pop_action());
+    EXPECT_EQ(after_raise, state_manager.get_table_state());
+
+    // Try a different line from the same spot
+    EXPECT_NO_THROW(state_manager.push_action(poker_lib::player_action_fold{}));
+    EXPECT_NO_THROW(state_manager.push_action(poker_lib::player_action_fold{}));
+    EXPECT_EQ(poker_lib::game_stages::showdown, state_manager.get_table_state().current_stage);
+    EXPECT_NO_THROW(state_manager.pop_action());
+    EXPECT_NO_THROW(state_manager.pop_action());
+    EXPECT_NO_THROW(state_manager.pop_action());
+    EXPECT_EQ(initial, state_manager.get_table_state());
+    EXPECT_ANY_THROW(state_manager.pop_action());
+
+    // Actions can't be committed on top of pushed ones
+    EXPECT_NO_THROW(state_manager.push_action(poker_lib::player_action_check_or_call{}));
+    EXPECT_THROW(state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{}), std::logic_error);
+    EXPECT_EQ(1, state_manager.get_num_of_pushed_actions());
+    EXPECT_NO_THROW(state_manager.pop_action());
+    EXPECT_EQ(initial, state_manager.get_table_state());
+    EXPECT_NO_THROW(state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{}));
+    EXPECT_EQ(0, state_manager.get_num_of_pushed_actions());
+
+    // Dealing pocket cards clears the log so popping can't restore a hash from before the deal
+    poker_lib::holdem_table_state_manager dealing({{1000, ""}, {1000, ""}}, 0, 10, 20);
+    EXPECT_NO_THROW(dealing.set_pocket_cards(0, "As Ks"));
+    EXPECT_NO_THROW(dealing.push_action(poker_lib::player_action_check_or_call{}));
+    EXPECT_NO_THROW(dealing.set_pocket_cards(1, "Qs Qh"));
+    EXPECT_EQ(0, dealing.get_num_of_pushed_actions());
+    EXPECT_ANY_THROW(dealing.pop_action());
+    EXPECT_EQ(poker_lib::calculate_table_hash(dealing.get_table_state()), dealing.get_table_state().hash);
+}
+
+TEST(test_holdem_table_state_manager, add_dead_cards)
+{
+    poker_lib::holdem_table_state_manager state_manager({{1000, ""}, {1000, ""}}, 0, 10, 20);
+    state_manager.set_pocket_cards(0, "As Ks");
+    state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{});
+    state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{});
+    state_manager.set_flop("Ts 9d 3c");
+    state_manager.add_dead_cards("8h 2d");
+
+    const auto before = state_manager.get_table_state();
+    for (const auto &cards : {"", "  ", "Xx", "8h2d", "Ah Ah", "Ts", "As", "2d", "7c 8h"})
+    {
+        EXPECT_THROW(state_manager.add_dead_cards(cards), std::invalid_argument) << cards;
+    }
+    EXPECT_EQ(before, state_manager.get_table_state());
+    EXPECT_EQ(before.hash, state_manager.get_table_state().hash);
+
+    state_manager.add_dead_cards("7c kD");
+    EXPECT_EQ("8h 2d 7c kD", state_manager.get_table_state().dead_cards);
+}
+
+TEST(test_holdem_table_state_manager, incremental_hash)
+{
+    poker_lib::holdem_table_state_manager state_manager({{1000, ""}, {1000, ""}, {500, ""}}, 0, 10, 20);
+    const auto& table = state_manager.get_table_state();
+    auto expect_hash_is_up_to_date = [&table](){ EXPECT_EQ(poker_lib::calculate_table_hash(table), table.hash); };
+
+    std::unordered_set<poker_lib::table_state, poker_lib::table_state_hasher, poker_lib::table_state_equal_to> seen;
+    seen.insert(table);
+    expect_hash_is_up_to_date();
+
+    state_manager.set_pocket_cards(0, "As Ks");
+    expect_hash_is_up_to_date();
+    seen.insert(table);
+
+    state_manager.push_action(poker_lib::player_action_raise{100});
+    expect_hash_is_up_to_date();
+    EXPECT_TRUE(seen.insert(table).second);
+
+    state_manager.pop_action();
+    expect_hash_is_up_to_date();
+    EXPECT_FALSE(seen.insert(table).second);
+
+    state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{});
+    expect_hash_is_up_to_date();
+    state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{});
+    expect_hash_is_up_to_date();
+    state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{});
+    expect_hash_is_up_to_date();
+    EXPECT_TRUE(seen.insert(table).second);
+
+    state_manager.add_dead_cards("8h");
+    expect_hash_is_up_to_date();
+    EXPECT_TRUE(seen.insert(table).second);
+
+    state_manager.set_flop("Ts 9d 3c");
+    expect_hash_is_up_to_date();
+    state_manager.add_dead_cards("Qd 4s");
+    EXPECT_EQ("8h Qd 4s", table.dead_cards);
+    expect_hash_is_up_to_date();
+    state_manager.set_acting_player_action(poker_lib::player_action_raise{480});
+    expect_hash_is_up_to_date();
+    state_manager.set_acting_player_action(poker_lib::player_action_check_or_call{});
+    expect_hash_is_up_to_date();
+    state_manager.set_acting_player_action(poker_lib::player_action_fold{});
+    expect_hash_is_up_to_date();
+    state_manager.set_turn("2h");
+    expect_hash_is_up_to_date();
+    state_manager.set_river("2d");
+    expect_hash_is_up_to_date();
+    EXPECT_TRUE(seen.insert(table).second);
+
+    state_manager.execute_showdown({1});
+    expect_hash_is_up_to_date();
+    state_manager.start_new_round();
+    expect_hash_is_up_to_date();
+    EXPECT_TRUE(table.dead_cards.empty());
+    EXPECT_TRUE(seen.insert(table).second);
+}
+
+TEST(test_holdem_table_state_manager, blind_schedule_with_antes)
+{
+    EXPECT_ANY_THROW(poker_lib::holdem_table_state_manager({{100, ""}, {100, ""}}, 0, poker_lib::blind_schedule{}));
+
+    poker_lib::blind_schedule schedule{{{10, 20, 0}, {20, 40, 5}}, 1};
+    poker_lib::holdem_table_state_manager state_manager({{100, "a"}, {50, "b"}, {100, "c"}}, 0, schedule);
+    EXPECT_EQ(0, state_manager.get_blind_level_index());
+
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, "As Ks"));
+    EXPECT_NO_THROW(state_manager.set_acting_player_action(poker_lib::player_action_fold{}));
+    EXPECT_NO_THROW(state_manager.set_acting_player_action(poker_lib::player_action_fold{}));
+    EXPECT_NO_THROW(state_manager.execute_showdown({2}));
+    EXPECT_TRUE(state_manager.start_new_round());
+    EXPECT_EQ(1, state_manager.get_blind_level_index());
+
+    // Everyone posts the ante, then c and a post the blinds
+    poker_lib::table_state expected{};
+    expected.current_stage = poker_lib::game_stages::deal_pocket_cards;
+    expected.small_blind_size = 20;
+    expected.big_blind_size = 40;
+    expected.ante_size = 5;
+    expected.pot = 75;
+    expected.total_contribution_to_stay_in_game = 45;
+    expected.acting_player_pos = 1;
+    expected.dealer_pos = 1;
+
+    add_player(expected, 55, 45);
+    add_player(expected, 35, 5);
+    add_player(expected, 85, 25);
+
+    const auto& table = state_manager.get_table_state();
+    EXPECT_EQ(expected, table);
+    EXPECT_EQ(poker_lib::calculate_table_hash(table), table.hash);
+    EXPECT_EQ(40, table.get_acting_player_amount_to_call());
+
+    // The last level stays
+    EXPECT_NO_THROW(state_manager.set_pocket_cards(0, "As Ks"));
+    EXPECT_NO_THROW(state_manager.set_acting_player_action(poker_lib::player_action_fold{}));
+    EXPECT_NO_THROW(state_manager.set_acting_player_action(poker_lib::player_action_fold{}));
+    EXPECT_NO_THROW(state_manager.execute_showdown({0}));
+    EXPECT_TRUE(state_manager.start_new_round());
+    EXPECT_EQ(1, state_manager.get_blind_level_index());
+}
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include "table/table_checkpoint.h"
+
+TEST(test_table_checkpoint, write_and_load)
+{
+    const auto path = (std::filesystem::temp_directory_path() / "test_table_checkpoint.bin").string();
+    std::remove(path.c_str());
+    EXPECT_ANY_THROW(poker_lib::load_table_checkpoint(path));
+
+    poker_lib::table_event_journal journal;
+    journal.append(poker_lib::pocket_cards_dealt_event{1, "As Ks"});
+    {
+        poker_lib::table_checkpoint_writer writer(path);
+        writer.write(journal);
+        writer.flush();
+        EXPECT_EQ(journal.size(), poker_lib::load_table_checkpoint(path)->size());
+
+        // Only the last checkpoint matters, the ones replaced before being saved are skipped
+        for (size_t action = 0; action < 100; ++action)
+        {
+            journal.append(poker_lib::action_taken_event{0, poker_lib::game_stages::flop_betting_round, poker_lib::player_action_raise{action}});
+            writer.write(journal);
+        }
+    }
+    const auto loaded = poker_lib::load_table_checkpoint(path);
+    ASSERT_EQ(journal.size(), loaded->size());
+    EXPECT_TRUE(std::equal(journal.data(), journal.data() + journal.size(), loaded->data()));
+
+    {
+        poker_lib::table_checkpoint_writer writer(path);
+        writer.remove();
+        writer.flush();
+        EXPECT_FALSE(std::ifstream(path).good());
+    }
+
+    {
+        // Saving fails in a missing directory, the error comes out of a later write
+        poker_lib::table_checkpoint_writer writer((std::filesystem::temp_directory_path() / "missing_directory" / "checkpoint.bin").string());
+        const auto write_until_failed = [&]()
+        {
+            while (true)
+            {
+                writer.write(journal);
+                std::this_thread::yield();
+            }
+        };
+        EXPECT_THROW(write_until_failed(), std::runtime_error);
+        EXPECT_THROW(writer.flush(), std::runtime_error);
+    }
+
+    std::ofstream(path) << "not a checkpoint";
+    EXPECT_THROW(poker_lib::load_table_checkpoint(path), std::invalid_argument);
+    std::remove(path.c_str());
+}
+
+TEST(test_table_checkpoint, resume_game)
+{
+    const auto path = (std::filesystem::temp_directory_path() / "test_table_checkpoint_game.bin").string();
+    const poker_lib::blind_schedule schedule{{{10, 20, 0}}};
+
+    poker_lib::holdem_table_state_manager state_manager({{100, "alice"}, {100, "bob"}, {100, "carol"}}, 0, schedule);
+    {
+        poker_lib::checkpointed_table_state_manager checkpointed(state_manager, path);
+        checkpointed.set_pocket_cards(0, "As Ks");
+        checkpointed.set_acting_player_action(poker_lib::player_action_fold{});
+        checkpointed.set_acting_player_action(poker_lib::player_action_fold{});
+        checkpointed.execute_showdown({2});
+        ASSERT_TRUE(checkpointed.start_new_round());
+        checkpointed.set_pocket_cards(0, "Qs Js");
+        checkpointed.set_acting_player_action(poker_lib::player_action_raise{40});
+        checkpointed.get_writer().flush();
+
+        // A new round starts a new journal so a checkpoint only holds the current round
+        const auto round_journal = poker_lib::load_table_checkpoint(path);
+        EXPECT_EQ(0, round_journal->find_round_start(round_journal->size()));
+    }
+
+    const auto journal = poker_lib::load_table_checkpoint(path);
+    poker_lib::holdem_table_state_manager resumed(*journal, journal->size(), schedule);
+    EXPECT_EQ(state_manager.get_table_state(), resumed.get_table_state());
+
+    {
+        poker_lib::checkpointed_table_state_manager checkpointed(resumed, path, journal);
+        checkpointed.set_acting_player_action(poker_lib::player_action_fold{});
+        checkpointed.set_acting_player_action(poker_lib::player_action_fold{});
+        checkpointed.execute_showdown({1});
+        checkpointed.get_writer().flush();
+
+        const auto resumed_journal = poker_lib::load_table_checkpoint(path);
+        EXPECT_EQ(resumed.get_table_state(), poker_lib::holdem_table_state_manager(*resumed_journal, resumed_journal->size(), schedule).get_table_state());
+    }
+
+    // The checkpoint is deleted once the game has ended
+    poker_lib::holdem_table_state_manager heads_up({{20, "alice"}, {100, "bob"}}, 0, schedule);
+    {
+        poker_lib::checkpointed_table_state_manager checkpointed(heads_up, path);
+        checkpointed.set_pocket_cards(0, "As Ks");
+        checkpointed.set_acting_player_action(poker_lib::player_action_check_or_call{});
+        checkpointed.set_acting_player_action(poker_lib::player_action_check_or_call{});
+        checkpointed.set_flop("2c 3c 4c");
+        checkpointed.set_turn("5d");
+        checkpointed.set_river("7d");
+        checkpointed.execute_showdown({1});
+        EXPECT_FALSE(checkpointed.start_new_round());
+        checkpointed.get_writer().flush();
+    }
+    EXPECT_FALSE(std::ifstream(path).good());
+}
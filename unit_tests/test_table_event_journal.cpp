@@ -0,0 +1,166 @@
+#include <chrono>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "table/holdem_table_state_manager.h"
+#include "table/table_event_journal.h"
+
+TEST(test_table_event_journal, read_appended_events)
+{
+    poker_lib::table_event_journal journal;
+
+    poker_lib::round_started_event round;
+    round.dealer_pos = 1;
+    round.blind_level_index = 2;
+    round.num_of_rounds_played = 300;
+    round.elapsed_milliseconds = 5400000;
+    round.small_blind_size = 50;
+    round.big_blind_size = 100;
+    round.ante_size = 10;
+    round.num_of_players = 2;
+    round.stacks = {{1000, 123456789}};
+    round.player_names = {{"alice", "bob"}};
+    EXPECT_EQ(0, journal.append(round));
+
+    const auto action_offset = journal.append(poker_lib::action_taken_event{1, poker_lib::game_stages::turn_betting_round, poker_lib::player_action_fold{}});
+    const auto raise_offset = journal.append(poker_lib::action_taken_event{0, poker_lib::game_stages::flop_betting_round, poker_lib::player_action_raise{1000}});
+    journal.append(poker_lib::communal_cards_dealt_event{poker_lib::game_stages::deal_turn_card, "Ah"});
+    journal.append(poker_lib::showdown_event{poker_lib::get_seat_bit(0) | poker_lib::get_seat_bit(9)});
+    EXPECT_EQ(5, raise_offset - action_offset);
+
+    size_t offset = 0;
+    const auto read_round = std::get<poker_lib::round_started_event>(journal.read(offset));
+    EXPECT_EQ(action_offset, offset);
+    EXPECT_EQ(round.dealer_pos, read_round.dealer_pos);
+    EXPECT_EQ(round.blind_level_index, read_round.blind_level_index);
+    EXPECT_EQ(round.num_of_rounds_played, read_round.num_of_rounds_played);
+    EXPECT_EQ(round.elapsed_milliseconds, read_round.elapsed_milliseconds);
+    EXPECT_EQ(round.ante_size, read_round.ante_size);
+    EXPECT_EQ(round.num_of_players, read_round.num_of_players);
+    EXPECT_EQ(round.stacks, read_round.stacks);
+    EXPECT_EQ(round.player_names, read_round.player_names);
+
+    const auto fold = std::get<poker_lib::action_taken_event>(journal.read(offset));
+    EXPECT_EQ(1, fold.player_pos);
+    EXPECT_EQ(poker_lib::game_stages::turn_betting_round, fold.stage);
+    EXPECT_TRUE(std::holds_alternative<poker_lib::player_action_fold>(fold.action));
+    const auto raise = std::get<poker_lib::action_taken_event>(journal.read(offset));
+    EXPECT_EQ(poker_lib::player_action_t{poker_lib::player_action_raise{1000}}, raise.action);
+    const auto turn = std::get<poker_lib::communal_cards_dealt_event>(journal.read(offset));
+    EXPECT_EQ(poker_lib::game_stages::deal_turn_card, turn.stage);
+    EXPECT_EQ("Ah", turn.cards);
+    // Events point into the journal instead of copying
+    EXPECT_TRUE(turn.cards.data() > reinterpret_cast<const char*>(journal.data()));
+    EXPECT_TRUE(turn.cards.data() < reinterpret_cast<const char*>(journal.data() + journal.size()));
+    EXPECT_EQ(poker_lib::get_seat_bit(0) | poker_lib::get_seat_bit(9), std::get<poker_lib::showdown_event>(journal.read(offset)).winner_mask);
+    EXPECT_EQ(journal.size(), offset);
+    EXPECT_ANY_THROW(journal.read(offset));
+
+    EXPECT_EQ(0, journal.find_round_start(journal.size()));
+    EXPECT_ANY_THROW(journal.find_round_start(0));
+
+    std::vector<uint8_t> data(journal.data(), journal.data() + journal.size());
+    EXPECT_NO_THROW(poker_lib::table_event_journal{data});
+    data.pop_back();
+    EXPECT_ANY_THROW(poker_lib::table_event_journal{data});
+    data.assign(1, 0xff);
+    EXPECT_ANY_THROW(poker_lib::table_event_journal{data});
+}
+
+TEST(test_table_event_journal, rebuild_table_from_any_offset)
+{
+    const poker_lib::blind_schedule schedule{{{5, 10, 0}, {10, 20, 5}}, 2};
+    poker_lib::holdem_table_state_manager state_manager({{200, "alice"}, {300, "bob"}, {150, "carol"}}, 0, schedule);
+    auto journal = std::make_shared<poker_lib::table_event_journal>();
+    state_manager.set_journal(journal);
+
+    // Plays rounds with every kind of event and remembers the table after each of them
+    std::vector<std::pair<size_t, poker_lib::table_state>> tables{{journal->size(), state_manager.get_table_state()}};
+    size_t num_of_actions = 0;
+    for (size_t num_of_rounds = 0; num_of_rounds < 4;)
+    {
+        const auto &table = state_manager.get_table_state();
+        switch (table.current_stage)
+        {
+        case poker_lib::game_stages::deal_pocket_cards:
+            state_manager.add_dead_cards("2c");
+            state_manager.set_pocket_cards(0, "As Ks");
+            break;
+        case poker_lib::game_stages::deal_communal_cards: state_manager.set_flop("2d 3d 4d"); break;
+        case poker_lib::game_stages::deal_turn_card: state_manager.set_turn("9s"); break;
+        case poker_lib::game_stages::deal_river_card: state_manager.set_river("Tc"); break;
+        case poker_lib::game_stages::showdown:
+            for (size_t pos = 0; pos < table.get_num_of_players(); ++pos)
+            {
+                if (!table.has_folded(pos))
+                {
+                    state_manager.execute_showdown({pos});
+                    break;
+                }
+            }
+            break;
+        case poker_lib::game_stages::end_of_round:
+            ASSERT_TRUE(state_manager.start_new_round());
+            ++num_of_rounds;
+            break;
+        default:
+        {
+            const poker_lib::player_action_t actions[] = {poker_lib::player_action_check_or_call{},
+                                                          poker_lib::player_action_raise{15},
+                                                          poker_lib::player_action_check_or_call{},
+                                                          poker_lib::player_action_fold{}};
+            state_manager.set_acting_player_action(actions[num_of_actions++ % 4]);
+            break;
+        }
+        }
+        tables.emplace_back(journal->size(), state_manager.get_table_state());
+    }
+    EXPECT_EQ(1, state_manager.get_blind_level_index());
+
+    for (const auto &[offset, table] : tables)
+    {
+        const poker_lib::holdem_table_state_manager rebuilt(*journal, offset, schedule);
+        EXPECT_EQ(table, rebuilt.get_table_state());
+        EXPECT_EQ(table.hash, rebuilt.get_table_state().hash);
+    }
+    EXPECT_ANY_THROW(poker_lib::holdem_table_state_manager(*journal, journal->size() - 1, schedule));
+
+    // A table rebuilt after a crash continues the journal
+    poker_lib::holdem_table_state_manager recovered(*journal, journal->size(), schedule);
+    EXPECT_EQ(state_manager.get_blind_level_index(), recovered.get_blind_level_index());
+    recovered.set_journal(journal);
+    recovered.set_pocket_cards(0, "Ah Kh");
+    EXPECT_EQ(recovered.get_table_state(), poker_lib::holdem_table_state_manager(*journal, journal->size(), schedule).get_table_state());
+    // Only set up rounds can start a journal
+    EXPECT_ANY_THROW(recovered.set_journal(std::make_shared<poker_lib::table_event_journal>()));
+}
+
+TEST(test_table_event_journal, rebuilt_table_keeps_game_time)
+{
+    const poker_lib::blind_schedule schedule{{{5, 10, 0}, {10, 20, 0}, {20, 40, 0}}, 0, std::chrono::hours(1)};
+
+    // The game had been running for two and a half hours when the round started
+    poker_lib::table_event_journal journal;
+    poker_lib::round_started_event round;
+    round.blind_level_index = 2;
+    round.num_of_rounds_played = 10;
+    round.elapsed_milliseconds = 9000000;
+    round.small_blind_size = 20;
+    round.big_blind_size = 40;
+    round.num_of_players = 2;
+    round.stacks = {{1000, 1000}};
+    round.player_names = {{"alice", "bob"}};
+    journal.append(round);
+    journal.append(poker_lib::blinds_posted_event{0, 1, 20, 40, 0});
+
+    poker_lib::holdem_table_state_manager rebuilt(journal, journal.size(), schedule);
+    rebuilt.set_pocket_cards(0, "As Ks");
+    rebuilt.set_acting_player_action(poker_lib::player_action_fold{});
+    rebuilt.execute_showdown({1});
+    ASSERT_TRUE(rebuilt.start_new_round());
+    // Levels by time don't start over from the first one
+    EXPECT_EQ(2, rebuilt.get_blind_level_index());
+    EXPECT_EQ(40, rebuilt.get_table_state().big_blind_size);
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "equity_engine.h"
+#include "thread_placement.h"
+
+TEST(test_thread_placement, parse_cpu_list)
+{
+    EXPECT_EQ((std::vector<size_t>{0, 1, 2, 3, 8, 10, 11}), poker_lib::parse_cpu_list("0-3,8,10-11"));
+    EXPECT_EQ((std::vector<size_t>{1, 2}), poker_lib::parse_cpu_list(" 2, 1,2\n"));
+    EXPECT_TRUE(poker_lib::parse_cpu_list("").empty());
+    EXPECT_THROW(poker_lib::parse_cpu_list("3-1"), std::invalid_argument);
+    EXPECT_THROW(poker_lib::parse_cpu_list("a"), std::invalid_argument);
+    EXPECT_THROW(poker_lib::parse_cpu_list("1-"), std::invalid_argument);
+}
+
+TEST(test_thread_placement, numa_nodes_and_affinity)
+{
+    const auto nodes = poker_lib::get_numa_node_cpus();
+    ASSERT_FALSE(nodes.empty());
+    ASSERT_FALSE(nodes.front().empty());
+
+    EXPECT_FALSE(poker_lib::set_current_thread_affinity({}));
+#ifdef __linux__
+    std::thread([&nodes](){ EXPECT_TRUE(poker_lib::set_current_thread_affinity({nodes.front().front()})); }).join();
+#endif
+    {
+        const poker_lib::scoped_thread_affinity affinity(nodes.front());
+        const poker_lib::scoped_thread_affinity nothing({});
+    }
+}
+
+TEST(test_thread_placement, pinned_workers_give_the_same_equities)
+{
+    poker_lib::table_state table;
+    table.current_stage = poker_lib::game_stages::flop_betting_round;
+    table.add_player(1000, "hero");
+    table.players.back().pocket_cards = "Qs Qd";
+    table.add_player(1000, "villain");
+    table.add_player(1000, "third");
+    table.communal_cards = "Ks 9d 4c";
+
+    poker_lib::equity_engine_config config;
+    config.num_of_samples = 20000;
+    config.samples_per_stream = 1024;
+    config.num_of_threads = 4;
+    const poker_lib::batch_hand_evaluator evaluator;
+    const auto result = poker_lib::calculate_seeded_equities(table, config, evaluator);
+
+    config.worker_cpus = poker_lib::get_numa_node_cpus().front();
+    const poker_lib::batch_hand_evaluator local_evaluator(poker_lib::batch_hand_evaluator::get_best_isa(), poker_lib::hand_evaluator_tables::local);
+    EXPECT_EQ(result.equities, poker_lib::calculate_seeded_equities(table, config, local_evaluator).equities);
+}
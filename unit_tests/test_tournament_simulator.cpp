@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <numeric>
+#include "tournament_simulator.h"
+
+TEST(test_tournament_simulator, placement_probabilities)
+{
+    poker_lib::tournament_simulation_config config;
+    config.stacks = {2000, 1000, 300};
+    config.num_of_tournaments = 300;
+    config.num_of_threads = 2;
+
+    const auto result = poker_lib::simulate_tournaments(config);
+
+    EXPECT_EQ(config.num_of_tournaments, result.num_of_tournaments);
+    EXPECT_GE(result.num_of_rounds, result.num_of_tournaments);
+    ASSERT_EQ(config.stacks.size(), result.placement_probabilities.size());
+    for (size_t index = 0; index < config.stacks.size(); ++index)
+    {
+        const auto &player = result.placement_probabilities[index];
+        EXPECT_NEAR(1, std::accumulate(player.begin(), player.end(), 0.0), 1e-9);
+
+        double place_sum = 0;
+        for (const auto &probabilities : result.placement_probabilities)
+        {
+            place_sum += probabilities[index];
+        }
+        EXPECT_NEAR(1, place_sum, 1e-9);
+    }
+    EXPECT_GT(result.placement_probabilities[0][0], result.placement_probabilities[2][0]);
+}
+
+TEST(test_tournament_simulator, deterministic_regardless_of_threads)
+{
+    poker_lib::tournament_simulation_config config;
+    config.stacks = {500, 500, 500, 500};
+    config.num_of_tournaments = 50;
+    config.num_of_threads = 1;
+
+    const auto single_threaded = poker_lib::simulate_tournaments(config);
+    config.num_of_threads = 3;
+    const auto multi_threaded = poker_lib::simulate_tournaments(config);
+
+    EXPECT_EQ(single_threaded.placement_probabilities, multi_threaded.placement_probabilities);
+    EXPECT_EQ(single_threaded.num_of_rounds, multi_threaded.num_of_rounds);
+
+    config.seed = 2;
+    EXPECT_NE(single_threaded.placement_probabilities, poker_lib::simulate_tournaments(config).placement_probabilities);
+}
+
+TEST(test_tournament_simulator, steep_blind_schedule)
+{
+    // Blinds double every round so they soon outgrow every stack and short stacks have to post all-in
+    poker_lib::tournament_simulation_config config;
+    config.stacks = {2000, 1000, 500, 500};
+    config.blinds.levels.clear();
+    for (uint64_t level = 0; level < 20; ++level)
+    {
+        config.blinds.levels.push_back({uint64_t{10} << level, uint64_t{20} << level, 0});
+    }
+    config.blinds.rounds_per_level = 1;
+    config.num_of_tournaments = 200;
+    config.num_of_threads = 1;
+
+    const auto result = poker_lib::simulate_tournaments(config);
+
+    EXPECT_EQ(config.num_of_tournaments, result.num_of_tournaments);
+    for (const auto &player : result.placement_probabilities)
+    {
+        EXPECT_NEAR(1, std::accumulate(player.begin(), player.end(), 0.0), 1e-9);
+    }
+}
+
+TEST(test_tournament_simulator, invalid_config)
+{
+    poker_lib::tournament_simulation_config config;
+    config.stacks = {1000};
+    EXPECT_ANY_THROW(poker_lib::simulate_tournaments(config));
+
+    config.stacks = {1000, 1000};
+    config.policy = nullptr;
+    EXPECT_ANY_THROW(poker_lib::simulate_tournaments(config));
+}